@@ -20,15 +20,33 @@ namespace {
 const string DOCUMENT_VERSION_STRING = std::to_string(MATERIALX_MAJOR_VERSION) + "." +
                                        std::to_string(MATERIALX_MINOR_VERSION);
 
-template<class T> shared_ptr<T> updateChildSubclass(ElementPtr parent, ElementPtr origChild)
+// Beyond this number of queued edits, a full rebuild of the document cache
+// is less expensive than incremental re-indexing.
+const size_t MAX_PENDING_UPDATES = 1024;
+
+// Return true if the given element is a Collection, a Look, or a descendant
+// of a Look, whose edits may change the geometry bindings of a document.
+bool isGeomBindingElement(ConstElementPtr elem)
 {
-    string childName = origChild->getName();
-    int childIndex = parent->getChildIndex(childName);
-    parent->removeChild(childName);
-    shared_ptr<T> newChild = parent->addChild<T>(childName);
-    parent->setChildIndex(childName, childIndex);
-    newChild->copyContentFrom(origChild);
-    return newChild;
+    return elem->isA<Collection>() || elem->getAncestorOfType<Look>() != nullptr;
+}
+
+// Return true if the given document is reachable from the given library
+// through its chain of referenced libraries.
+bool referencesDocument(const ConstDocumentPtr& library, const Document* doc)
+{
+    if (library.get() == doc)
+    {
+        return true;
+    }
+    for (const ConstDocumentPtr& nested : library->getReferencedLibraries())
+    {
+        if (referencesDocument(nested, doc))
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 } // anonymous namespace
@@ -50,73 +68,260 @@ class Document::Cache
 {
   public:
     Cache() :
-        valid(false)
+        valid(false),
+        batchEdit(false)
     {
     }
     ~Cache() { }
 
+    // Return the geometry binding index of the document, building it if it
+    // has been invalidated by edits to the document.
+    ConstGeomBindingIndexPtr getGeomBindingIndex()
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (!geomBindingIndex || batchEdit)
+        {
+            geomBindingIndex = GeomBindingIndex::create(doc.lock());
+        }
+        return geomBindingIndex;
+    }
+
+    // Discard the geometry binding index, so that it is rebuilt on the next
+    // request.
+    void clearGeomBindingIndex()
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        geomBindingIndex = nullptr;
+    }
+
+    // Mark the cache as requiring a full rebuild on the next refresh.
+    void invalidate()
+    {
+        valid = false;
+        pendingUpdates.clear();
+    }
+
+    // Queue an element for incremental re-indexing on the next refresh.  If
+    // updateDescendants is true, then all descendants of the element are
+    // re-indexed as well.
+    void queueUpdate(ElementPtr elem, bool updateDescendants)
+    {
+        if (!valid)
+        {
+            return;
+        }
+        if (pendingUpdates.size() >= MAX_PENDING_UPDATES)
+        {
+            invalidate();
+            return;
+        }
+        pendingUpdates.emplace_back(elem, updateDescendants);
+    }
+
+    // Queue the given element for re-indexing if the given attribute
+    // affects its cache keys.
+    void queueAttributeUpdate(ElementPtr elem, const string& attrib)
+    {
+        if (attrib == NAMESPACE_ATTRIBUTE)
+        {
+            queueUpdate(elem, true);
+        }
+        else if (attrib == PortElement::NODE_NAME_ATTRIBUTE ||
+                 attrib == NodeDef::NODE_ATTRIBUTE ||
+                 attrib == InterfaceElement::NODE_DEF_ATTRIBUTE)
+        {
+            queueUpdate(elem, false);
+        }
+    }
+
+    // Remove the given element and all of its descendants from the cache.
+    void removeTree(ElementPtr elem)
+    {
+        if (!valid)
+        {
+            return;
+        }
+        for (ElementPtr descendant : elem->traverseTree())
+        {
+            removeEntries(descendant);
+        }
+    }
+
     void refresh()
     {
         // Thread synchronization for multiple concurrent readers of a single document.
         std::lock_guard<std::mutex> guard(mutex);
 
-        if (!valid)
+        // Edits within a batch send no notifications, so the cache is rebuilt
+        // on each refresh until the batch ends.
+        if (!valid || batchEdit)
         {
             // Clear the existing cache.
             portElementMap.clear();
             nodeDefMap.clear();
             implementationMap.clear();
+            elementKeyMap.clear();
+            pendingUpdates.clear();
 
             // Traverse the document to build a new cache.
             for (ElementPtr elem : doc.lock()->traverseTree())
             {
-                const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
-                const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
-                const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+                addEntries(elem);
+            }
 
-                if (!nodeName.empty())
+            valid = true;
+        }
+        else if (!pendingUpdates.empty())
+        {
+            // Re-index only those elements that have been edited since the
+            // last refresh.
+            DocumentPtr document = doc.lock();
+            for (const PendingUpdate& update : pendingUpdates)
+            {
+                ElementPtr elem = update.first.lock();
+                if (!elem)
                 {
-                    PortElementPtr portElem = elem->asA<PortElement>();
-                    if (portElem)
-                    {
-                        portElementMap.insert(std::pair<string, PortElementPtr>(
-                            portElem->getQualifiedName(nodeName),
-                            portElem));
-                    }
+                    continue;
                 }
-                if (!nodeString.empty())
+                bool inDocument = isInDocument(elem, document);
+                if (update.second)
                 {
-                    NodeDefPtr nodeDef = elem->asA<NodeDef>();
-                    if (nodeDef)
+                    for (ElementPtr descendant : elem->traverseTree())
                     {
-                        nodeDefMap.insert(std::pair<string, NodeDefPtr>(
-                            nodeDef->getQualifiedName(nodeString),
-                            nodeDef));
+                        removeEntries(descendant);
+                        if (inDocument)
+                        {
+                            addEntries(descendant);
+                        }
                     }
                 }
-                if (!nodeDefString.empty())
+                else
                 {
-                    InterfaceElementPtr interface = elem->asA<InterfaceElement>();
-                    if (interface && (interface->isA<Implementation>() || interface->isA<NodeGraph>()))
+                    removeEntries(elem);
+                    if (inDocument)
                     {
-                        implementationMap.insert(std::pair<string, InterfaceElementPtr>(
-                            interface->getQualifiedName(nodeDefString),
-                            interface));
+                        addEntries(elem);
                     }
                 }
             }
+            pendingUpdates.clear();
+        }
+    }
 
-            valid = true;
+  private:
+    // The cache keys under which a single element has been stored.
+    struct ElementKeys
+    {
+        string port;
+        string nodeDef;
+        string implementation;
+    };
+
+    using PendingUpdate = std::pair<weak_ptr<Element>, bool>;
+
+    void addEntries(ElementPtr elem)
+    {
+        const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
+        const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+        if (nodeName.empty() && nodeString.empty() && nodeDefString.empty())
+        {
+            return;
+        }
+
+        ElementKeys keys;
+        if (!nodeName.empty())
+        {
+            PortElementPtr portElem = elem->asA<PortElement>();
+            if (portElem)
+            {
+                keys.port = portElem->getQualifiedName(nodeName);
+                portElementMap.insert(std::pair<string, PortElementPtr>(keys.port, portElem));
+            }
+        }
+        if (!nodeString.empty())
+        {
+            NodeDefPtr nodeDef = elem->asA<NodeDef>();
+            if (nodeDef)
+            {
+                keys.nodeDef = nodeDef->getQualifiedName(nodeString);
+                nodeDefMap.insert(std::pair<string, NodeDefPtr>(keys.nodeDef, nodeDef));
+            }
+        }
+        if (!nodeDefString.empty())
+        {
+            InterfaceElementPtr interface = elem->asA<InterfaceElement>();
+            if (interface && (interface->isA<Implementation>() || interface->isA<NodeGraph>()))
+            {
+                keys.implementation = interface->getQualifiedName(nodeDefString);
+                implementationMap.insert(std::pair<string, InterfaceElementPtr>(keys.implementation, interface));
+            }
+        }
+        if (!keys.port.empty() || !keys.nodeDef.empty() || !keys.implementation.empty())
+        {
+            elementKeyMap[elem.get()] = keys;
+        }
+    }
+
+    void removeEntries(ElementPtr elem)
+    {
+        auto it = elementKeyMap.find(elem.get());
+        if (it == elementKeyMap.end())
+        {
+            return;
+        }
+        eraseEntry(portElementMap, it->second.port, elem);
+        eraseEntry(nodeDefMap, it->second.nodeDef, elem);
+        eraseEntry(implementationMap, it->second.implementation, elem);
+        elementKeyMap.erase(it);
+    }
+
+    template<class T> static void eraseEntry(std::unordered_multimap<string, T>& map, const string& key, ElementPtr elem)
+    {
+        if (key.empty())
+        {
+            return;
+        }
+        auto keyRange = map.equal_range(key);
+        for (auto it = keyRange.first; it != keyRange.second; ++it)
+        {
+            if (it->second == elem)
+            {
+                map.erase(it);
+                return;
+            }
+        }
+    }
+
+    // Return true if the given element is currently reachable from the given
+    // document through its chain of parents.
+    static bool isInDocument(ElementPtr elem, DocumentPtr document)
+    {
+        while (elem != document)
+        {
+            ElementPtr parent = elem->getParent();
+            if (!parent || parent->getChild(elem->getName()) != elem)
+            {
+                return false;
+            }
+            elem = parent;
         }
+        return true;
     }
 
   public:
     weak_ptr<Document> doc;
     std::mutex mutex;
     bool valid;
+    bool batchEdit;
     std::unordered_multimap<string, PortElementPtr> portElementMap;
     std::unordered_multimap<string, NodeDefPtr> nodeDefMap;
     std::unordered_multimap<string, InterfaceElementPtr> implementationMap;
+    ConstGeomBindingIndexPtr geomBindingIndex;
+
+  private:
+    std::unordered_map<const Element*, ElementKeys> elementKeyMap;
+    vector<PendingUpdate> pendingUpdates;
 };
 
 //
@@ -141,11 +346,49 @@ void Document::initialize()
     _cache->doc = doc;
 
     clearContent();
+    clearReferencedLibraries();
     setVersionString(DOCUMENT_VERSION_STRING);
 }
 
+void Document::beginBatchEdit(ElementPtr elem)
+{
+    if (!_sharedState->batchDepth++)
+    {
+        _batchElement = elem ? elem : getSelf();
+        _sharedState->batchRemoval = false;
+        _cache->batchEdit = true;
+        return;
+    }
+
+    // Widen the scope of the outermost batch edit to the full document if
+    // a nested edit extends beyond it.
+    ElementPtr scope = elem;
+    while (scope && scope != _batchElement)
+    {
+        scope = scope->getParent();
+    }
+    if (!scope)
+    {
+        _batchElement = getSelf();
+    }
+}
+
+void Document::endBatchEdit()
+{
+    if (!_sharedState->batchDepth || --_sharedState->batchDepth)
+    {
+        return;
+    }
+
+    ElementPtr elem = _batchElement;
+    _batchElement = nullptr;
+    _cache->batchEdit = false;
+    onBatchEdit(elem);
+}
+
 void Document::importLibrary(const ConstDocumentPtr& library, const CopyOptions* copyOptions)
 {
+    ScopedBatchEdit batch(getDocument());
     bool skipConflictingElements = copyOptions && copyOptions->skipConflictingElements;
     for (const ConstElementPtr& child : library->getChildren())
     {
@@ -188,6 +431,59 @@ void Document::importLibrary(const ConstDocumentPtr& library, const CopyOptions*
             throw Exception("Duplicate element with conflicting content: " + childName);
         }
     }
+    batch.commit();
+}
+
+void Document::referenceLibrary(const ConstDocumentPtr& library)
+{
+    if (!library || library.get() == this)
+    {
+        throw Exception("Invalid library reference");
+    }
+    if (referencesDocument(library, this))
+    {
+        throw ExceptionFoundCycle("Encountered a cycle in library references");
+    }
+    if (std::find(_referencedLibraries.begin(), _referencedLibraries.end(), library) == _referencedLibraries.end())
+    {
+        _referencedLibraries.push_back(library);
+    }
+}
+
+ElementPtr Document::getReferencedLibraryElement(const string& name) const
+{
+    for (const ConstDocumentPtr& library : _referencedLibraries)
+    {
+        // Apply the namespace of the library, matching the names assigned
+        // to elements by importLibrary.
+        string localName = name;
+        if (library->hasNamespace())
+        {
+            const string prefix = library->getNamespace() + NAME_PREFIX_SEPARATOR;
+            if (name.compare(0, prefix.size(), prefix) != 0)
+            {
+                // Nested libraries may apply namespaces of their own.
+                ElementPtr nestedChild = library->getReferencedLibraryElement(name);
+                if (nestedChild)
+                {
+                    return nestedChild;
+                }
+                continue;
+            }
+            localName = name.substr(prefix.size());
+        }
+
+        ElementPtr child = library->getChild(localName);
+        if (!child)
+        {
+            child = library->getReferencedLibraryElement(name);
+        }
+        if (child)
+        {
+            return child;
+        }
+    }
+    return ElementPtr();
 }
 
 std::pair<int, int> Document::getVersionIntegers() const
@@ -219,9 +515,10 @@ vector<PortElementPtr> Document::getMatchingPorts(const string& nodeName) const
 ValuePtr Document::getGeomAttrValue(const string& geomAttrName, const string& geom) const
 {
     ValuePtr value;
+    vector<GeomPath> geomPaths = parseDocumentGeomString(geom);
     for (GeomInfoPtr geomInfo : getGeomInfos())
     {
-        if (!geomStringsMatch(geom, geomInfo->getActiveGeom()))
+        if (!geomPathsMatch(geomPaths, *geomInfo->getActiveGeomPaths()))
         {
             continue;
         }
@@ -247,10 +544,22 @@ vector<NodeDefPtr> Document::getMatchingNodeDefs(const string& nodeName) const
         nodeDefs.push_back(it->second);
     }
 
+    // Append matches from referenced libraries.
+    for (const ConstDocumentPtr& library : _referencedLibraries)
+    {
+        vector<NodeDefPtr> libraryNodeDefs = library->getMatchingNodeDefs(nodeName);
+        nodeDefs.insert(nodeDefs.end(), libraryNodeDefs.begin(), libraryNodeDefs.end());
+    }
+
     // Return the matches.
     return nodeDefs;
 }
 
+ConstGeomBindingIndexPtr Document::getGeomBindingIndex() const
+{
+    return _cache->getGeomBindingIndex();
+}
+
 vector<InterfaceElementPtr> Document::getMatchingImplementations(const string& nodeDef) const
 {
     // Refresh the cache.
@@ -264,6 +573,13 @@ vector<InterfaceElementPtr> Document::getMatchingImplementations(const string& n
         implementations.push_back(it->second);
     }
 
+    // Append matches from referenced libraries.
+    for (const ConstDocumentPtr& library : _referencedLibraries)
+    {
+        vector<InterfaceElementPtr> libraryImplementations = library->getMatchingImplementations(nodeDef);
+        implementations.insert(implementations.end(), libraryImplementations.begin(), libraryImplementations.end());
+    }
+
     // Return the matches.
     return implementations;
 }
@@ -318,7 +634,7 @@ void Document::upgradeVersion()
             {
                 if (child->getCategory() == "assign")
                 {
-                    updateChildSubclass<MaterialAssign>(elem, child);
+                    elem->changeChildSubclass<MaterialAssign>(child);
                 }
             }
         }
@@ -367,11 +683,11 @@ void Document::upgradeVersion()
             {
                 if (child->getCategory() == "opgraph")
                 {
-                    updateChildSubclass<NodeGraph>(elem, child);
+                    elem->changeChildSubclass<NodeGraph>(child);
                 }
                 else if (child->getCategory() == "shader")
                 {
-                    NodeDefPtr nodeDef = updateChildSubclass<NodeDef>(elem, child);
+                    NodeDefPtr nodeDef = elem->changeChildSubclass<NodeDef>(child);
                     if (nodeDef->hasAttribute("shadertype"))
                     {
                         nodeDef->setType(SURFACE_SHADER_TYPE_STRING);
@@ -390,7 +706,7 @@ void Document::upgradeVersion()
                     {
                         if (elem->isA<Node>())
                         {
-                            InputPtr input = updateChildSubclass<Input>(elem, param);
+                            InputPtr input = elem->changeChildSubclass<Input>(param);
                             input->setNodeName(input->getAttribute("value"));
                             input->removeAttribute("value");
                             if (input->getConnectedNode())
@@ -595,34 +911,77 @@ void Document::upgradeVersion()
     }
 }
 
-void Document::onAddElement(ElementPtr, ElementPtr)
+void Document::onAddElement(ElementPtr parent, ElementPtr elem)
 {
-    _cache->valid = false;
+    _cache->queueUpdate(elem, true);
+    if (isGeomBindingElement(parent) || isGeomBindingElement(elem))
+    {
+        _cache->clearGeomBindingIndex();
+    }
 }
 
-void Document::onRemoveElement(ElementPtr, ElementPtr)
+void Document::onRemoveElement(ElementPtr parent, ElementPtr elem)
 {
-    _cache->valid = false;
+    _cache->removeTree(elem);
+    if (isGeomBindingElement(parent) || isGeomBindingElement(elem))
+    {
+        _cache->clearGeomBindingIndex();
+    }
 }
 
-void Document::onSetAttribute(ElementPtr, const string&, const string&)
+void Document::onSetAttribute(ElementPtr elem, const string& attrib, const string&)
 {
-    _cache->valid = false;
+    _cache->queueAttributeUpdate(elem, attrib);
+    if (isGeomBindingElement(elem) || attrib == GEOM_PREFIX_ATTRIBUTE || attrib == NAMESPACE_ATTRIBUTE)
+    {
+        _cache->clearGeomBindingIndex();
+    }
+}
+
+void Document::onRemoveAttribute(ElementPtr elem, const string& attrib)
+{
+    _cache->queueAttributeUpdate(elem, attrib);
+    if (isGeomBindingElement(elem) || attrib == GEOM_PREFIX_ATTRIBUTE || attrib == NAMESPACE_ATTRIBUTE)
+    {
+        _cache->clearGeomBindingIndex();
+    }
 }
 
-void Document::onRemoveAttribute(ElementPtr, const string&)
+void Document::onCopyContent(ElementPtr elem)
 {
-    _cache->valid = false;
+    _cache->queueUpdate(elem, true);
+    if (elem == getSelf() || isGeomBindingElement(elem))
+    {
+        _cache->clearGeomBindingIndex();
+    }
 }
 
-void Document::onCopyContent(ElementPtr)
+void Document::onClearContent(ElementPtr elem)
 {
-    _cache->valid = false;
+    _cache->queueUpdate(elem, true);
+    if (elem == getSelf() || isGeomBindingElement(elem))
+    {
+        _cache->clearGeomBindingIndex();
+    }
 }
 
-void Document::onClearContent(ElementPtr)
+void Document::onBatchEdit(ElementPtr elem)
 {
-    _cache->valid = false;
+    // Removed elements cannot be located after the batch, so any removal
+    // requires a full rebuild of the cache.
+    if (elem == getSelf() || _sharedState->batchRemoval)
+    {
+        _cache->invalidate();
+        _cache->clearGeomBindingIndex();
+    }
+    else
+    {
+        _cache->queueUpdate(elem, true);
+        if (isGeomBindingElement(elem))
+        {
+            _cache->clearGeomBindingIndex();
+        }
+    }
 }
 
 } // namespace MaterialX
@@ -53,6 +53,7 @@ class Document : public GraphElement
     {
         DocumentPtr doc = createDocument<Document>();
         doc->copyContentFrom(getSelf());
+        doc->_referencedLibraries = _referencedLibraries;
         return doc;
     }
 
@@ -65,6 +66,56 @@ class Document : public GraphElement
     ///    import function.  Defaults to a null pointer.
     void importLibrary(const ConstDocumentPtr& library, const CopyOptions* copyOptions = nullptr);
 
+    /// Reference the given document as a shared library within this document.
+    /// Unlike importLibrary, the contents of the library document are not
+    /// copied, and lookups such as getNodeDef, getMatchingNodeDefs and
+    /// getImplementation fall back to referenced libraries, in the order they
+    /// were added, when no match is found in this document.
+    ///
+    /// A single library document may be referenced by any number of documents,
+    /// and since its contents are shared rather than copied, later edits to the
+    /// library are visible through every document that references it.  Elements
+    /// returned from a referenced library belong to the library document, so
+    /// their own lookups are resolved within that library.
+    /// @param library The library document to be referenced.
+    /// @throws ExceptionFoundCycle if the library references this document,
+    ///    directly or through its own referenced libraries.
+    void referenceLibrary(const ConstDocumentPtr& library);
+
+    /// Return the vector of library documents referenced by this document.
+    const vector<ConstDocumentPtr>& getReferencedLibraries() const
+    {
+        return _referencedLibraries;
+    }
+
+    /// Remove all library references from this document.
+    void clearReferencedLibraries()
+    {
+        _referencedLibraries.clear();
+    }
+
+    /// Return the element, if any, with the given qualified name at the root
+    /// scope of a referenced library.
+    ElementPtr getReferencedLibraryElement(const string& name) const;
+
+    /// @}
+    /// @name Batch Edits
+    /// @{
+
+    /// Begin a batch edit of this document.  Until the matching call to
+    /// endBatchEdit, edits to the elements of this document send no
+    /// individual notifications, and the outermost batch edit is instead
+    /// reported by a single call to onBatchEdit when it ends.  This removes
+    /// the overhead of change notifications from the bulk construction of
+    /// document content, and is typically managed by a ScopedBatchEdit.
+    /// @param elem The element whose subtree is edited within the batch.
+    ///    If a null pointer is given, then any element of the document may
+    ///    be edited.  Defaults to a null pointer.
+    void beginBatchEdit(ElementPtr elem = nullptr);
+
+    /// End a batch edit of this document.
+    void endBatchEdit();
+
     /// @}
     /// @name NodeGraph Elements
     /// @{
@@ -79,10 +130,11 @@ class Document : public GraphElement
         return addChild<NodeGraph>(name);
     }
 
-    /// Return the NodeGraph, if any, with the given name.
+    /// Return the NodeGraph, if any, with the given name, searching referenced
+    /// libraries if no match is found in this document.
     NodeGraphPtr getNodeGraph(const string& name) const
     {
-        return getChildOfType<NodeGraph>(name);
+        return getChildOrLibraryElement<NodeGraph>(name);
     }
 
     /// Return a vector of all NodeGraph elements in the document.
@@ -269,6 +321,13 @@ class Document : public GraphElement
         removeChildOfType<Collection>(name);
     }
 
+    /// Return the geometry binding index of the document, which finds the
+    /// material assignments, property assignments and visibilities of its
+    /// Looks that apply to specific geometries.  The index is built on first
+    /// use, and is rebuilt when the Looks and Collections of the document
+    /// are edited.
+    ConstGeomBindingIndexPtr getGeomBindingIndex() const;
+
     /// @}
     /// @name TypeDef Elements
     /// @{
@@ -283,10 +342,11 @@ class Document : public GraphElement
         return addChild<TypeDef>(name);
     }
 
-    /// Return the TypeDef, if any, with the given name.
+    /// Return the TypeDef, if any, with the given name, searching referenced
+    /// libraries if no match is found in this document.
     TypeDefPtr getTypeDef(const string& name) const
     {
-        return getChildOfType<TypeDef>(name);
+        return getChildOrLibraryElement<TypeDef>(name);
     }
 
     /// Return a vector of all TypeDef elements in the document.
@@ -325,10 +385,11 @@ class Document : public GraphElement
         return child;
     }
 
-    /// Return the NodeDef, if any, with the given name.
+    /// Return the NodeDef, if any, with the given name, searching referenced
+    /// libraries if no match is found in this document.
     NodeDefPtr getNodeDef(const string& name) const
     {
-        return getChildOfType<NodeDef>(name);
+        return getChildOrLibraryElement<NodeDef>(name);
     }
 
     /// Return a vector of all NodeDef elements in the document.
@@ -343,7 +404,8 @@ class Document : public GraphElement
         removeChildOfType<NodeDef>(name);
     }
 
-    /// Return a vector of all NodeDef elements that match the given node name.
+    /// Return a vector of all NodeDef elements that match the given node name,
+    /// including those within referenced libraries.
     vector<NodeDefPtr> getMatchingNodeDefs(const string& nodeName) const;
 
     /// @}
@@ -424,10 +486,11 @@ class Document : public GraphElement
         return addChild<Implementation>(name);
     }
 
-    /// Return the Implementation, if any, with the given name.
+    /// Return the Implementation, if any, with the given name, searching
+    /// referenced libraries if no match is found in this document.
     ImplementationPtr getImplementation(const string& name) const
     {
-        return getChildOfType<Implementation>(name);
+        return getChildOrLibraryElement<Implementation>(name);
     }
 
     /// Return a vector of all Implementation elements in the document.
@@ -443,8 +506,9 @@ class Document : public GraphElement
     }
 
     /// Return a vector of all node implementations that match the given
-    /// NodeDef string.  Note that a node implementation may be either an
-    /// Implementation element or NodeGraph element.
+    /// NodeDef string, including those within referenced libraries.  Note that
+    /// a node implementation may be either an Implementation element or
+    /// NodeGraph element.
     vector<InterfaceElementPtr> getMatchingImplementations(const string& nodeDef) const;
 
     /// @}
@@ -535,6 +599,10 @@ class Document : public GraphElement
     /// Called when content is cleared from an element.
     virtual void onClearContent(ElementPtr elem);
 
+    /// Called when a batch edit of an element and its descendants ends, in
+    /// place of the notifications for each of its individual edits.
+    virtual void onBatchEdit(ElementPtr elem);
+
     /// Called when data is read into the current document.
     virtual void onRead() { }
 
@@ -560,9 +628,23 @@ class Document : public GraphElement
     static const string CMS_ATTRIBUTE;
     static const string CMS_CONFIG_ATTRIBUTE;
 
+  private:
+    template<class T> shared_ptr<T> getChildOrLibraryElement(const string& name) const
+    {
+        shared_ptr<T> child = getChildOfType<T>(name);
+        if (child || _referencedLibraries.empty())
+        {
+            return child;
+        }
+        ElementPtr libraryElem = getReferencedLibraryElement(name);
+        return libraryElem ? libraryElem->asA<T>() : shared_ptr<T>();
+    }
+
   private:
     class Cache;
     std::unique_ptr<Cache> _cache;
+    vector<ConstDocumentPtr> _referencedLibraries;
+    ElementPtr _batchElement;
 };
 
 /// @class ScopedUpdate
@@ -587,6 +669,63 @@ class ScopedUpdate
     DocumentPtr _doc;
 };
 
+/// @class ScopedBatchEdit
+/// An RAII class for batch edits of a Document.
+///
+/// A ScopedBatchEdit instance calls Document::onBeginUpdate and
+/// Document::beginBatchEdit when created, and Document::endBatchEdit and
+/// Document::onEndUpdate when committed.  Since the end of a batch edit
+/// notifies observers, which may throw, callers should commit the batch
+/// edit once its edits are complete.  A batch edit that has not been
+/// committed is committed when destroyed, for example while an exception
+/// is propagated, and any exception thrown by observers is then discarded.
+class ScopedBatchEdit
+{
+  public:
+    explicit ScopedBatchEdit(DocumentPtr doc, ElementPtr elem = nullptr) :
+        _doc(doc)
+    {
+        _doc->onBeginUpdate();
+        _doc->beginBatchEdit(elem);
+    }
+    ~ScopedBatchEdit()
+    {
+        try
+        {
+            commit();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    /// End the batch edit, notifying observers of its edits.  Exceptions
+    /// thrown by observers are propagated to the caller.  Calls after the
+    /// first have no effect.
+    void commit()
+    {
+        if (!_doc)
+        {
+            return;
+        }
+        DocumentPtr doc = _doc;
+        _doc = nullptr;
+        try
+        {
+            doc->endBatchEdit();
+        }
+        catch (...)
+        {
+            doc->onEndUpdate();
+            throw;
+        }
+        doc->onEndUpdate();
+    }
+
+  private:
+    DocumentPtr _doc;
+};
+
 /// @class ScopedDisableCallbacks
 /// An RAII class for disabling Document callbacks.
 ///
@@ -9,6 +9,8 @@
 #include <MaterialXCore/Node.h>
 #include <MaterialXCore/Util.h>
 
+#include <stdexcept>
+
 namespace MaterialX
 {
 
@@ -36,6 +38,44 @@ const string ValueElement::UI_ADVANCED_ATTRIBUTE = "uiadvanced";
 
 Element::CreatorMap Element::_creatorMap;
 
+namespace {
+
+// An RAII class for the update notifications of a single edit, which are
+// skipped if the given document is null.
+class ScopedEditUpdate
+{
+  public:
+    explicit ScopedEditUpdate(DocumentPtr doc) :
+        _doc(doc)
+    {
+        if (_doc)
+        {
+            _doc->onBeginUpdate();
+        }
+    }
+    ~ScopedEditUpdate()
+    {
+        if (_doc)
+        {
+            _doc->onEndUpdate();
+        }
+    }
+
+  private:
+    DocumentPtr _doc;
+};
+
+// Return true if the given attribute affects the geometry paths of elements.
+bool isGeomAttribute(const string& attrib)
+{
+    return attrib == GeomElement::GEOM_ATTRIBUTE ||
+           attrib == Collection::INCLUDE_GEOM_ATTRIBUTE ||
+           attrib == Collection::EXCLUDE_GEOM_ATTRIBUTE ||
+           attrib == Element::GEOM_PREFIX_ATTRIBUTE;
+}
+
+} // anonymous namespace
+
 //
 // Element methods
 //
@@ -49,11 +89,12 @@ bool Element::operator==(const Element& rhs) const
     }
 
     // Compare attributes.
-    if (getAttributeNames() != rhs.getAttributeNames())
+    if (_attributes.size() != rhs._attributes.size())
         return false;
-    for (const string& attr : rhs.getAttributeNames())
+    for (size_t i = 0; i < _attributes.size(); i++)
     {
-        if (getAttribute(attr) != rhs.getAttribute(attr))
+        if (*_attributes[i].first != *rhs._attributes[i].first ||
+            _attributes[i].second != rhs._attributes[i].second)
             return false;
     }
 
@@ -77,7 +118,7 @@ bool Element::operator!=(const Element& rhs) const
 
 void Element::setName(const string& name)
 {
-    DocumentPtr doc = getDocument();
+    DocumentPtr doc = getNotifiedDocument();
     ElementPtr parent = getParent();
     if (parent && parent->_childMap.count(name) && name != getName())
     {
@@ -85,8 +126,11 @@ void Element::setName(const string& name)
     }
 
     // Handle change notifications.
-    ScopedUpdate update(doc);
-    doc->onSetAttribute(getSelf(), NAME_ATTRIBUTE, name);
+    ScopedEditUpdate update(doc);
+    if (doc)
+    {
+        doc->onSetAttribute(getSelf(), NAME_ATTRIBUTE, name);
+    }
 
     if (parent)
     {
@@ -156,45 +200,80 @@ std::pair<int, int> Element::getVersionIntegers() const
 
 void Element::registerChildElement(ElementPtr child)
 {
-    DocumentPtr doc = getDocument();
+    DocumentPtr doc = getNotifiedDocument();
 
     // Handle change notifications.
-    ScopedUpdate update(doc);
-    doc->onAddElement(getSelf(), child);
+    ScopedEditUpdate update(doc);
+    if (doc)
+    {
+        doc->onAddElement(getSelf(), child);
+    }
 
     _childMap[child->getName()] = child;
+    child->_childIndex = _childOrder.size();
     _childOrder.push_back(child);
 }
 
 void Element::unregisterChildElement(ElementPtr child)
 {
-    DocumentPtr doc = getDocument();
+    DocumentPtr doc = getNotifiedDocument();
 
     // Handle change notifications.
-    ScopedUpdate update(doc);
-    doc->onRemoveElement(getSelf(), child);
+    ScopedEditUpdate update(doc);
+    if (doc)
+    {
+        doc->onRemoveElement(getSelf(), child);
+    }
+
+    if (!doc)
+    {
+        _sharedState->batchRemoval = true;
+    }
 
     _childMap.erase(child->getName());
-    _childOrder.erase(
-        std::find(_childOrder.begin(), _childOrder.end(), child));
+    size_t index = child->_childIndex;
+    _childOrder.erase(_childOrder.begin() + index);
+    updateChildIndices(index, _childOrder.size());
+}
+
+void Element::replaceChildElement(ElementPtr oldChild, ElementPtr newChild)
+{
+    DocumentPtr doc = getNotifiedDocument();
+
+    // Handle change notifications.
+    ScopedEditUpdate update(doc);
+    if (doc)
+    {
+        doc->onRemoveElement(getSelf(), oldChild);
+        doc->onAddElement(getSelf(), newChild);
+    }
+
+    if (!doc)
+    {
+        _sharedState->batchRemoval = true;
+    }
+
+    // Take the place of the original child in the child order.
+    size_t index = oldChild->_childIndex;
+    _childMap[newChild->getName()] = newChild;
+    newChild->_childIndex = index;
+    _childOrder[index] = newChild;
 }
 
 int Element::getChildIndex(const string& name) const
 {
     ElementPtr child = getChild(name);
-    vector<ElementPtr>::const_iterator it = std::find(_childOrder.begin(), _childOrder.end(), child);
-    if (it == _childOrder.end())
+    if (!child)
     {
         return -1;
     }
-    return (int) std::distance(_childOrder.begin(), it);
+    return (int) child->_childIndex;
 }
 
 void Element::setChildIndex(const string& name, int index)
 {
     ElementPtr child = getChild(name);
-    vector<ElementPtr>::iterator it = std::find(_childOrder.begin(), _childOrder.end(), child);
-    if (it == _childOrder.end())
+    if (!child)
     {
         return;
     }
@@ -204,8 +283,39 @@ void Element::setChildIndex(const string& name, int index)
         throw Exception("Invalid child index");
     }
 
-    _childOrder.erase(it);
-    _childOrder.insert(_childOrder.begin() + (size_t) index, child);
+    // Rotate the range between the current and new positions, leaving the
+    // remaining children in place.
+    size_t oldIndex = child->_childIndex;
+    size_t newIndex = std::min((size_t) index, _childOrder.size() - 1);
+    vector<ElementPtr>::iterator begin = _childOrder.begin();
+    if (newIndex < oldIndex)
+    {
+        std::rotate(begin + newIndex, begin + oldIndex, begin + oldIndex + 1);
+        updateChildIndices(newIndex, oldIndex + 1);
+    }
+    else if (newIndex > oldIndex)
+    {
+        std::rotate(begin + oldIndex, begin + oldIndex + 1, begin + newIndex + 1);
+        updateChildIndices(oldIndex, newIndex + 1);
+    }
+}
+
+DocumentPtr Element::getNotifiedDocument()
+{
+    return isBatchEdit() ? nullptr : getDocument();
+}
+
+vector<GeomPath> Element::parseDocumentGeomString(const string& geom) const
+{
+    return parseGeomString(geom, getGeomSegmentPool(), false);
+}
+
+void Element::updateChildIndices(size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        _childOrder[i]->_childIndex = i;
+    }
 }
 
 void Element::removeChild(const string& name)
@@ -221,33 +331,51 @@ void Element::removeChild(const string& name)
 
 void Element::setAttribute(const string& attrib, const string& value)
 {
-    DocumentPtr doc = getDocument();
+    DocumentPtr doc = getNotifiedDocument();
 
     // Handle change notifications.
-    ScopedUpdate update(doc);
-    doc->onSetAttribute(getSelf(), attrib, value);
+    ScopedEditUpdate update(doc);
+    if (doc)
+    {
+        doc->onSetAttribute(getSelf(), attrib, value);
+    }
 
-    if (!_attributeMap.count(attrib))
+    if (isGeomAttribute(attrib))
+    {
+        _sharedState->geomRevision++;
+    }
+
+    const string* name = _sharedState->stringPool.intern(attrib);
+    vector<Attribute>::iterator it = findInternedAttribute(name);
+    if (it != _attributes.end())
+    {
+        it->second = value;
+    }
+    else
     {
-        _attributeOrder.push_back(attrib);
+        _attributes.emplace_back(name, value);
     }
-    _attributeMap[attrib] = value;
 }
 
 void Element::removeAttribute(const string& attrib)
 {
-    StringMap::iterator it = _attributeMap.find(attrib);
-    if (it != _attributeMap.end())
+    vector<Attribute>::iterator it = findAttribute(attrib);
+    if (it != _attributes.end())
     {
-        DocumentPtr doc = getDocument();
+        DocumentPtr doc = getNotifiedDocument();
 
         // Handle change notifications.
-        ScopedUpdate update(doc);
-        doc->onRemoveAttribute(getSelf(), attrib);
+        ScopedEditUpdate update(doc);
+        if (doc)
+        {
+            doc->onRemoveAttribute(getSelf(), attrib);
+        }
 
-        _attributeMap.erase(it);
-        _attributeOrder.erase(
-            std::find(_attributeOrder.begin(), _attributeOrder.end(), attrib));
+        if (isGeomAttribute(attrib))
+        {
+            _sharedState->geomRevision++;
+        }
+        _attributes.erase(it);
     }
 }
 
@@ -377,16 +505,28 @@ InheritanceIterator Element::traverseInheritance() const
 
 void Element::copyContentFrom(const ConstElementPtr& source, const CopyOptions* copyOptions)
 {
-    DocumentPtr doc = getDocument();
+    DocumentPtr doc = getNotifiedDocument();
     bool skipConflictingElements = copyOptions && copyOptions->skipConflictingElements;
 
-    // Handle change notifications.
-    ScopedUpdate update(doc);
-    doc->onCopyContent(getSelf());
+    // Handle change notifications, copying the content of descendants as
+    // a single batch edit.
+    std::unique_ptr<ScopedBatchEdit> batch;
+    if (doc)
+    {
+        batch.reset(new ScopedBatchEdit(doc, getSelf()));
+        doc->onCopyContent(getSelf());
+    }
 
     _sourceUri = source->_sourceUri;
-    _attributeMap = source->_attributeMap;
-    _attributeOrder = source->_attributeOrder;
+    _attributes = source->_attributes;
+    _sharedState->geomRevision++;
+    if (_sharedState != source->_sharedState)
+    {
+        for (Attribute& attr : _attributes)
+        {
+            attr.first = _sharedState->stringPool.intern(*attr.first);
+        }
+    }
 
     for (const ConstElementPtr& child : source->getChildren())
     {
@@ -409,19 +549,26 @@ void Element::copyContentFrom(const ConstElementPtr& source, const CopyOptions*
             throw Exception("Duplicate element with conflicting content: " + name);
         }
     }
+    if (batch)
+    {
+        batch->commit();
+    }
 }
 
 void Element::clearContent()
 {
-    DocumentPtr doc = getDocument();
+    DocumentPtr doc = getNotifiedDocument();
 
     // Handle change notifications.
-    ScopedUpdate update(doc);
-    doc->onClearContent(getSelf());
+    ScopedEditUpdate update(doc);
+    if (doc)
+    {
+        doc->onClearContent(getSelf());
+    }
 
     _sourceUri = EMPTY_STRING;
-    _attributeMap.clear();
-    _attributeOrder.clear();
+    _attributes.clear();
+    _sharedState->geomRevision++;
 
     vector<ElementPtr> children = getChildren();
     for (ElementPtr child : children)
@@ -461,9 +608,10 @@ StringResolverPtr Element::createStringResolver(const string& geom,
     // If a geometry name is specified, then apply it to the filename map.
     if (!geom.empty())
     {
+        vector<GeomPath> geomPaths = parseDocumentGeomString(geom);
         for (GeomInfoPtr geomInfo : getDocument()->getGeomInfos())
         {
-            if (!geomStringsMatch(geom, geomInfo->getActiveGeom()))
+            if (!geomPathsMatch(geomPaths, *geomInfo->getActiveGeomPaths()))
                 continue;
             for (TokenPtr token : geomInfo->getTokens())
             {
@@ -499,14 +647,25 @@ string Element::asString() const
     {
         res += " name=\"" + getName() + "\"";
     }
-    for (const string& attrName : getAttributeNames())
+    for (const Attribute& attr : _attributes)
     {
-        res += " " + attrName + "=\"" + getAttribute(attrName) + "\"";
+        res += " " + *attr.first + "=\"" + attr.second + "\"";
     }
     res += ">";
     return res;
 }
 
+ElementPtr Element::resolveLibraryReference(const string& name) const
+{
+    ConstDocumentPtr doc = getDocument();
+    if (!doc || doc->getReferencedLibraries().empty())
+    {
+        return ElementPtr();
+    }
+    ElementPtr elem = doc->getReferencedLibraryElement(getQualifiedName(name));
+    return elem ? elem : doc->getReferencedLibraryElement(name);
+}
+
 void Element::validateRequire(bool expression, bool& res, string* message, string errorDesc) const
 {
     if (!expression)
@@ -15,6 +15,9 @@
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
 
+#include <atomic>
+#include <iterator>
+
 namespace MaterialX
 {
 
@@ -26,6 +29,7 @@ class StringResolver;
 class Document;
 class Material;
 class CopyOptions;
+class GeomPath;
 
 /// A shared pointer to an Element
 using ElementPtr = shared_ptr<Element>;
@@ -56,6 +60,70 @@ using ElementMap = std::unordered_map<string, ElementPtr>;
 /// A standard function taking an ElementPtr and returning a boolean.
 using ElementPredicate = std::function<bool(ConstElementPtr)>;
 
+/// @class AttributeNames
+/// A read-only view of the attribute names of an element, in the order they
+/// were set.  The names are the strings interned by the document, so no copy
+/// of them is made.  A view remains valid until an attribute of its element
+/// is added or removed.
+class AttributeNames
+{
+  public:
+    using AttributeVec = vector<std::pair<const string*, string>>;
+
+    /// @class Iterator
+    /// An iterator over the names of an AttributeNames view.
+    class Iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = string;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const string*;
+        using reference = const string&;
+
+        explicit Iterator(AttributeVec::const_iterator it) :
+            _it(it)
+        {
+        }
+
+        reference operator*() const { return *_it->first; }
+        pointer operator->() const { return _it->first; }
+        Iterator& operator++() { ++_it; return *this; }
+        Iterator operator++(int) { Iterator it(*this); ++_it; return it; }
+        bool operator==(const Iterator& rhs) const { return _it == rhs._it; }
+        bool operator!=(const Iterator& rhs) const { return _it != rhs._it; }
+
+      private:
+        AttributeVec::const_iterator _it;
+    };
+
+    explicit AttributeNames(const AttributeVec& attributes) :
+        _attributes(&attributes)
+    {
+    }
+
+    /// Return an iterator to the first name.
+    Iterator begin() const { return Iterator(_attributes->begin()); }
+
+    /// Return an iterator past the last name.
+    Iterator end() const { return Iterator(_attributes->end()); }
+
+    /// Return the number of names.
+    size_t size() const { return _attributes->size(); }
+
+    /// Return true if there are no names.
+    bool empty() const { return _attributes->empty(); }
+
+    /// Return the name at the given index.
+    const string& operator[](size_t index) const { return *(*_attributes)[index].first; }
+
+    /// Return a vector holding copies of the names.
+    StringVec asStringVec() const { return StringVec(begin(), end()); }
+
+  private:
+    const AttributeVec* _attributes;
+};
+
 /// @class Element
 /// The base class for MaterialX elements.
 ///
@@ -67,8 +135,10 @@ class Element : public std::enable_shared_from_this<Element>
     Element(ElementPtr parent, const string& category, const string& name) :
         _category(category),
         _name(name),
+        _childIndex(0),
         _parent(parent),
-        _root(parent ? parent->getRoot() : nullptr)
+        _root(parent ? parent->getRoot() : nullptr),
+        _sharedState(parent ? parent->_sharedState : std::make_shared<SharedState>())
     {
     }
   public:
@@ -443,6 +513,12 @@ class Element : public std::enable_shared_from_this<Element>
                                   string name = EMPTY_STRING,
                                   bool registerChild = true);
 
+    /// Replace the given child element with a new child of the given
+    /// subclass, which takes the name, position and content of the original.
+    /// @throws Exception if the given element is not a child of this element.
+    /// @return A shared pointer to the new child element.
+    template<class T> shared_ptr<T> changeChildSubclass(ElementPtr child);
+
     /// Return the child element, if any, with the given name.
     ElementPtr getChild(const string& name) const
     {
@@ -517,24 +593,26 @@ class Element : public std::enable_shared_from_this<Element>
     /// Return true if the given attribute is present.
     bool hasAttribute(const string& attrib) const
     {
-        return _attributeMap.count(attrib) != 0;
+        return findAttribute(attrib) != _attributes.end();
     }
 
     /// Return the value string of the given attribute.  If the given attribute
     /// is not present, then an empty string is returned.
     const string& getAttribute(const string& attrib) const
     {
-        StringMap::const_iterator it = _attributeMap.find(attrib);
-        if (it == _attributeMap.end())
+        vector<Attribute>::const_iterator it = findAttribute(attrib);
+        if (it == _attributes.end())
             return EMPTY_STRING;
         else
             return it->second;
     }
 
-    /// Return a vector of stored attribute names, in the order they were set.
-    const StringVec& getAttributeNames() const
+    /// Return a view of the stored attribute names, in the order they were
+    /// set.  The view holds no copies of the names, and remains valid until
+    /// an attribute of this element is added or removed.
+    AttributeNames getAttributeNames() const
     {
-        return _attributeOrder;
+        return AttributeNames(_attributes);
     }
 
     /// Set the value of an implicitly typed attribute.  Since an attribute
@@ -826,9 +904,23 @@ class Element : public std::enable_shared_from_this<Element>
     {
         ConstElementPtr root = getRoot();
         shared_ptr<T> child = root->getChildOfType<T>(getQualifiedName(name));
-        return child ? child : root->getChildOfType<T>(name);
+        if (!child)
+        {
+            child = root->getChildOfType<T>(name);
+        }
+        if (!child)
+        {
+            ElementPtr libraryElem = resolveLibraryReference(name);
+            child = libraryElem ? libraryElem->asA<T>() : shared_ptr<T>();
+        }
+        return child;
     }
 
+    // Resolve a reference to a named element within the libraries referenced
+    // by this document, taking the namespace at the scope of this element into
+    // account.
+    ElementPtr resolveLibraryReference(const string& name) const;
+
     // Enforce a requirement within a validate method, updating the validation
     // state and optional output text if the requirement is not met.
     void validateRequire(bool expression, bool& res, string* message, string errorDesc) const;
@@ -847,6 +939,10 @@ class Element : public std::enable_shared_from_this<Element>
   protected:
     virtual void registerChildElement(ElementPtr child);
     virtual void unregisterChildElement(ElementPtr child);
+    virtual void replaceChildElement(ElementPtr oldChild, ElementPtr newChild);
+
+    // Update the cached child indices of children within the given range.
+    void updateChildIndices(size_t begin, size_t end);
 
     // Return a non-const copy of our self pointer, for use in constructing
     // graph traversal objects that require non-const storage.
@@ -855,6 +951,99 @@ class Element : public std::enable_shared_from_this<Element>
         return std::const_pointer_cast<Element>(shared_from_this());
     }
 
+    // An attribute name, interned in the string pool of the document, paired
+    // with its value string.
+    using Attribute = std::pair<const string*, string>;
+
+    // Return an iterator to the given attribute, or the end iterator if the
+    // attribute is not present.  The query is looked up once in the string
+    // pool of the document, since a name absent from the pool is held by no
+    // element of the document.
+    vector<Attribute>::const_iterator findAttribute(const string& attrib) const
+    {
+        return findInternedAttribute(_sharedState->stringPool.find(attrib));
+    }
+    vector<Attribute>::iterator findAttribute(const string& attrib)
+    {
+        return findInternedAttribute(_sharedState->stringPool.find(attrib));
+    }
+
+    // Return an iterator to the attribute with the given interned name, or
+    // the end iterator if the attribute is not present.  Since elements hold
+    // few attributes, a linear scan comparing addresses is faster than a
+    // hashed lookup.
+    vector<Attribute>::const_iterator findInternedAttribute(const string* name) const
+    {
+        return std::find_if(_attributes.begin(), _attributes.end(),
+                            [name](const Attribute& attr) { return attr.first == name; });
+    }
+    vector<Attribute>::iterator findInternedAttribute(const string* name)
+    {
+        return std::find_if(_attributes.begin(), _attributes.end(),
+                            [name](const Attribute& attr) { return attr.first == name; });
+    }
+
+    // Return true if a batch edit of the document is in progress, in which
+    // case edits send no individual notifications.
+    bool isBatchEdit() const
+    {
+        return _sharedState->batchDepth > 0;
+    }
+
+    // Return the document to be notified of an edit to this element, or a
+    // null pointer if a batch edit is in progress.
+    DocumentPtr getNotifiedDocument();
+
+    // Return the geometry revision of the document, which changes whenever
+    // an attribute affecting the geometry paths of elements is edited.
+    uint64_t getGeomRevision() const
+    {
+        return _sharedState->geomRevision;
+    }
+
+    // Return the pool in which the cached geometry paths of the document
+    // intern their segments.
+    const StringPoolPtr& getGeomSegmentPool() const
+    {
+        return _sharedState->geomSegmentPool;
+    }
+
+    // Parse the given geometry string, looking up its segments in the pool of
+    // the document without interning them, so that the paths are compared
+    // with the cached geometry paths of the document by the addresses of
+    // their segments.  Segments missing from the pool, which may still be
+    // interned by cached paths parsed later, are compared by characters.
+    vector<GeomPath> parseDocumentGeomString(const string& geom) const;
+
+    // State shared by all elements of a document.
+    struct SharedState
+    {
+        SharedState() :
+            batchDepth(0),
+            batchRemoval(false),
+            geomRevision(0),
+            geomSegmentPool(std::make_shared<StringPool>())
+        {
+        }
+
+        // The pool of interned attribute names.
+        StringPool stringPool;
+
+        // The nesting depth of the batch edit in progress, and whether any
+        // element has been removed within it.
+        int batchDepth;
+        bool batchRemoval;
+
+        // The revision of geometry attributes, incremented on each edit of a
+        // geometry or geometry prefix string, for use by GeomPathCache.
+        std::atomic<uint64_t> geomRevision;
+
+        // The pool of interned geometry path segments, which is shared with
+        // the paths interned in it.
+        StringPoolPtr geomSegmentPool;
+    };
+    using SharedStatePtr = shared_ptr<SharedState>;
+
   protected:
     string _category;
     string _name;
@@ -863,12 +1052,18 @@ class Element : public std::enable_shared_from_this<Element>
     ElementMap _childMap;
     vector<ElementPtr> _childOrder;
 
-    StringMap _attributeMap;
-    StringVec _attributeOrder;
+    // The position of this element within the child order of its parent,
+    // allowing constant-time index lookups.
+    size_t _childIndex;
+
+    // The attributes of this element, in the order they were set.
+    vector<Attribute> _attributes;
 
     weak_ptr<Element> _parent;
     weak_ptr<Element> _root;
 
+    SharedStatePtr _sharedState;
+
   private:
     Element(const Element&) = delete;
     Element& operator=(const Element&) = delete;
@@ -1325,6 +1520,18 @@ template<class T> shared_ptr<T> Element::addChild(const string& name)
     return child;
 }
 
+template<class T> shared_ptr<T> Element::changeChildSubclass(ElementPtr child)
+{
+    if (!child || getChild(child->getName()) != child)
+        throw Exception("Element is not a child of " + getName());
+
+    shared_ptr<T> newChild = std::make_shared<T>(getSelf(), child->getName());
+    replaceChildElement(child, newChild);
+    newChild->copyContentFrom(child);
+
+    return newChild;
+}
+
 /// Given two target strings, each containing a string array of target names,
 /// return true if they have any targets in common.  An empty target string
 /// matches all targets.
@@ -28,14 +28,23 @@ const string Collection::INCLUDE_COLLECTION_ATTRIBUTE = "includecollection";
 
 bool geomStringsMatch(const string& geom1, const string& geom2, bool contains)
 {
-    vector<GeomPath> paths1;
-    for (const string& name1 : splitString(geom1, ARRAY_VALID_SEPARATORS))
+    return geomPathsMatch(parseGeomString(geom1), parseGeomString(geom2), contains);
+}
+
+vector<GeomPath> parseGeomString(const string& geom, StringPoolPtr pool, bool intern)
+{
+    vector<GeomPath> paths;
+    for (const string& name : splitString(geom, ARRAY_VALID_SEPARATORS))
     {
-        paths1.push_back(GeomPath(name1));
+        paths.push_back(pool ? GeomPath(name, pool, intern) : GeomPath(name));
     }
-    for (const string& name2 : splitString(geom2, ARRAY_VALID_SEPARATORS))
+    return paths;
+}
+
+bool geomPathsMatch(const vector<GeomPath>& paths1, const vector<GeomPath>& paths2, bool contains)
+{
+    for (const GeomPath& path2 : paths2)
     {
-        GeomPath path2(name2);
         for (const GeomPath& path1 : paths1)
         {
             if (path1.isMatching(path2, contains))
@@ -47,6 +56,54 @@ bool geomStringsMatch(const string& geom1, const string& geom2, bool contains)
     return false;
 }
 
+//
+// GeomPath methods
+//
+
+GeomPath::GeomPath(const string& geom) :
+    _pool(nullptr),
+    _internedCount(0),
+    _empty(geom.empty())
+{
+    shared_ptr<StringVec> names = std::make_shared<StringVec>(splitString(geom, GEOM_PATH_SEPARATOR));
+    _segments.reserve(names->size());
+    for (const string& name : *names)
+    {
+        _segments.push_back(&name);
+    }
+    _names = names;
+}
+
+GeomPath::GeomPath(const string& geom, StringPoolPtr pool, bool intern) :
+    _pool(pool),
+    _internedCount(0),
+    _empty(geom.empty())
+{
+    StringVec names = splitString(geom, GEOM_PATH_SEPARATOR);
+    _segments.reserve(names.size());
+    for (const string& name : names)
+    {
+        const string* segment = intern ? pool->intern(name) : pool->find(name);
+        if (!segment)
+        {
+            break;
+        }
+        _segments.push_back(segment);
+    }
+    _internedCount = _segments.size();
+
+    // Store copies of the segments from the first one missing from the pool.
+    if (_internedCount < names.size())
+    {
+        shared_ptr<StringVec> missing = std::make_shared<StringVec>(names.begin() + _segments.size(), names.end());
+        for (const string& name : *missing)
+        {
+            _segments.push_back(&name);
+        }
+        _names = missing;
+    }
+}
+
 //
 // GeomElement methods
 //
@@ -138,13 +195,13 @@ bool Collection::hasIncludeCycle() const
     return false;
 }
 
-bool Collection::matchesGeomString(const string& geom) const
+bool Collection::matchesGeomPaths(const vector<GeomPath>& paths) const
 {
-    if (geomStringsMatch(getActiveExcludeGeom(), geom, true))
+    if (geomPathsMatch(*getActiveExcludeGeomPaths(), paths, true))
     {
         return false;
     }
-    if (geomStringsMatch(getActiveIncludeGeom(), geom))
+    if (geomPathsMatch(*getActiveIncludeGeomPaths(), paths))
     {
         return true;
     }
@@ -164,7 +221,7 @@ bool Collection::matchesGeomString(const string& geom) const
     }
     for (ConstCollectionPtr collection : includedSet)
     {
-        if (collection->matchesGeomString(geom))
+        if (collection->matchesGeomPaths(paths))
         {
             return true;
         }
@@ -58,10 +58,22 @@ using ConstCollectionPtr = shared_ptr<const Collection>;
 /// @class GeomPath
 /// A MaterialX geometry path, representing the hierarchical location
 /// expressed by a geometry name.
+///
+/// The segments of a path may be interned in a StringPool, such as the pool
+/// of a document in which its cached geometry paths are stored.  Two paths
+/// interned in the same pool are compared by the addresses of their segments,
+/// while all other paths are compared by the characters of their segments.
+/// A path may also look up its segments in a pool without interning them, in
+/// which case the segments following one missing from the pool are compared
+/// by their characters.
+/// A path shares ownership of the pool in which it is interned, so it remains
+/// valid after the document owning the pool has been destroyed.
 class GeomPath
 {
   public:
     GeomPath() :
+        _pool(nullptr),
+        _internedCount(0),
         _empty(true)
     {
     }
@@ -69,7 +81,8 @@ class GeomPath
     
     bool operator==(const GeomPath& rhs) const
     {
-        return _vec == rhs._vec &&
+        return _segments.size() == rhs._segments.size() &&
+               segmentsEqual(rhs, _segments.size()) &&
                _empty == rhs._empty;
     }
     bool operator!=(const GeomPath& rhs) const
@@ -77,25 +90,32 @@ class GeomPath
         return !(*this == rhs);
     }
 
-    /// Construct a path from a geometry name string.
-    explicit GeomPath(const string& geom) :
-        _vec(splitString(geom, GEOM_PATH_SEPARATOR)),
-        _empty(geom.empty())
-    {
-    }
+    /// Construct a path from a geometry name string, storing its own copy
+    /// of each segment.
+    explicit GeomPath(const string& geom);
+
+    /// Construct a path from a geometry name string, whose segments are
+    /// compared by address with other paths of the given pool.
+    /// @param geom The geometry name string.
+    /// @param pool The pool in which segments are interned or looked up.
+    /// @param intern If true, then segments are interned in the pool.  If
+    ///    false, then segments are only looked up, and the path stores its
+    ///    own copy of the segments from the first one missing from the pool.
+    ///    Defaults to true.
+    GeomPath(const string& geom, StringPoolPtr pool, bool intern = true);
 
     /// Convert a path to a geometry name string.
     operator string() const
     {
-        if (_vec.empty())
+        if (_segments.empty())
         {
             return _empty ? EMPTY_STRING : UNIVERSAL_GEOM_NAME;
         }
         string geom;
-        for (size_t i = 0; i < _vec.size(); i++)
+        for (size_t i = 0; i < _segments.size(); i++)
         {
-            geom += _vec[i];
-            if (i + 1 < _vec.size())
+            geom += *_segments[i];
+            if (i + 1 < _segments.size())
             {
                 geom += GEOM_PATH_SEPARATOR;
             }
@@ -113,19 +133,11 @@ class GeomPath
         {
             return false;
         }
-        if (contains && _vec.size() > rhs._vec.size())
+        if (contains && _segments.size() > rhs._segments.size())
         {
             return false;
         }
-        size_t minSize = std::min(_vec.size(), rhs._vec.size());
-        for (size_t i = 0; i < minSize; i++)
-        {
-            if (_vec[i] != rhs._vec[i])
-            {
-                return false;
-            }
-        }
-        return true;
+        return segmentsEqual(rhs, std::min(_segments.size(), rhs._segments.size()));
     }
 
     /// Return true if this geometry path is empty.  An empty path matches
@@ -139,14 +151,91 @@ class GeomPath
     /// matches all non-empty geometry paths.
     bool isUniversal() const
     {
-        return _vec.empty() && !_empty;
+        return _segments.empty() && !_empty;
     }
 
   private:
-    StringVec _vec;
+    // Return true if the given number of leading segments are equal in both
+    // paths.  Segments interned in the same pool by both paths are compared by
+    // address, and all other segments by their characters.
+    bool segmentsEqual(const GeomPath& rhs, size_t count) const
+    {
+        size_t internedCount = 0;
+        if (_pool && _pool == rhs._pool)
+        {
+            internedCount = std::min(count, std::min(_internedCount, rhs._internedCount));
+            if (!std::equal(_segments.begin(), _segments.begin() + internedCount, rhs._segments.begin()))
+            {
+                return false;
+            }
+        }
+        return std::equal(_segments.begin() + internedCount, _segments.begin() + count, rhs._segments.begin() + internedCount,
+                          [](const string* a, const string* b) { return *a == *b; });
+    }
+
+  private:
+    vector<const string*> _segments;
+    shared_ptr<const StringVec> _names;
+    shared_ptr<const StringPool> _pool;
+    size_t _internedCount;
     bool _empty;
 };
 
+/// Parse the given geometry string, which may contain a list of geometry
+/// names, into a vector of geometry paths.
+/// @param geom The geometry string to be parsed.
+/// @param pool An optional pool in which the segments of the paths are
+///    interned.  If no pool is given, then each path stores its own segments.
+/// @param intern If false, then the segments of the paths are looked up in
+///    the given pool without being interned.  Defaults to true.
+vector<GeomPath> parseGeomString(const string& geom, StringPoolPtr pool = nullptr, bool intern = true);
+
+/// Return true if any path in the first vector of geometry paths has any
+/// geometry in common with any path in the second.  If the contains argument
+/// is set to true, then we require that a path in the first vector completely
+/// contains a path in the second.
+bool geomPathsMatch(const vector<GeomPath>& paths1, const vector<GeomPath>& paths2, bool contains = false);
+
+/// @class GeomPathCache
+/// A cache of the geometry paths parsed from a geometry string of an element.
+/// The cached paths are parsed again once a geometry attribute of the
+/// document has been edited, as recorded by the geometry revision of the
+/// document.  Reading cached paths takes no lock, while parsing interns
+/// their segments in the pool of the document.
+class GeomPathCache
+{
+  public:
+    /// A shared pointer to a const vector of geometry paths.
+    using ConstPathsPtr = shared_ptr<const vector<GeomPath>>;
+
+    GeomPathCache() { }
+    ~GeomPathCache() { }
+
+    /// Return the cached paths if they were parsed at the given revision, and
+    /// otherwise parse and cache the geometry string returned by the given
+    /// function, interning its segments in the given pool.
+    template<class F> ConstPathsPtr getPaths(uint64_t revision, F getGeom, const StringPoolPtr& pool) const
+    {
+        shared_ptr<const Entry> entry = std::atomic_load(&_entry);
+        if (!entry || entry->revision != revision)
+        {
+            string geom = getGeom();
+            entry = std::make_shared<Entry>(Entry{ revision, parseGeomString(geom, pool) });
+            std::atomic_store(&_entry, entry);
+        }
+        return ConstPathsPtr(entry, &entry->paths);
+    }
+
+  private:
+    struct Entry
+    {
+        uint64_t revision;
+        vector<GeomPath> paths;
+    };
+
+    mutable shared_ptr<const Entry> _entry;
+};
+
 /// @class GeomElement
 /// The base class for geometric elements, which support bindings to geometries
 /// and geometric collections.
@@ -190,6 +279,15 @@ class GeomElement : public Element
                EMPTY_STRING;
     }
 
+    /// Return the geometry paths of the active geometry string of this
+    /// element, which are cached until a geometry attribute of the document
+    /// is edited.
+    GeomPathCache::ConstPathsPtr getActiveGeomPaths() const
+    {
+        return _activeGeomPaths.getPaths(getGeomRevision(), [this]() { return getActiveGeom(); },
+                                       getGeomSegmentPool());
+    }
+
     /// @}
     /// @name Collection
     /// @{
@@ -231,6 +329,9 @@ class GeomElement : public Element
   public:
     static const string GEOM_ATTRIBUTE;
     static const string COLLECTION_ATTRIBUTE;
+
+  private:
+    GeomPathCache _activeGeomPaths;
 };
 
 /// @class GeomInfo
@@ -581,7 +682,33 @@ class Collection : public Element
     /// Return true if this collection and the given geometry string have any
     /// geometries in common.
     /// @throws ExceptionFoundCycle if a cycle is encountered.
-    bool matchesGeomString(const string& geom) const;
+    bool matchesGeomString(const string& geom) const
+    {
+        return matchesGeomPaths(parseDocumentGeomString(geom));
+    }
+
+    /// Return true if this collection and the given geometry paths have any
+    /// geometries in common.
+    /// @throws ExceptionFoundCycle if a cycle is encountered.
+    bool matchesGeomPaths(const vector<GeomPath>& paths) const;
+
+    /// Return the geometry paths of the active include geometry string of
+    /// this element, which are cached until a geometry attribute of the
+    /// document is edited.
+    GeomPathCache::ConstPathsPtr getActiveIncludeGeomPaths() const
+    {
+        return _activeIncludeGeomPaths.getPaths(getGeomRevision(), [this]() { return getActiveIncludeGeom(); },
+                                              getGeomSegmentPool());
+    }
+
+    /// Return the geometry paths of the active exclude geometry string of
+    /// this element, which are cached until a geometry attribute of the
+    /// document is edited.
+    GeomPathCache::ConstPathsPtr getActiveExcludeGeomPaths() const
+    {
+        return _activeExcludeGeomPaths.getPaths(getGeomRevision(), [this]() { return getActiveExcludeGeom(); },
+                                              getGeomSegmentPool());
+    }
 
     /// @}
     /// @name Validation
@@ -598,6 +725,10 @@ class Collection : public Element
     static const string INCLUDE_GEOM_ATTRIBUTE;
     static const string EXCLUDE_GEOM_ATTRIBUTE;
     static const string INCLUDE_COLLECTION_ATTRIBUTE;
+
+  private:
+    GeomPathCache _activeIncludeGeomPaths;
+    GeomPathCache _activeExcludeGeomPaths;
 };
 
 template<class T> GeomAttrPtr GeomInfo::setGeomAttrValue(const string& name,
@@ -475,6 +475,35 @@ void InterfaceElement::unregisterChildElement(ElementPtr child)
     }
 }
 
+void InterfaceElement::replaceChildElement(ElementPtr oldChild, ElementPtr newChild)
+{
+    TypedElement::replaceChildElement(oldChild, newChild);
+    if (oldChild->isA<Parameter>())
+    {
+        _parameterCount--;
+    }
+    else if (oldChild->isA<Input>())
+    {
+        _inputCount--;
+    }
+    else if (oldChild->isA<Output>())
+    {
+        _outputCount--;
+    }
+    if (newChild->isA<Parameter>())
+    {
+        _parameterCount++;
+    }
+    else if (newChild->isA<Input>())
+    {
+        _inputCount++;
+    }
+    else if (newChild->isA<Output>())
+    {
+        _outputCount++;
+    }
+}
+
 ConstNodeDefPtr InterfaceElement::getDeclaration(const string&) const
 {
     return NodeDefPtr();
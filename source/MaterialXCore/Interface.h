@@ -656,6 +656,7 @@ class InterfaceElement : public TypedElement
   protected:
     void registerChildElement(ElementPtr child) override;
     void unregisterChildElement(ElementPtr child) override;
+    void replaceChildElement(ElementPtr oldChild, ElementPtr newChild) override;
 
   private:
     size_t _parameterCount;
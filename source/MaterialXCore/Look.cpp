@@ -5,6 +5,13 @@
 
 #include <MaterialXCore/Look.h>
 
+#include <MaterialXCore/Document.h>
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <thread>
+
 namespace MaterialX
 {
 
@@ -16,6 +23,20 @@ const string Visibility::VIEWER_COLLECTION_ATTRIBUTE = "viewercollection";
 const string Visibility::VISIBILITY_TYPE_ATTRIBUTE = "vistype";
 const string Visibility::VISIBLE_ATTRIBUTE = "visible";
 
+namespace {
+
+// The minimum number of geometry paths resolved by each task of a batch.
+const size_t MIN_RESOLVE_RANGE_SIZE = 256;
+
+// The number of tasks per thread of a batch, balancing the load of threads
+// over uneven hierarchies.
+const size_t RESOLVE_RANGES_PER_THREAD = 4;
+
+// The index of a missing node of the prefix tree.
+const size_t INVALID_NODE = std::numeric_limits<size_t>::max();
+
+} // anonymous namespace
+
 //
 // MaterialAssign methods
 //
@@ -109,4 +130,382 @@ MaterialPtr MaterialAssign::getReferencedMaterial() const
     return resolveRootNameReference<Material>(getMaterial());   
 }
 
+//
+// GeomBindingIndex methods
+//
+
+GeomBindingIndex::GeomBindingIndex(shared_ptr<const Document> doc) :
+    _nodes(1)
+{
+    std::unordered_map<CollectionPtr, size_t> collectionIndices;
+    for (LookPtr look : doc->getLooks())
+    {
+        for (ElementPtr child : look->getChildren())
+        {
+            string geom;
+            CollectionPtr collection;
+            GeomElementPtr geomElem = child->asA<GeomElement>();
+            PropertyAssignPtr propAssign = child->asA<PropertyAssign>();
+            if (geomElem)
+            {
+                geom = geomElem->getActiveGeom();
+                collection = geomElem->getCollection();
+            }
+            else if (propAssign)
+            {
+                geom = propAssign->getGeom();
+                collection = propAssign->getCollection();
+            }
+            else
+            {
+                continue;
+            }
+
+            size_t index = _bindings.size();
+            _bindings.push_back(child);
+            addGeomString(geom, &PathNode::bindings, index);
+            if (collection)
+            {
+                size_t collectionIndex = addCollection(collection, collectionIndices);
+                _collections[collectionIndex].bindings.push_back(index);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < _collections.size(); i++)
+    {
+        if (_collections[i].includeCycle && !_collections[i].bindings.empty())
+        {
+            _cyclicCollections.push_back(i);
+        }
+    }
+}
+
+vector<ElementPtr> GeomBindingIndex::getBindings(const string& geom, const ElementPredicate& predicate) const
+{
+    // Gather the bindings and collection geometries along each path, along
+    // with those beneath the end of the path.
+    Matches matches;
+    for (const string& name : splitString(geom, ARRAY_VALID_SEPARATORS))
+    {
+        StringVec segments = splitString(name, GEOM_PATH_SEPARATOR);
+        size_t node = 0;
+        for (size_t i = 0; ; i++)
+        {
+            matches.addNode(_nodes[node]);
+            if (i == segments.size())
+            {
+                addChildSubtrees(node, matches);
+                break;
+            }
+            node = findChild(node, segments[i]);
+            if (node == INVALID_NODE)
+            {
+                break;
+            }
+        }
+    }
+    resolveCollections(matches);
+
+    auto isMatched = [this, &predicate](size_t binding)
+    {
+        return !predicate || predicate(_bindings[binding]);
+    };
+    checkCycles(matches, isMatched);
+
+    vector<ElementPtr> elements;
+    elements.reserve(matches.bindings.size());
+    for (size_t binding : matches.bindings)
+    {
+        if (isMatched(binding))
+        {
+            elements.push_back(_bindings[binding]);
+        }
+    }
+    return elements;
+}
+
+GeomBindingTable GeomBindingIndex::resolveBindings(const StringVec& geomPaths, ConstLookPtr look,
+                                                   unsigned int threadCount) const
+{
+    // Restrict the bindings to those of the given look and its inherited looks.
+    vector<bool> lookBindings;
+    if (look)
+    {
+        std::set<ConstElementPtr> looks;
+        for (ConstElementPtr elem : look->traverseInheritance())
+        {
+            looks.insert(elem);
+        }
+        lookBindings.resize(_bindings.size());
+        for (size_t i = 0; i < _bindings.size(); i++)
+        {
+            lookBindings[i] = looks.count(_bindings[i]->getParent()) != 0;
+        }
+    }
+
+    // Split the paths into contiguous ranges, each of which is resolved by
+    // a single thread.  Within a range, each path is walked from the end of
+    // the prefix it shares with the previous path, so that the subtrees of
+    // a sorted hierarchy are walked once.
+    if (!threadCount)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    const size_t rangeCount = std::max<size_t>(1, std::min(geomPaths.size() / MIN_RESOLVE_RANGE_SIZE,
+                                                           (size_t) threadCount * RESOLVE_RANGES_PER_THREAD));
+
+    vector<GeomBindingTable> rangeTables(rangeCount);
+    parallelFor(rangeCount, [&](size_t r)
+    {
+        size_t begin = geomPaths.size() * r / rangeCount;
+        size_t end = geomPaths.size() * (r + 1) / rangeCount;
+        resolveRange(geomPaths, begin, end, lookBindings, rangeTables[r]);
+    }, threadCount);
+
+    // Combine the tables of all ranges.
+    GeomBindingTable table;
+    for (const GeomBindingTable& rangeTable : rangeTables)
+    {
+        size_t base = table._bindings.size();
+        for (size_t i = 1; i < rangeTable._offsets.size(); i++)
+        {
+            table._offsets.push_back((uint32_t) (base + rangeTable._offsets[i]));
+        }
+        table._bindings.insert(table._bindings.end(), rangeTable._bindings.begin(), rangeTable._bindings.end());
+    }
+    return table;
+}
+
+void GeomBindingIndex::resolveRange(const StringVec& geomPaths, size_t begin, size_t end,
+                                    const vector<bool>& lookBindings, GeomBindingTable& table) const
+{
+    // The nodes visited along the current path, with the number of matches
+    // gathered up to and including each node.
+    struct Level
+    {
+        size_t node;
+        size_t bindings;
+        size_t includes;
+        size_t excludes;
+    };
+
+    Matches prefixMatches;
+    prefixMatches.addNode(_nodes[0]);
+    vector<Level> levels = { { 0, prefixMatches.bindings.size(), prefixMatches.includes.size(),
+                               prefixMatches.excludes.size() } };
+    StringVec prevSegments;
+    for (size_t p = begin; p < end; p++)
+    {
+        if (geomPaths[p].empty())
+        {
+            table._offsets.push_back((uint32_t) table._bindings.size());
+            continue;
+        }
+
+        // Return to the deepest node shared with the previous path.
+        StringVec segments = splitString(geomPaths[p], GEOM_PATH_SEPARATOR);
+        size_t depth = 0;
+        while (depth + 1 < levels.size() && depth < segments.size() && segments[depth] == prevSegments[depth])
+        {
+            depth++;
+        }
+        levels.resize(depth + 1);
+        prefixMatches.bindings.resize(levels[depth].bindings);
+        prefixMatches.includes.resize(levels[depth].includes);
+        prefixMatches.excludes.resize(levels[depth].excludes);
+
+        // Continue down the path from that node.
+        for (size_t i = depth; i < segments.size(); i++)
+        {
+            size_t child = findChild(levels.back().node, segments[i]);
+            if (child == INVALID_NODE)
+            {
+                break;
+            }
+            prefixMatches.addNode(_nodes[child]);
+            levels.push_back({ child, prefixMatches.bindings.size(), prefixMatches.includes.size(),
+                               prefixMatches.excludes.size() });
+        }
+        prevSegments = std::move(segments);
+
+        Matches matches = prefixMatches;
+        if (levels.size() == prevSegments.size() + 1)
+        {
+            addChildSubtrees(levels.back().node, matches);
+        }
+        resolveCollections(matches);
+
+        auto isMatched = [&lookBindings](size_t binding)
+        {
+            return lookBindings.empty() || lookBindings[binding];
+        };
+        checkCycles(matches, isMatched);
+        for (size_t binding : matches.bindings)
+        {
+            if (isMatched(binding))
+            {
+                table._bindings.push_back((uint32_t) binding);
+            }
+        }
+        table._offsets.push_back((uint32_t) table._bindings.size());
+    }
+}
+
+size_t GeomBindingIndex::findChild(size_t node, const string& segment) const
+{
+    const PathNode& pathNode = _nodes[node];
+    auto it = pathNode.children.find(segment);
+    return it != pathNode.children.end() ? it->second : INVALID_NODE;
+}
+
+void GeomBindingIndex::addChildSubtrees(size_t node, Matches& matches) const
+{
+    for (const auto& child : _nodes[node].children)
+    {
+        addSubtree(child.second, matches);
+    }
+}
+
+void GeomBindingIndex::resolveCollections(Matches& matches) const
+{
+    // Record the bindings whose collections have include cycles, where
+    // neither the binding itself nor the own geometries of the collection
+    // decide the match, since Collection::matchesGeomString would raise an
+    // exception for them.
+    auto contains = [](const vector<size_t>& vec, size_t value)
+    {
+        return std::find(vec.begin(), vec.end(), value) != vec.end();
+    };
+    for (size_t cyclic : _cyclicCollections)
+    {
+        if (contains(matches.excludes, cyclic) || contains(matches.includes, cyclic))
+        {
+            continue;
+        }
+        for (size_t binding : _collections[cyclic].bindings)
+        {
+            if (!contains(matches.bindings, binding))
+            {
+                matches.cycles.emplace_back(binding, cyclic);
+            }
+        }
+    }
+
+    // A collection matches if it is not excluded, and either its own include
+    // geometry or that of a collection it includes matches.
+    if (!matches.includes.empty())
+    {
+        vector<size_t>& excludes = matches.excludes;
+        std::sort(excludes.begin(), excludes.end());
+        auto isExcluded = [&excludes](size_t collection)
+        {
+            return std::binary_search(excludes.begin(), excludes.end(), collection);
+        };
+        for (size_t included : matches.includes)
+        {
+            if (isExcluded(included))
+            {
+                continue;
+            }
+            const IndexedCollection& indexed = _collections[included];
+            matches.bindings.insert(matches.bindings.end(), indexed.bindings.begin(), indexed.bindings.end());
+            for (size_t includedBy : indexed.includedBy)
+            {
+                if (!isExcluded(includedBy))
+                {
+                    const vector<size_t>& collectionBindings = _collections[includedBy].bindings;
+                    matches.bindings.insert(matches.bindings.end(), collectionBindings.begin(), collectionBindings.end());
+                }
+            }
+        }
+    }
+
+    // Keep each binding once, in document order.
+    std::sort(matches.bindings.begin(), matches.bindings.end());
+    matches.bindings.erase(std::unique(matches.bindings.begin(), matches.bindings.end()), matches.bindings.end());
+}
+
+void GeomBindingIndex::checkCycles(const Matches& matches, const std::function<bool(size_t)>& isMatched) const
+{
+    for (const auto& cycle : matches.cycles)
+    {
+        if (isMatched(cycle.first))
+        {
+            throw ExceptionFoundCycle("Encountered a cycle in collection: " +
+                                      _collections[cycle.second].collection->getName());
+        }
+    }
+}
+
+size_t GeomBindingIndex::addCollection(CollectionPtr collection, std::unordered_map<CollectionPtr, size_t>& indices)
+{
+    auto it = indices.find(collection);
+    if (it != indices.end())
+    {
+        return it->second;
+    }
+    size_t index = _collections.size();
+    indices[collection] = index;
+    _collections.push_back({ collection, {}, {}, false });
+    addGeomString(collection->getActiveIncludeGeom(), &PathNode::includes, index);
+    addGeomString(collection->getActiveExcludeGeom(), &PathNode::excludes, index);
+
+    // Register this collection with each collection it includes, directly
+    // or indirectly.  Include cycles are recorded, so that matches through
+    // this collection raise ExceptionFoundCycle, and are broken at the first
+    // collection reached twice.
+    std::set<CollectionPtr> includedSet;
+    vector<CollectionPtr> includedVec = collection->getIncludeCollections();
+    for (size_t i = 0; i < includedVec.size(); i++)
+    {
+        CollectionPtr included = includedVec[i];
+        if (!includedSet.insert(included).second)
+        {
+            _collections[index].includeCycle = true;
+            continue;
+        }
+        size_t includedIndex = addCollection(included, indices);
+        _collections[includedIndex].includedBy.push_back(index);
+        vector<CollectionPtr> appendVec = included->getIncludeCollections();
+        includedVec.insert(includedVec.end(), appendVec.begin(), appendVec.end());
+    }
+    return index;
+}
+
+size_t GeomBindingIndex::addPath(const string& name)
+{
+    size_t node = 0;
+    for (const string& segment : splitString(name, GEOM_PATH_SEPARATOR))
+    {
+        auto it = _nodes[node].children.find(segment);
+        if (it != _nodes[node].children.end())
+        {
+            node = it->second;
+            continue;
+        }
+        size_t child = _nodes.size();
+        _nodes[node].children[segment] = child;
+        _nodes.emplace_back();
+        node = child;
+    }
+    return node;
+}
+
+void GeomBindingIndex::addGeomString(const string& geom, vector<size_t> PathNode::* entries, size_t index)
+{
+    for (const string& name : splitString(geom, ARRAY_VALID_SEPARATORS))
+    {
+        (_nodes[addPath(name)].*entries).push_back(index);
+    }
+}
+
+void GeomBindingIndex::addSubtree(size_t node, Matches& matches) const
+{
+    const PathNode& pathNode = _nodes[node];
+    matches.bindings.insert(matches.bindings.end(), pathNode.bindings.begin(), pathNode.bindings.end());
+    matches.includes.insert(matches.includes.end(), pathNode.includes.begin(), pathNode.includes.end());
+    addChildSubtrees(node, matches);
+}
+
 } // namespace MaterialX
@@ -22,6 +22,8 @@ class Look;
 class LookInherit;
 class MaterialAssign;
 class Visibility;
+class GeomBindingTable;
+class GeomBindingIndex;
 
 /// A shared pointer to a Look
 using LookPtr = shared_ptr<Look>;
@@ -38,6 +40,11 @@ using VisibilityPtr = shared_ptr<Visibility>;
 /// A shared pointer to a const Visibility
 using ConstVisibilityPtr = shared_ptr<const Visibility>;
 
+/// A shared pointer to a GeomBindingIndex
+using GeomBindingIndexPtr = shared_ptr<GeomBindingIndex>;
+/// A shared pointer to a const GeomBindingIndex
+using ConstGeomBindingIndexPtr = shared_ptr<const GeomBindingIndex>;
+
 /// @class Look
 /// A look element within a Document.
 class Look : public Element
@@ -439,6 +446,210 @@ class Visibility : public GeomElement
     static const string VISIBLE_ATTRIBUTE;
 };
 
+/// @class GeomBindingTable
+/// The geometry bindings resolved for a list of geometry paths by
+/// GeomBindingIndex::resolveBindings.
+///
+/// The bindings of all paths are stored in a single array, as indices of
+/// binding elements in the index, with the bindings of each path in
+/// document order.
+class GeomBindingTable
+{
+  public:
+    GeomBindingTable() :
+        _offsets(1, 0)
+    {
+    }
+    ~GeomBindingTable() { }
+
+    /// Return the number of geometry paths in the table.
+    size_t getGeomCount() const
+    {
+        return _offsets.size() - 1;
+    }
+
+    /// Return the number of bindings of the geometry path at the given index.
+    size_t getBindingCount(size_t geomIndex) const
+    {
+        return _offsets[geomIndex + 1] - _offsets[geomIndex];
+    }
+
+    /// Return the index within the GeomBindingIndex of a binding of the
+    /// geometry path at the given index.
+    /// @param geomIndex The index of the geometry path.
+    /// @param bindingIndex The index of the binding, less than
+    ///    getBindingCount(geomIndex).
+    size_t getBindingIndex(size_t geomIndex, size_t bindingIndex) const
+    {
+        return _bindings[_offsets[geomIndex] + bindingIndex];
+    }
+
+  private:
+    friend class GeomBindingIndex;
+
+    vector<uint32_t> _offsets;
+    vector<uint32_t> _bindings;
+};
+
+/// @class GeomBindingIndex
+/// A compiled index of the geometry bindings within the Looks of a document.
+///
+/// The index holds a prefix tree over the segments of the geometry paths
+/// bound by the MaterialAssign, PropertyAssign, PropertySetAssign and
+/// Visibility elements of each Look, and by the include and exclude
+/// geometries of each Collection.  The bindings that apply to a geometry
+/// path are found in time proportional to the depth of the path and the
+/// number of bound paths beneath it, rather than by comparing the path with
+/// every binding in the document.  Matches follow the rules of
+/// geomStringsMatch and Collection::matchesGeomString.
+///
+/// The index is a snapshot of the document at the time it was built.  The
+/// index returned by Document::getGeomBindingIndex is rebuilt as required
+/// when the Looks and Collections of the document are edited.
+class GeomBindingIndex
+{
+  public:
+    explicit GeomBindingIndex(shared_ptr<const Document> doc);
+    ~GeomBindingIndex() { }
+
+    /// Build and return a new index of the given document.
+    static GeomBindingIndexPtr create(shared_ptr<const Document> doc)
+    {
+        return std::make_shared<GeomBindingIndex>(doc);
+    }
+
+    /// Return all binding elements that apply to the given geometry string,
+    /// in document order.
+    /// @param geom The geometry string to match.
+    /// @param predicate If given, then only the binding elements accepted by
+    ///    this function are matched and returned.
+    /// @throws ExceptionFoundCycle if the collection of a matched binding has
+    ///    an include cycle, and the geometry is neither bound by the binding
+    ///    itself nor decided by the include and exclude geometries of the
+    ///    collection, as in Collection::matchesGeomString.
+    vector<ElementPtr> getBindings(const string& geom, const ElementPredicate& predicate = nullptr) const;
+
+    /// Return the MaterialAssign elements that apply to the given geometry string.
+    vector<MaterialAssignPtr> getMaterialAssigns(const string& geom) const
+    {
+        return getBindingsOfType<MaterialAssign>(geom);
+    }
+
+    /// Return the PropertyAssign elements that apply to the given geometry string.
+    vector<PropertyAssignPtr> getPropertyAssigns(const string& geom) const
+    {
+        return getBindingsOfType<PropertyAssign>(geom);
+    }
+
+    /// Return the PropertySetAssign elements that apply to the given geometry string.
+    vector<PropertySetAssignPtr> getPropertySetAssigns(const string& geom) const
+    {
+        return getBindingsOfType<PropertySetAssign>(geom);
+    }
+
+    /// Return the Visibility elements that apply to the given geometry string.
+    vector<VisibilityPtr> getVisibilities(const string& geom) const
+    {
+        return getBindingsOfType<Visibility>(geom);
+    }
+
+    /// Resolve the bindings of each of the given geometry paths in a single
+    /// pass, returning a table of their bindings.  Each path is a single
+    /// geometry name, and sorting the paths allows the walk over each shared
+    /// prefix to be performed once.  Contiguous ranges of paths are resolved
+    /// in parallel.
+    /// @param geomPaths The geometry paths to resolve.
+    /// @param look If given, then only the bindings of this Look and the
+    ///    Looks it inherits from are returned.
+    /// @param threadCount Maximum number of threads to use, or zero to use
+    ///    one thread per hardware core.
+    /// @throws ExceptionFoundCycle under the conditions given for getBindings.
+    GeomBindingTable resolveBindings(const StringVec& geomPaths, ConstLookPtr look = nullptr,
+                                     unsigned int threadCount = 0) const;
+
+    /// Return the binding element at the given index.
+    ElementPtr getBinding(size_t index) const
+    {
+        return _bindings[index];
+    }
+
+    /// Return the number of binding elements in the index.
+    size_t getBindingCount() const
+    {
+        return _bindings.size();
+    }
+
+  private:
+    // A node of the prefix tree, holding the bindings and collection
+    // geometries whose paths end at the node.
+    struct PathNode
+    {
+        std::unordered_map<string, size_t> children;
+        vector<size_t> bindings;
+        vector<size_t> includes;
+        vector<size_t> excludes;
+    };
+
+    // The bindings and collection geometries found along a geometry path.
+    struct Matches
+    {
+        void addNode(const PathNode& node)
+        {
+            bindings.insert(bindings.end(), node.bindings.begin(), node.bindings.end());
+            includes.insert(includes.end(), node.includes.begin(), node.includes.end());
+            excludes.insert(excludes.end(), node.excludes.begin(), node.excludes.end());
+        }
+
+        vector<size_t> bindings;
+        vector<size_t> includes;
+        vector<size_t> excludes;
+
+        // Bindings whose collection, given as the second index, has an
+        // include cycle that is reached in matching the geometry.
+        vector<std::pair<size_t, size_t>> cycles;
+    };
+
+    // A collection referenced by the bindings of the index.
+    struct IndexedCollection
+    {
+        CollectionPtr collection;
+        vector<size_t> bindings;
+        vector<size_t> includedBy;
+        bool includeCycle;
+    };
+
+    template<class T> vector<shared_ptr<T>> getBindingsOfType(const string& geom) const
+    {
+        vector<shared_ptr<T>> typedBindings;
+        for (ElementPtr binding : getBindings(geom, [](ConstElementPtr elem) { return elem->isA<T>(); }))
+        {
+            shared_ptr<T> typedBinding = binding->asA<T>();
+            if (typedBinding)
+            {
+                typedBindings.push_back(typedBinding);
+            }
+        }
+        return typedBindings;
+    }
+
+    size_t addCollection(CollectionPtr collection, std::unordered_map<CollectionPtr, size_t>& indices);
+    size_t addPath(const string& name);
+    void addGeomString(const string& geom, vector<size_t> PathNode::* entries, size_t index);
+    size_t findChild(size_t node, const string& segment) const;
+    void addSubtree(size_t node, Matches& matches) const;
+    void addChildSubtrees(size_t node, Matches& matches) const;
+    void resolveCollections(Matches& matches) const;
+    void checkCycles(const Matches& matches, const std::function<bool(size_t)>& isMatched) const;
+    void resolveRange(const StringVec& geomPaths, size_t begin, size_t end,
+                      const vector<bool>& lookBindings, GeomBindingTable& table) const;
+
+  private:
+    vector<PathNode> _nodes;
+    vector<ElementPtr> _bindings;
+    vector<IndexedCollection> _collections;
+    vector<size_t> _cyclicCollections;
+};
+
 } // namespace MaterialX
 
 #endif
@@ -62,26 +62,17 @@ vector<NodeDefPtr> Material::getShaderNodeDefs(const string& target, const strin
 
 vector<MaterialAssignPtr> Material::getGeometryBindings(const string& geom) const
 {
+    ConstElementPtr self = getSelf();
+    auto bindsMaterial = [&self](ConstElementPtr elem)
+    {
+        ConstMaterialAssignPtr matAssign = elem->asA<MaterialAssign>();
+        return matAssign && matAssign->getReferencedMaterial() == self;
+    };
+
     vector<MaterialAssignPtr> matAssigns;
-    for (LookPtr look : getDocument()->getLooks())
+    for (ElementPtr binding : getDocument()->getGeomBindingIndex()->getBindings(geom, bindsMaterial))
     {
-        for (MaterialAssignPtr matAssign : look->getMaterialAssigns())
-        {
-            if (matAssign->getReferencedMaterial() == getSelf())
-            {
-                if (geomStringsMatch(geom, matAssign->getActiveGeom()))
-                {
-                    matAssigns.push_back(matAssign);
-                    continue;
-                }
-                CollectionPtr coll = matAssign->getCollection();
-                if (coll && coll->matchesGeomString(geom))
-                {
-                    matAssigns.push_back(matAssign);
-                    continue;
-                }
-            }
-        }
+        matAssigns.push_back(binding->asA<MaterialAssign>());
     }
     return matAssigns;
 }
@@ -197,6 +197,8 @@ class Material : public Element
     /// @param geom The geometry for which material bindings should be returned.
     ///    By default, this argument is the universal geometry string "/", and
     ///    all material bindings are returned.
+    /// @throws ExceptionFoundCycle if the collection of a material binding
+    ///    has an include cycle, as described for GeomBindingIndex::getBindings.
     vector<MaterialAssignPtr> getGeometryBindings(const string& geom = UNIVERSAL_GEOM_NAME) const;
 
     /// @}
@@ -181,6 +181,10 @@ bool Node::validate(string* message) const
 
 void GraphElement::flattenSubgraphs(const string& target)
 {
+    // The most recent name generated for each subnode, allowing the search
+    // for the next unique name to resume where the previous one ended.
+    StringMap destNameMap;
+
     vector<NodePtr> processNodeVec = getNodes();
     while (!processNodeVec.empty())
     {
@@ -205,20 +209,28 @@ void GraphElement::flattenSubgraphs(const string& target)
         }
         processNodeVec.clear();
 
+        // The new subnodes that will replace each node with a graph implementation.
+        size_t origChildCount = _childOrder.size();
+        std::unordered_map<ElementPtr, vector<ElementPtr>> replacementMap;
+
         // Iterate through nodes with graph implementations.
         for (const auto& pair : graphImplMap)
         {
             NodePtr processNode = pair.first;
             NodeGraphPtr sourceSubGraph = pair.second;
             std::unordered_map<NodePtr, NodePtr> subNodeMap;
+            vector<ElementPtr>& replacements = replacementMap[processNode];
 
             // Create a new instance of each original subnode.
             for (NodePtr sourceSubNode : sourceSubGraph->getNodes())
             {
-                string destName = createValidChildName(sourceSubGraph->getName() + "_" + sourceSubNode->getName());
+                string baseName = sourceSubGraph->getName() + "_" + sourceSubNode->getName();
+                auto nameIt = destNameMap.find(baseName);
+                string destName = createValidChildName(nameIt != destNameMap.end() ? nameIt->second : baseName);
+                destNameMap[baseName] = destName;
                 NodePtr destSubNode = addNode(sourceSubNode->getCategory(), destName);
                 destSubNode->copyContentFrom(sourceSubNode);
-                setChildIndex(destSubNode->getName(), getChildIndex(processNode->getName()));
+                replacements.push_back(destSubNode);
 
                 // Transfer interface properties from the reference node to the new subnode.
                 for (ValueElementPtr destValue : destSubNode->getChildrenOfType<ValueElement>())
@@ -283,9 +295,39 @@ void GraphElement::flattenSubgraphs(const string& target)
                     }
                 }
             }
+        }
+
+        // Move the new subnodes to the positions of the nodes they replace, in a
+        // single pass over the child order.  The replaced nodes are moved to the
+        // end of the child order, where each can be removed in constant time.
+        if (!replacementMap.empty())
+        {
+            vector<ElementPtr> childOrder;
+            vector<ElementPtr> replacedNodes;
+            childOrder.reserve(_childOrder.size());
+            for (size_t i = 0; i < origChildCount; i++)
+            {
+                ElementPtr child = _childOrder[i];
+                auto it = replacementMap.find(child);
+                if (it != replacementMap.end())
+                {
+                    childOrder.insert(childOrder.end(), it->second.begin(), it->second.end());
+                    replacedNodes.push_back(child);
+                }
+                else
+                {
+                    childOrder.push_back(child);
+                }
+            }
+            childOrder.insert(childOrder.end(), replacedNodes.begin(), replacedNodes.end());
+            _childOrder.swap(childOrder);
+            updateChildIndices(0, _childOrder.size());
 
-            // The processed node has been replaced, so remove it from the graph.
-            removeNode(processNode->getName());
+            // The processed nodes have been replaced, so remove them from the graph.
+            for (auto it = replacedNodes.rbegin(); it != replacedNodes.rend(); ++it)
+            {
+                removeNode((*it)->getName());
+            }
         }
     }
 }
@@ -56,6 +56,10 @@ class Observer
     /// Called when content is cleared from an element.
     virtual void onClearContent(ElementPtr) { }
 
+    /// Called when a batch edit of an element and its descendants ends, in
+    /// place of the notifications for each of its individual edits.
+    virtual void onBatchEdit(ElementPtr) { }
+
     /// Called when data is read into the current document.
     virtual void onRead() { }
 
@@ -195,6 +199,7 @@ class ObservedDocument : public Document
 
     void onCopyContent(ElementPtr elem) override
     {
+        Document::onCopyContent(elem);
         if (_callbacksEnabled)
         {
             for (auto& item : _observerMap)
@@ -206,6 +211,7 @@ class ObservedDocument : public Document
 
     void onClearContent(ElementPtr elem) override
     {
+        Document::onClearContent(elem);
         if (_callbacksEnabled)
         {
             for (auto& item : _observerMap)
@@ -215,6 +221,18 @@ class ObservedDocument : public Document
         }
     }
 
+    void onBatchEdit(ElementPtr elem) override
+    {
+        Document::onBatchEdit(elem);
+        if (_callbacksEnabled)
+        {
+            for (auto& item : _observerMap)
+            {
+                item.second->onBatchEdit(elem);
+            }
+        }
+    }
+
     void onRead() override
     {
         if (_callbacksEnabled)
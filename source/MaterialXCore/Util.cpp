@@ -7,6 +7,10 @@
 
 #include <MaterialXCore/Element.h>
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 namespace MaterialX
 {
 
@@ -108,6 +112,184 @@ string replaceSubstrings(string str, const StringMap& stringMap)
     return str;
 }
 
+void parallelFor(size_t count, const std::function<void(size_t)>& func, unsigned int threadCount)
+{
+    if (!threadCount)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threadCount = (unsigned int) std::min((size_t) threadCount, count);
+    if (threadCount <= 1)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            func(i);
+        }
+        return;
+    }
+
+    // Indices are claimed in increasing order, so keeping the exception with
+    // the lowest index reproduces the exception of a serial loop.
+    std::atomic<size_t> nextIndex(0);
+    std::exception_ptr firstException;
+    size_t firstExceptionIndex = count;
+    std::mutex exceptionMutex;
+    auto worker = [&]()
+    {
+        for (size_t i = nextIndex++; i < count; i = nextIndex++)
+        {
+            try
+            {
+                func(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> guard(exceptionMutex);
+                if (i < firstExceptionIndex)
+                {
+                    firstException = std::current_exception();
+                    firstExceptionIndex = i;
+                }
+                nextIndex = count;
+            }
+        }
+    };
+
+    // The calling thread acts as one of the workers.
+    vector<std::thread> threads;
+    for (unsigned int i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    if (firstException)
+    {
+        std::rethrow_exception(firstException);
+    }
+}
+
+//
+// StringPool methods
+//
+
+struct StringPool::Entry
+{
+    Entry(const string& str, size_t hash) :
+        str(str),
+        hash(hash)
+    {
+    }
+
+    const string str;
+    const size_t hash;
+};
+
+// An open-addressed hash table of entries, whose slots are written at most
+// once, so that they may be read without locking.
+struct StringPool::Table
+{
+    explicit Table(size_t capacity) :
+        mask(capacity - 1),
+        slots(new std::atomic<const Entry*>[capacity])
+    {
+        for (size_t i = 0; i < capacity; i++)
+        {
+            slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    const size_t mask;
+    std::unique_ptr<std::atomic<const Entry*>[]> slots;
+};
+
+StringPool::StringPool() :
+    _table(nullptr)
+{
+    _tables.emplace_back(new Table(64));
+    _table.store(_tables.back().get(), std::memory_order_release);
+}
+
+StringPool::~StringPool()
+{
+}
+
+const string* StringPool::intern(const string& str)
+{
+    const size_t hash = std::hash<string>()(str);
+    const string* found = findEntry(*_table.load(std::memory_order_acquire), str, hash);
+    if (found)
+    {
+        return found;
+    }
+
+    std::lock_guard<std::mutex> guard(_mutex);
+    Table* table = _tables.back().get();
+    found = findEntry(*table, str, hash);
+    if (found)
+    {
+        return found;
+    }
+
+    // Keep the table at most half full, moving to a table of twice the
+    // capacity when needed.
+    if (2 * (_entries.size() + 1) > table->mask + 1)
+    {
+        _tables.emplace_back(new Table(2 * (table->mask + 1)));
+        table = _tables.back().get();
+        for (const std::unique_ptr<Entry>& entry : _entries)
+        {
+            insertEntry(*table, entry.get());
+        }
+        _table.store(table, std::memory_order_release);
+    }
+
+    _entries.emplace_back(new Entry(str, hash));
+    insertEntry(*table, _entries.back().get());
+    return &_entries.back()->str;
+}
+
+const string* StringPool::find(const string& str) const
+{
+    return findEntry(*_table.load(std::memory_order_acquire), str, std::hash<string>()(str));
+}
+
+size_t StringPool::size() const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _entries.size();
+}
+
+const string* StringPool::findEntry(const Table& table, const string& str, size_t hash)
+{
+    for (size_t i = hash & table.mask; ; i = (i + 1) & table.mask)
+    {
+        const Entry* entry = table.slots[i].load(std::memory_order_acquire);
+        if (!entry)
+        {
+            return nullptr;
+        }
+        if (entry->hash == hash && entry->str == str)
+        {
+            return &entry->str;
+        }
+    }
+}
+
+void StringPool::insertEntry(Table& table, const Entry* entry)
+{
+    size_t i = entry->hash & table.mask;
+    while (table.slots[i].load(std::memory_order_relaxed))
+    {
+        i = (i + 1) & table.mask;
+    }
+    table.slots[i].store(entry, std::memory_order_release);
+}
+
 string prettyPrint(ConstElementPtr elem)
 {
     string text;
@@ -11,6 +11,9 @@
 
 #include <MaterialXCore/Library.h>
 
+#include <atomic>
+#include <mutex>
+
 namespace MaterialX
 {
 
@@ -44,6 +47,62 @@ StringVec splitString(const string& str, const string& sep);
 /// Apply the given substring substitutions to the input string.
 string replaceSubstrings(string str, const StringMap& stringMap);
 
+/// Invoke the given function once for each index in the range [0, count),
+/// distributing the calls across a set of worker threads.  The calling thread
+/// blocks until all calls have completed.  If any call throws, then no further
+/// indices are started, and the exception with the lowest index is rethrown on
+/// the calling thread.
+/// @param count The number of indices to process.
+/// @param func The function to invoke for each index.
+/// @param threadCount The maximum number of worker threads to use.  If zero,
+///    then the hardware concurrency of the system is used.  Defaults to zero.
+void parallelFor(size_t count, const std::function<void(size_t)>& func, unsigned int threadCount = 0);
+
+/// @class StringPool
+/// A pool of interned strings, in which each distinct string is stored once.
+/// The address of a stored string remains valid for the lifetime of the pool,
+/// so interned strings may be compared by address.  Strings may be found from
+/// any number of threads while other threads intern new strings.
+class StringPool
+{
+  public:
+    StringPool();
+    ~StringPool();
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    /// Return the stored copy of the given string, adding it to the pool
+    /// if it is not already present.
+    const string* intern(const string& str);
+
+    /// Return the stored copy of the given string, or nullptr if it is
+    /// not present in the pool.
+    const string* find(const string& str) const;
+
+    /// Return the number of distinct strings in the pool.
+    size_t size() const;
+
+  private:
+    struct Entry;
+    struct Table;
+
+    static const string* findEntry(const Table& table, const string& str, size_t hash);
+    static void insertEntry(Table& table, const Entry* entry);
+
+  private:
+    // The table used for lookups, which is replaced by a larger table as the
+    // pool grows.  Replaced tables are kept until the pool is destroyed,
+    // since lookups on other threads may still be reading them.
+    std::atomic<const Table*> _table;
+    vector<std::unique_ptr<Table>> _tables;
+    vector<std::unique_ptr<Entry>> _entries;
+    mutable std::mutex _mutex;
+};
+
+/// A shared pointer to a StringPool
+using StringPoolPtr = shared_ptr<StringPool>;
+
 /// Pretty print the given element tree, calling asString recursively on each
 /// element in depth-first order.
 string prettyPrint(ConstElementPtr elem);
@@ -15,8 +15,8 @@ namespace MaterialX
 {
 
 Value::CreatorMap Value::_creatorMap;
-Value::FloatFormat Value::_floatFormat = Value::FloatFormatDefault;
-int Value::_floatPrecision = 6;
+thread_local Value::FloatFormat Value::_floatFormat = Value::FloatFormatDefault;
+thread_local int Value::_floatPrecision = 6;
 
 namespace {
 
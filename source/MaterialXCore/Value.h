@@ -75,7 +75,8 @@ class Value
     /// Return the value string for this value.
     virtual string getValueString() const = 0;
 
-    /// Set float formatting for converting values to strings.
+    /// Set float formatting for converting values to strings on the
+    /// current thread.
     /// Formats to use are FloatFormatFixed, FloatFormatScientific 
     /// or FloatFormatDefault to set default format.
     static void setFloatFormat(FloatFormat format)
@@ -83,7 +84,8 @@ class Value
         _floatFormat = format;
     }
 
-    /// Set float precision for converting values to strings.
+    /// Set float precision for converting values to strings on the
+    /// current thread.
     static void setFloatPrecision(int precision)
     {
         _floatPrecision = precision;
@@ -109,8 +111,8 @@ class Value
 
   private:
     static CreatorMap _creatorMap;
-    static FloatFormat _floatFormat;
-    static int _floatPrecision;
+    static thread_local FloatFormat _floatFormat;
+    static thread_local int _floatPrecision;
 };
 
 /// The class template for typed subclasses of Value
@@ -174,7 +176,8 @@ template <class T> class TypedValue : public Value
 };
 
 /// @class ScopedFloatFormatting
-/// An RAII class for controlling the float formatting of values.
+/// An RAII class for controlling the float formatting of values on the
+/// current thread.
 class ScopedFloatFormatting
 {
   public:
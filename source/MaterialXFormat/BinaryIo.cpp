@@ -0,0 +1,369 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXFormat/BinaryIo.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace MaterialX
+{
+
+const string MTLX_BINARY_EXTENSION = "mtlxb";
+
+namespace {
+
+using Word = uint32_t;
+
+const Word BINARY_MAGIC = 0x42584C4D; // "MLXB" in little-endian byte order
+const Word BINARY_VERSION = 1;
+
+const size_t HEADER_WORDS = 6;
+const size_t ELEMENT_WORDS = 5;
+const size_t ATTRIBUTE_WORDS = 2;
+
+//
+// Writing
+//
+
+class BinaryWriter
+{
+  public:
+    BinaryWriter()
+    {
+        intern(EMPTY_STRING);
+    }
+
+    void addElement(ConstElementPtr elem)
+    {
+        const AttributeNames attrNames = elem->getAttributeNames();
+        vector<ElementPtr> children = elem->getChildren();
+
+        _elements.push_back(intern(elem->getCategory()));
+        _elements.push_back(intern(elem->getName()));
+        _elements.push_back(intern(elem->getSourceUri()));
+        _elements.push_back((Word) attrNames.size());
+        _elements.push_back((Word) children.size());
+        for (const string& attrName : attrNames)
+        {
+            _attributes.push_back(intern(attrName));
+            _attributes.push_back(intern(elem->getAttribute(attrName)));
+        }
+        for (ConstElementPtr child : children)
+        {
+            addElement(child);
+        }
+    }
+
+    void write(std::ostream& stream) const
+    {
+        vector<Word> offsets;
+        offsets.reserve(_strings.size() + 1);
+        Word offset = 0;
+        for (const string* str : _strings)
+        {
+            offsets.push_back(offset);
+            offset += (Word) str->size();
+        }
+        offsets.push_back(offset);
+        size_t padding = (4 - offset % 4) % 4;
+
+        Word header[HEADER_WORDS] =
+        {
+            BINARY_MAGIC,
+            BINARY_VERSION,
+            (Word) _strings.size(),
+            offset,
+            (Word) (_elements.size() / ELEMENT_WORDS),
+            (Word) (_attributes.size() / ATTRIBUTE_WORDS)
+        };
+        writeWords(stream, header, HEADER_WORDS);
+        writeWords(stream, offsets.data(), offsets.size());
+        for (const string* str : _strings)
+        {
+            stream.write(str->data(), str->size());
+        }
+        const char zeros[4] = { 0, 0, 0, 0 };
+        stream.write(zeros, padding);
+        writeWords(stream, _elements.data(), _elements.size());
+        writeWords(stream, _attributes.data(), _attributes.size());
+    }
+
+  private:
+    Word intern(const string& str)
+    {
+        auto it = _stringIndices.find(str);
+        if (it != _stringIndices.end())
+        {
+            return it->second;
+        }
+        Word index = (Word) _strings.size();
+        it = _stringIndices.emplace(str, index).first;
+        _strings.push_back(&it->first);
+        return index;
+    }
+
+    static void writeWords(std::ostream& stream, const Word* words, size_t count)
+    {
+        stream.write(reinterpret_cast<const char*>(words), count * sizeof(Word));
+    }
+
+  private:
+    std::unordered_map<string, Word> _stringIndices;
+    vector<const string*> _strings;
+    vector<Word> _elements;
+    vector<Word> _attributes;
+};
+
+//
+// Reading
+//
+
+class BinaryReader
+{
+  public:
+    BinaryReader(const void* buffer, size_t size) :
+        _data(static_cast<const char*>(buffer)),
+        _size(size),
+        _elementIndex(0),
+        _attributeIndex(0)
+    {
+        if (!_data || _size < HEADER_WORDS * sizeof(Word))
+        {
+            throw ExceptionParseError("Binary document is truncated");
+        }
+        if (readWord(0) != BINARY_MAGIC)
+        {
+            throw ExceptionParseError("Invalid binary document header");
+        }
+        if (readWord(1) != BINARY_VERSION)
+        {
+            throw ExceptionParseError("Unsupported binary document version: " + std::to_string(readWord(1)));
+        }
+        size_t stringCount = readWord(2);
+        size_t stringDataSize = readWord(3);
+        _elementCount = readWord(4);
+        _attributeCount = readWord(5);
+
+        size_t offsetsStart = HEADER_WORDS * sizeof(Word);
+        size_t stringDataStart = offsetsStart + (stringCount + 1) * sizeof(Word);
+        _elementsStart = stringDataStart + ((stringDataSize + 3) / 4) * 4;
+        _attributesStart = _elementsStart + _elementCount * ELEMENT_WORDS * sizeof(Word);
+        size_t end = _attributesStart + _attributeCount * ATTRIBUTE_WORDS * sizeof(Word);
+        if (stringCount == 0 || end != _size)
+        {
+            throw ExceptionParseError("Binary document is truncated");
+        }
+
+        // Construct each distinct string once.
+        _strings.reserve(stringCount);
+        for (size_t i = 0; i < stringCount; i++)
+        {
+            size_t begin = readWord(offsetsStart / sizeof(Word) + i);
+            size_t next = readWord(offsetsStart / sizeof(Word) + i + 1);
+            if (begin > next || next > stringDataSize)
+            {
+                throw ExceptionParseError("Invalid string table in binary document");
+            }
+            _strings.emplace_back(_data + stringDataStart + begin, next - begin);
+        }
+    }
+
+    void readDocument(DocumentPtr doc, const CopyOptions* readOptions)
+    {
+        if (_elementCount == 0)
+        {
+            throw ExceptionParseError("Binary document has no root element");
+        }
+        const string& category = readString(_elementsStart, 0);
+        if (category != Document::CATEGORY)
+        {
+            throw ExceptionParseError("Invalid root element in binary document: " + category);
+        }
+        const string& sourceUri = readString(_elementsStart, 2);
+        if (!sourceUri.empty())
+        {
+            doc->setSourceUri(sourceUri);
+        }
+        readElement(doc, readOptions);
+        if (_elementIndex != _elementCount || _attributeIndex != _attributeCount)
+        {
+            throw ExceptionParseError("Unexpected trailing data in binary document");
+        }
+    }
+
+  private:
+    Word readWord(size_t wordIndex) const
+    {
+        Word word;
+        std::memcpy(&word, _data + wordIndex * sizeof(Word), sizeof(Word));
+        return word;
+    }
+
+    const string& readString(size_t recordStart, size_t field) const
+    {
+        Word index = readWord(recordStart / sizeof(Word) + field);
+        if (index >= _strings.size())
+        {
+            throw ExceptionParseError("Invalid string index in binary document");
+        }
+        return _strings[index];
+    }
+
+    size_t beginRecord(size_t& index, size_t count, size_t start, size_t recordWords)
+    {
+        if (index >= count)
+        {
+            throw ExceptionParseError("Binary document is truncated");
+        }
+        return start + (index++) * recordWords * sizeof(Word);
+    }
+
+    void readElement(ElementPtr elem, const CopyOptions* readOptions)
+    {
+        bool skipConflictingElements = readOptions && readOptions->skipConflictingElements;
+
+        size_t record = beginRecord(_elementIndex, _elementCount, _elementsStart, ELEMENT_WORDS);
+        Word attributeCount = readWord(record / sizeof(Word) + 3);
+        Word childCount = readWord(record / sizeof(Word) + 4);
+
+        // Store attributes in element.
+        for (Word i = 0; i < attributeCount; i++)
+        {
+            size_t attribute = beginRecord(_attributeIndex, _attributeCount, _attributesStart, ATTRIBUTE_WORDS);
+            elem->setAttribute(readString(attribute, 0), readString(attribute, 1));
+        }
+
+        // Create child elements and recurse.
+        for (Word i = 0; i < childCount; i++)
+        {
+            if (_elementIndex >= _elementCount)
+            {
+                throw ExceptionParseError("Binary document is truncated");
+            }
+            size_t childRecord = _elementsStart + _elementIndex * ELEMENT_WORDS * sizeof(Word);
+            const string& category = readString(childRecord, 0);
+            const string& name = readString(childRecord, 1);
+            const string& sourceUri = readString(childRecord, 2);
+
+            // Check for duplicate elements.
+            ConstElementPtr previous = elem->getChild(name);
+            if (previous && skipConflictingElements)
+            {
+                skipElement();
+                continue;
+            }
+
+            // Create the new element.
+            ElementPtr child = elem->addChildOfCategory(category, name, !previous);
+            child->setSourceUri(sourceUri);
+            readElement(child, readOptions);
+
+            // Check for conflicting elements.
+            if (previous && *previous != *child)
+            {
+                throw Exception("Duplicate element with conflicting content: " + name);
+            }
+        }
+    }
+
+    void skipElement()
+    {
+        size_t record = beginRecord(_elementIndex, _elementCount, _elementsStart, ELEMENT_WORDS);
+        _attributeIndex += readWord(record / sizeof(Word) + 3);
+        if (_attributeIndex > _attributeCount)
+        {
+            throw ExceptionParseError("Binary document is truncated");
+        }
+        Word childCount = readWord(record / sizeof(Word) + 4);
+        for (Word i = 0; i < childCount; i++)
+        {
+            skipElement();
+        }
+    }
+
+  private:
+    const char* _data;
+    size_t _size;
+
+    StringVec _strings;
+    size_t _elementsStart;
+    size_t _attributesStart;
+    size_t _elementCount;
+    size_t _attributeCount;
+
+    size_t _elementIndex;
+    size_t _attributeIndex;
+};
+
+} // anonymous namespace
+
+//
+// Reading
+//
+
+void readFromBinaryBuffer(DocumentPtr doc, const void* buffer, size_t size, const CopyOptions* readOptions)
+{
+    BinaryReader reader(buffer, size);
+
+    ScopedUpdate update(doc);
+    doc->onRead();
+    {
+        ScopedBatchEdit batch(doc);
+        reader.readDocument(doc, readOptions);
+        batch.commit();
+    }
+    doc->upgradeVersion();
+}
+
+void readFromBinaryFile(DocumentPtr doc, const string& filename, const string& searchPath, const CopyOptions* readOptions)
+{
+    FileSearchPath fileSearchPath = FileSearchPath(searchPath);
+    fileSearchPath.append(getEnvironmentPath());
+    FilePath filePath = fileSearchPath.find(filename);
+
+    MappedFile mappedFile;
+    if (!mappedFile.open(filePath))
+    {
+        throw ExceptionFileMissing("Failed to open file for reading: " + filePath.asString());
+    }
+
+    doc->setSourceUri(filename);
+    readFromBinaryBuffer(doc, mappedFile.getData(), mappedFile.getSize(), readOptions);
+}
+
+//
+// Writing
+//
+
+void writeToBinaryStream(DocumentPtr doc, std::ostream& stream)
+{
+    ScopedUpdate update(doc);
+    doc->onWrite();
+
+    BinaryWriter writer;
+    writer.addElement(doc);
+    writer.write(stream);
+}
+
+void writeToBinaryFile(DocumentPtr doc, const string& filename)
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    writeToBinaryStream(doc, ofs);
+}
+
+string writeToBinaryString(DocumentPtr doc)
+{
+    std::ostringstream stream(std::ios::out | std::ios::binary);
+    writeToBinaryStream(doc, stream);
+    return stream.str();
+}
+
+} // namespace MaterialX
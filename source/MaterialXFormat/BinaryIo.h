@@ -0,0 +1,89 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_BINARYIO_H
+#define MATERIALX_BINARYIO_H
+
+/// @file
+/// Support for a compact binary encoding of MaterialX documents
+
+#include <MaterialXFormat/XmlIo.h>
+
+namespace MaterialX
+{
+
+extern const string MTLX_BINARY_EXTENSION;
+
+/// @name Binary Format
+/// The binary encoding stores the fully resolved content of a document,
+/// including the source URI of each element, so that a binary read produces
+/// the same document as the XML read from which it was written.
+///
+/// All values are 32-bit unsigned integers in native byte order, laid out
+/// as follows:
+///   - A header of six words: magic, version, string count, string data
+///     size in bytes, element count, and attribute count.
+///   - A string table of (string count + 1) offsets into the string data,
+///     followed by the string data itself, padded to a multiple of four
+///     bytes.  Each distinct string is stored once, and string zero is
+///     always the empty string.
+///   - A flat array of element records in depth-first order, each holding
+///     the string indices of its category, name, and source URI, followed
+///     by its attribute count and child count.
+///   - A flat array of attribute records in the same order as the elements
+///     that own them, each holding the string indices of a name and value.
+///
+/// Since the encoding contains no pointers and is read in place, a buffer
+/// mapped directly from a file may be passed to readFromBinaryBuffer.
+/// @{
+
+/// Read a Document in binary form from the given memory buffer.  The buffer
+/// is read in place and is not modified.
+/// @param doc The Document into which data is read.
+/// @param buffer The memory buffer from which data is read.
+/// @param size The size of the memory buffer in bytes.
+/// @param readOptions An optional pointer to a CopyOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    read function.  Defaults to a null pointer.
+/// @throws ExceptionParseError if the buffer is not a valid binary document.
+void readFromBinaryBuffer(DocumentPtr doc, const void* buffer, size_t size, const CopyOptions* readOptions = nullptr);
+
+/// Read a Document in binary form from the given filename.
+/// @param doc The Document into which data is read.
+/// @param filename The filename from which data is read.
+/// @param searchPath A semicolon-separated sequence of file paths, which will
+///    be applied in order when searching for the given file.  Defaults to the
+///    empty string.
+/// @param readOptions An optional pointer to a CopyOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    read function.  Defaults to a null pointer.
+/// @throws ExceptionParseError if the file is not a valid binary document.
+/// @throws ExceptionFileMissing if the file cannot be opened.
+void readFromBinaryFile(DocumentPtr doc,
+                        const string& filename,
+                        const string& searchPath = EMPTY_STRING,
+                        const CopyOptions* readOptions = nullptr);
+
+/// Write a Document in binary form to the given output stream.
+/// @param doc The Document to be written.
+/// @param stream The output stream to which data is written.  The stream
+///    should be opened in binary mode.
+void writeToBinaryStream(DocumentPtr doc, std::ostream& stream);
+
+/// Write a Document in binary form to the given filename.
+/// @param doc The Document to be written.
+/// @param filename The filename to which data is written.
+void writeToBinaryFile(DocumentPtr doc, const string& filename);
+
+/// Write a Document in binary form to a new string, returned by value.
+/// @param doc The Document to be written.
+/// @return The output string, returned by value
+string writeToBinaryString(DocumentPtr doc);
+
+/// @}
+
+} // namespace MaterialX
+
+#endif
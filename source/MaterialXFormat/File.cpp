@@ -13,6 +13,8 @@
 #include <direct.h>
 #else
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <dirent.h>
 #endif
@@ -156,6 +158,25 @@ bool FilePath::isDirectory() const
 #endif
 }
 
+int64_t FilePath::getModifiedTime() const
+{
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesEx(asString().c_str(), GetFileExInfoStandard, &data))
+        return 0;
+    return ((int64_t) data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat sb;
+    if (stat(asString().c_str(), &sb))
+        return 0;
+#if defined(__APPLE__)
+    return (int64_t) sb.st_mtimespec.tv_sec * 1000000000 + sb.st_mtimespec.tv_nsec;
+#else
+    return (int64_t) sb.st_mtim.tv_sec * 1000000000 + sb.st_mtim.tv_nsec;
+#endif
+#endif
+}
+
 FilePathVec FilePath::getFilesInDirectory(const string& extension) const
 {
     FilePathVec files;
@@ -269,6 +290,92 @@ FilePath FilePath::getCurrentPath()
 #endif
 }
 
+//
+// MappedFile methods
+//
+
+bool MappedFile::open(const FilePath& path)
+{
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFile(path.asString().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    if (fileSize.QuadPart > 0)
+    {
+        // The view retains the mapping once both handles are closed.
+        HANDLE mapping = CreateFileMapping(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (mapping)
+        {
+            _data = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+            CloseHandle(mapping);
+        }
+        if (!_data)
+        {
+            CloseHandle(file);
+            return false;
+        }
+        _size = (size_t) fileSize.QuadPart;
+    }
+    CloseHandle(file);
+#else
+    int file = ::open(path.asString().c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+    struct stat sb;
+    if (fstat(file, &sb) || !S_ISREG(sb.st_mode))
+    {
+        ::close(file);
+        return false;
+    }
+    if (sb.st_size > 0)
+    {
+        // The mapping is retained once the file descriptor is closed.
+        void* data = mmap(nullptr, (size_t) sb.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(file);
+            return false;
+        }
+        _data = static_cast<char*>(data);
+        _size = (size_t) sb.st_size;
+    }
+    ::close(file);
+#endif
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (_data)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(_data);
+#else
+        munmap(_data, _size);
+#endif
+    }
+    _data = nullptr;
+    _size = 0;
+}
+
+//
+// Global functions
+//
+
 FileSearchPath getEnvironmentPath(const string& sep)
 {
     string searchPathEnv = getEnviron(MATERIALX_SEARCH_PATH_ENV_VAR);
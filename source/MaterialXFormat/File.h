@@ -11,6 +11,8 @@
 
 #include <MaterialXCore/Util.h>
 
+#include <cstdint>
+
 namespace MaterialX
 {
 
@@ -131,6 +133,10 @@ class FilePath
     /// Return true if the given path is a directory on the file system.
     bool isDirectory() const;
 
+    /// Return the time at which the file at the given path was last modified,
+    /// in platform-specific units, or zero if the path does not exist.
+    int64_t getModifiedTime() const;
+
     /// Return a vector of all files in the given directory with the given extension.
     FilePathVec getFilesInDirectory(const string& extension) const;
 
@@ -278,6 +284,55 @@ class FileSearchPath
     FilePathVec _paths;
 };
 
+/// @class MappedFile
+/// The contents of a file, mapped into memory for reading.
+///
+/// The mapping is private to the process and copy-on-write, so its contents
+/// may be modified in place, for example by an in-place parser, without
+/// affecting the file itself.
+class MappedFile
+{
+  public:
+    MappedFile() :
+        _data(nullptr),
+        _size(0)
+    {
+    }
+    ~MappedFile()
+    {
+        close();
+    }
+
+    /// Map the contents of the given file into memory, releasing any
+    /// previous mapping.
+    /// @return True if the file was successfully mapped.
+    bool open(const FilePath& path);
+
+    /// Release the current mapping, if any.
+    void close();
+
+    /// Return a pointer to the mapped contents, or nullptr if no file is
+    /// mapped or the mapped file is empty.
+    char* getData() const
+    {
+        return _data;
+    }
+
+    /// Return the size of the mapped contents in bytes.
+    size_t getSize() const
+    {
+        return _size;
+    }
+
+  private:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+  private:
+    char* _data;
+    size_t _size;
+};
+
 /// Return a FileSearchPath object from search path environment variable.
 FileSearchPath getEnvironmentPath(const string& sep = PATH_LIST_SEPARATOR);
 
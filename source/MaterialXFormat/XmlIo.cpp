@@ -27,8 +27,12 @@ namespace {
 
 const string XINCLUDE_TAG = "xi:include";
 
+// Read the given XML node into an element, skipping the subtrees of child
+// nodes that are excluded by the element predicate of the read options.
 void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptions* readOptions)
 {
+    const XmlElementPredicate* elementPredicate = (readOptions && readOptions->elementPredicate) ?
+                                                  &readOptions->elementPredicate : nullptr;
     bool skipConflictingElements = readOptions && readOptions->skipConflictingElements;
 
     // Store attributes in element.
@@ -61,6 +65,12 @@ void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptio
             continue;
         }
 
+        // Skip excluded elements.
+        if (elementPredicate && !(*elementPredicate)(XmlElementInfo(category, name, xmlChild)))
+        {
+            continue;
+        }
+
         // Create the new element.
         ElementPtr child = elem->addChildOfCategory(category, name, !previous);
         elementFromXml(xmlChild, child, readOptions);
@@ -120,29 +130,32 @@ void elementToXml(ConstElementPtr elem, xml_node& xmlNode, const XmlWriteOptions
     }
 }
 
-void xmlDocumentFromFile(xml_document& xmlDoc, string filename, const string& searchPath)
+// Parse the given file in place from a memory mapping, which must outlive
+// the XML document.
+void xmlDocumentFromFile(xml_document& xmlDoc, MappedFile& mappedFile, string filename, const string& searchPath)
 {
     FileSearchPath fileSearchPath = FileSearchPath(searchPath);
     fileSearchPath.append(getEnvironmentPath());
 
     filename = fileSearchPath.find(filename);
+    if (!mappedFile.open(filename))
+    {
+        throw ExceptionFileMissing("Failed to open file for reading: " + filename);
+    }
 
-    xml_parse_result result = xmlDoc.load_file(filename.c_str());
+    xml_parse_result result = xmlDoc.load_buffer_inplace(mappedFile.getData(), mappedFile.getSize());
     if (!result)
     {
-        if (result.status == xml_parse_status::status_file_not_found ||
-            result.status == xml_parse_status::status_io_error ||
-            result.status == xml_parse_status::status_out_of_memory)
+        // The file has already been mapped, so the only failures are out of
+        // memory conditions and parse errors.
+        if (result.status == xml_parse_status::status_out_of_memory)
         {
             throw ExceptionFileMissing("Failed to open file for reading: " + filename);
         }
-        else
-        {
-            string desc = result.description();
-            string offset = std::to_string(result.offset);
-            throw ExceptionParseError("XML parse error in file: " + filename +
-                                      " (" + desc + " at character " + offset + ")");
-        }
+        string desc = result.description();
+        string offset = std::to_string(result.offset);
+        throw ExceptionParseError("XML parse error in file: " + filename +
+                                  " (" + desc + " at character " + offset + ")");
     }
 }
 
@@ -151,6 +164,8 @@ void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const string& searchPa
     // Search path for includes. Set empty and then evaluated once in the iteration through xml includes.
     string includeSearchPath;
 
+    // Gather the XInclude references at this scope, removing each include directive.
+    StringVec filenames;
     XmlReadFunction readXIncludeFunction = readOptions ? readOptions->readXIncludeFunction : readFromXmlFile;
     xml_node xmlChild = xmlNode.first_child();
     while (xmlChild)
@@ -172,11 +187,6 @@ void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const string& searchPa
                     }
                 }
 
-                // Read the included file into a library document.
-                DocumentPtr library = createDocument();
-                XmlReadOptions xiReadOptions = readOptions ? *readOptions : XmlReadOptions();
-                xiReadOptions.parentXIncludes.push_back(filename);
-
                 // Prepend the directory of the parent to accomodate
                 // includes relative the the parent file location.
                 if (includeSearchPath.empty())
@@ -199,10 +209,8 @@ void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const string& searchPa
                         includeSearchPath = searchPath;
                     }
                 }
-                readXIncludeFunction(library, filename, includeSearchPath, &xiReadOptions);
 
-                // Import the library document.
-                doc->importLibrary(library, readOptions);
+                filenames.push_back(filename);
             }
 
             // Remove include directive.
@@ -215,6 +223,25 @@ void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const string& searchPa
             xmlChild = xmlChild.next_sibling();
         }
     }
+
+    // Read the included files into library documents.
+    vector<DocumentPtr> libraries(filenames.size());
+    auto readXInclude = [&](size_t index)
+    {
+        DocumentPtr library = createDocument();
+        XmlReadOptions xiReadOptions = readOptions ? *readOptions : XmlReadOptions();
+        xiReadOptions.parentXIncludes.push_back(filenames[index]);
+        readXIncludeFunction(library, filenames[index], includeSearchPath, &xiReadOptions);
+        libraries[index] = library;
+    };
+    bool parallelXIncludeEnable = readOptions && readOptions->parallelXIncludeEnable;
+    parallelFor(filenames.size(), readXInclude, parallelXIncludeEnable ? 0 : 1);
+
+    // Import the library documents in order.
+    for (DocumentPtr library : libraries)
+    {
+        doc->importLibrary(library, readOptions);
+    }
 }
 
 void documentFromXml(DocumentPtr doc,
@@ -228,8 +255,10 @@ void documentFromXml(DocumentPtr doc,
     xml_node xmlRoot = xmlDoc.child(Document::CATEGORY.c_str());
     if (xmlRoot)
     {
+        ScopedBatchEdit batch(doc);
         processXIncludes(doc, xmlRoot, searchPath, readOptions);
         elementFromXml(xmlRoot, doc, readOptions);
+        batch.commit();
     }
 
     doc->upgradeVersion();
@@ -237,12 +266,27 @@ void documentFromXml(DocumentPtr doc,
 
 } // anonymous namespace
 
+//
+// XmlElementInfo methods
+//
+
+bool XmlElementInfo::hasAttribute(const string& attrib) const
+{
+    return !_xmlNode.attribute(attrib.c_str()).empty();
+}
+
+string XmlElementInfo::getAttribute(const string& attrib) const
+{
+    return _xmlNode.attribute(attrib.c_str()).value();
+}
+
 //
 // XmlReadOptions methods
 //
 
 XmlReadOptions::XmlReadOptions() :
-    readXIncludeFunction(readFromXmlFile)
+    readXIncludeFunction(readFromXmlFile),
+    parallelXIncludeEnable(false)
 {
 }
 
@@ -285,8 +329,9 @@ void readFromXmlStream(DocumentPtr doc, std::istream& stream, const XmlReadOptio
 
 void readFromXmlFile(DocumentPtr doc, const string& filename, const string& searchPath, const XmlReadOptions* readOptions)
 {
+    MappedFile mappedFile;
     xml_document xmlDoc;
-    xmlDocumentFromFile(xmlDoc, filename, searchPath);
+    xmlDocumentFromFile(xmlDoc, mappedFile, filename, searchPath);
 
     // This must be done before parsing the XML as the source URI
     // is used for searching for include files.
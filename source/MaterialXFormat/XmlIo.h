@@ -13,10 +13,16 @@
 
 #include <MaterialXCore/Document.h>
 
+namespace pugi
+{
+class xml_node;
+}
+
 namespace MaterialX
 {
 
 class XmlReadOptions;
+class XmlElementInfo;
 
 extern const string MTLX_EXTENSION;
 
@@ -24,6 +30,50 @@ extern const string MTLX_EXTENSION;
 /// optional search path and read options.
 using XmlReadFunction = std::function<void(DocumentPtr, string, string, const XmlReadOptions*)>;
 
+/// A function that returns true if the given XML element is to be read into
+/// a document.
+using XmlElementPredicate = std::function<bool(const XmlElementInfo&)>;
+
+/// @class XmlElementInfo
+/// The category, name and attributes of an XML element that has been parsed
+/// but not yet read into a document, as given to the element predicate of
+/// XmlReadOptions.  An instance is only valid for the duration of the call.
+class XmlElementInfo
+{
+  public:
+    XmlElementInfo(const string& category, const string& name, const pugi::xml_node& xmlNode) :
+        _category(category),
+        _name(name),
+        _xmlNode(xmlNode)
+    {
+    }
+    ~XmlElementInfo() { }
+
+    /// Return the category of the element.
+    const string& getCategory() const
+    {
+        return _category;
+    }
+
+    /// Return the name of the element.
+    const string& getName() const
+    {
+        return _name;
+    }
+
+    /// Return true if the element has the given attribute.
+    bool hasAttribute(const string& attrib) const;
+
+    /// Return the value string of the given attribute.  If the attribute is
+    /// not present, then an empty string is returned.
+    string getAttribute(const string& attrib) const;
+
+  private:
+    const string& _category;
+    const string& _name;
+    const pugi::xml_node& _xmlNode;
+};
+
 /// @class XmlReadOptions
 /// A set of options for controlling the behavior of XML read functions.
 class XmlReadOptions : public CopyOptions
@@ -39,6 +89,23 @@ class XmlReadOptions : public CopyOptions
     /// The vector of parent XIncludes at the scope of the current document.
     /// Defaults to an empty vector.
     StringVec parentXIncludes;
+
+    /// If true, then the XInclude references at each scope of the document
+    /// are read concurrently into separate documents, which are then imported
+    /// in document order, giving the same results as a serial read.  When
+    /// enabled, the readXIncludeFunction must be safe to call from multiple
+    /// threads.  Defaults to false.
+    bool parallelXIncludeEnable;
+
+    /// If provided, this function will be used to exclude specific elements
+    /// (those returning false) from the read operation, including the content
+    /// of included documents.  The function is called before each element
+    /// is added to the document, with the category, name and attributes
+    /// read from XML.  Filtering is applied as the parsed XML is converted
+    /// into MaterialX elements, so the XML of excluded elements is still
+    /// parsed, but no elements are constructed for them or their children.
+    /// Defaults to nullptr.
+    XmlElementPredicate elementPredicate;
 };
 
 /// @class XmlWriteOptions
@@ -37,6 +37,9 @@
 #include <MaterialXGenShader/Nodes/BlurNode.h>
 #include <MaterialXGenShader/Nodes/HwImageNode.h>
 
+#include <algorithm>
+#include <set>
+
 namespace MaterialX
 {
 
@@ -44,6 +47,66 @@ const string GlslShaderGenerator::LANGUAGE = "genglsl";
 const string GlslShaderGenerator::TARGET = "glsl400";
 const string GlslShaderGenerator::VERSION = "400";
 
+namespace
+{
+
+// Return the std140 base alignment and size in bytes of a variable, and the
+// stride between its array elements or matrix columns. Returns false if the
+// variable cannot be stored in a uniform buffer.
+bool getStd140Placement(const ShaderPort* variable, size_t& alignment, size_t& size, size_t& stride)
+{
+    const TypeDesc* type = variable->getType();
+    if (type->getBaseType() != TypeDesc::BASETYPE_FLOAT &&
+        type->getBaseType() != TypeDesc::BASETYPE_INTEGER &&
+        type->getBaseType() != TypeDesc::BASETYPE_BOOLEAN)
+    {
+        return false;
+    }
+
+    stride = 0;
+    if (type->isArray())
+    {
+        ValuePtr value = variable->getValue();
+        size_t count = 0;
+        if (value && value->isA<vector<float>>())
+        {
+            count = value->asA<vector<float>>().size();
+        }
+        else if (value && value->isA<vector<int>>())
+        {
+            count = value->asA<vector<int>>().size();
+        }
+        if (!count)
+        {
+            return false;
+        }
+        alignment = stride = 16;
+        size = count * stride;
+    }
+    else if (type == Type::MATRIX33 || type == Type::MATRIX44)
+    {
+        alignment = stride = 16;
+        size = (type == Type::MATRIX33 ? 3 : 4) * stride;
+    }
+    else if (type->getSize() <= 4)
+    {
+        size = type->getSize() * 4;
+        alignment = type->getSize() == 3 ? 16 : size;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+size_t alignOffset(size_t offset, size_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+} // anonymous namespace
+
 //
 // GlslShaderGenerator methods
 //
@@ -264,9 +327,42 @@ GlslShaderGenerator::GlslShaderGenerator() :
 
 ShaderPtr GlslShaderGenerator::generate(const string& name, ElementPtr element, GenContext& context) const
 {
+    MATERIALX_GEN_PROFILE_SCOPE(context, "generate");
+
     resetIdentifiers(context);
     ShaderPtr shader = createShader(name, element, context);
 
+    if (context.getOptions().hwUniformBuffers)
+    {
+        // Uniform blocks with the same name are linked into the same buffer,
+        // so give them the same members in both stages before computing
+        // their layouts.
+        ShaderStage& vs = shader->getStage(Stage::VERTEX);
+        ShaderStage& ps = shader->getStage(Stage::PIXEL);
+        for (const string& blockName : { HW::PRIVATE_UNIFORMS, HW::PUBLIC_UNIFORMS })
+        {
+            VariableBlock& vsBlock = vs.getUniformBlock(blockName);
+            VariableBlock& psBlock = ps.getUniformBlock(blockName);
+            size_t alignment, size, stride;
+            for (ShaderPort* variable : vector<ShaderPort*>(vsBlock.getVariableOrder()))
+            {
+                if (getStd140Placement(variable, alignment, size, stride))
+                {
+                    psBlock.add(variable->getSelf());
+                }
+            }
+            for (ShaderPort* variable : vector<ShaderPort*>(psBlock.getVariableOrder()))
+            {
+                if (getStd140Placement(variable, alignment, size, stride))
+                {
+                    vsBlock.add(variable->getSelf());
+                }
+            }
+            computeUniformBufferLayout(vsBlock);
+            computeUniformBufferLayout(psBlock);
+        }
+    }
+
     // Turn on fixed float formatting to make sure float values are
     // emitted with a decimal point and not as integers, and to avoid
     // any scientific notation which isn't supported by all OpenGL targets.
@@ -275,18 +371,21 @@ ShaderPtr GlslShaderGenerator::generate(const string& name, ElementPtr element,
     // Emit code for vertex shader stage
     ShaderStage& vs = shader->getStage(Stage::VERTEX);
     emitVertexStage(shader->getGraph(), context, vs);
-    replaceTokens(_tokenSubstitutions, vs);
+    replaceTokens(getTokenTable(), vs);
 
     // Emit code for pixel shader stage
     ShaderStage& ps = shader->getStage(Stage::PIXEL);
     emitPixelStage(shader->getGraph(), context, ps);
-    replaceTokens(_tokenSubstitutions, ps);
+    replaceTokens(getTokenTable(), ps);
+    MATERIALX_GEN_PROFILE_COUNT(context, "bytesEmitted", vs.getSourceCode().size() + ps.getSourceCode().size());
 
     return shader;
 }
 
 void GlslShaderGenerator::emitVertexStage(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const
 {
+    MATERIALX_GEN_PROFILE_SCOPE(context, "emitVertexStage");
+
     // Add version directive
     emitLine("#version " + getVersion(), stage, false);
     emitLineBreak(stage);
@@ -305,9 +404,7 @@ void GlslShaderGenerator::emitVertexStage(const ShaderGraph& graph, GenContext&
         const VariableBlock& uniforms = *it.second;
         if (!uniforms.empty())
         {
-            emitComment("Uniform block: " + uniforms.getName(), stage);
-            emitVariableDeclarations(uniforms, _syntax->getUniformQualifier(), SEMICOLON, context, stage);
-            emitLineBreak(stage);
+            emitUniformBlock(uniforms, context, stage);
         }
     }
 
@@ -346,6 +443,84 @@ void GlslShaderGenerator::emitVertexStage(const ShaderGraph& graph, GenContext&
     emitLineBreak(stage);
 }
 
+void GlslShaderGenerator::emitUniformBlock(const VariableBlock& uniforms, GenContext& context, ShaderStage& stage) const
+{
+    emitComment("Uniform block: " + uniforms.getName(), stage);
+    if (!uniforms.hasBufferLayout())
+    {
+        emitVariableDeclarations(uniforms, _syntax->getUniformQualifier(), SEMICOLON, context, stage);
+        emitLineBreak(stage);
+        return;
+    }
+
+    // Declare the buffer members in layout order. The block has no instance
+    // name, so members are accessed by their variable names as usual.
+    std::set<const ShaderPort*> buffered;
+    emitLine("layout (std140) uniform " + uniforms.getName(), stage, false);
+    emitScopeBegin(stage);
+    for (const VariableBlock::BufferEntry& entry : uniforms.getBufferLayout())
+    {
+        emitLineBegin(stage);
+        emitVariableDeclaration(entry.variable, EMPTY_STRING, context, stage, false);
+        emitString(SEMICOLON, stage);
+        emitLineEnd(stage, false);
+        buffered.insert(entry.variable);
+    }
+    emitScopeEnd(stage, true);
+
+    // Declare the remaining members as individual uniforms.
+    for (const ShaderPort* variable : uniforms.getVariableOrder())
+    {
+        if (!buffered.count(variable))
+        {
+            emitLineBegin(stage);
+            emitVariableDeclaration(variable, _syntax->getUniformQualifier(), context, stage);
+            emitString(SEMICOLON, stage);
+            emitLineEnd(stage, false);
+        }
+    }
+    emitLineBreak(stage);
+}
+
+void GlslShaderGenerator::computeUniformBufferLayout(VariableBlock& block)
+{
+    struct Member
+    {
+        ShaderPort* variable;
+        size_t alignment;
+        size_t size;
+        size_t stride;
+    };
+
+    vector<Member> members;
+    for (ShaderPort* variable : block.getVariableOrder())
+    {
+        Member member = { variable, 0, 0, 0 };
+        if (getStd140Placement(variable, member.alignment, member.size, member.stride))
+        {
+            members.push_back(member);
+        }
+    }
+    std::sort(members.begin(), members.end(), [](const Member& a, const Member& b)
+    {
+        if (a.alignment != b.alignment)
+        {
+            return a.alignment > b.alignment;
+        }
+        return a.variable->getName() < b.variable->getName();
+    });
+
+    vector<VariableBlock::BufferEntry> layout;
+    size_t offset = 0;
+    for (const Member& member : members)
+    {
+        offset = alignOffset(offset, member.alignment);
+        layout.push_back({ member.variable, offset, member.stride });
+        offset += member.size;
+    }
+    block.setBufferLayout(layout, alignOffset(offset, 16));
+}
+
 void GlslShaderGenerator::emitSpecularEnvironment(GenContext& context, ShaderStage& stage) const
 {
     int specularMethod = context.getOptions().hwSpecularEnvironmentMethod;
@@ -370,6 +545,8 @@ void GlslShaderGenerator::emitSpecularEnvironment(GenContext& context, ShaderSta
 
 void GlslShaderGenerator::emitPixelStage(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const
 {
+    MATERIALX_GEN_PROFILE_SCOPE(context, "emitPixelStage");
+
     // Add version directive
     emitLine("#version " + getVersion(), stage, false);
     emitLineBreak(stage);
@@ -397,9 +574,7 @@ void GlslShaderGenerator::emitPixelStage(const ShaderGraph& graph, GenContext& c
         // Skip light uniforms as they are handled separately
         if (!uniforms.empty() && uniforms.getName() != HW::LIGHT_DATA)
         {
-            emitComment("Uniform block: " + uniforms.getName(), stage);
-            emitVariableDeclarations(uniforms, _syntax->getUniformQualifier(), SEMICOLON, context, stage);
-            emitLineBreak(stage);
+            emitUniformBlock(uniforms, context, stage);
         }
     }
 
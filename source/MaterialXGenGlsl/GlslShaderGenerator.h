@@ -36,7 +36,7 @@ class GlslShaderGenerator : public HwShaderGenerator
     const string& getTarget() const override { return TARGET; }
 
     /// Return the version string for the GLSL version this generator is for
-    virtual const string& getVersion() const { return VERSION; }
+    const string& getVersion() const override { return VERSION; }
 
     /// Emit function definitions for all nodes
     void emitFunctionDefinitions(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const override;
@@ -52,6 +52,22 @@ class GlslShaderGenerator : public HwShaderGenerator
     /// the shader generator. The enumeration may be converted to a different type than the input.
     bool remapEnumeration(const ValueElement& input, const string& value, std::pair<const TypeDesc*, ValuePtr>& result) const override;
 
+    /// Compute the buffer layout of a uniform block following the std140
+    /// rules of GLSL, and set it on the block.
+    ///
+    /// Scalars take 4 bytes and are aligned to 4 bytes, two component vectors
+    /// take 8 bytes and are aligned to 8 bytes, and three and four component
+    /// vectors are aligned to 16 bytes.  Matrices are stored as arrays of
+    /// column vectors and array elements are padded to 16 bytes, giving a
+    /// stride of 16 bytes for both.  Members are ordered by decreasing
+    /// alignment and then by name, which keeps padding low and gives the
+    /// same layout for blocks with the same members in different stages.
+    /// The size of the buffer is rounded up to a multiple of 16 bytes.
+    ///
+    /// Samplers, strings and arrays without a value are not stored in the
+    /// buffer, and remain individual uniforms.
+    static void computeUniformBufferLayout(VariableBlock& block);
+
   public:
     /// Unique identifier for the glsl language
     static const string LANGUAGE;
@@ -66,6 +82,10 @@ class GlslShaderGenerator : public HwShaderGenerator
     virtual void emitVertexStage(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const;
     virtual void emitPixelStage(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const;
 
+    /// Emit the declarations of a uniform block, as a uniform buffer if
+    /// the block has a buffer layout and as individual uniforms otherwise.
+    virtual void emitUniformBlock(const VariableBlock& uniforms, GenContext& context, ShaderStage& stage) const;
+
     /// Emit specular environment lookup code
     void emitSpecularEnvironment(GenContext& context, ShaderStage& stage) const;
 
@@ -62,8 +62,8 @@ void LightCompoundNodeGlsl::createVariables(const ShaderNode&, GenContext& conte
     // Create all light uniforms
     for (size_t i = 0; i<_lightUniforms.size(); ++i)
     {
-        ShaderPort* u = const_cast<ShaderPort*>(_lightUniforms[i]);
-        lightData.add(u->getSelf());
+        const ShaderPort* u = _lightUniforms[i];
+        lightData.add(u->getType(), u->getName());
     }
 
     // Create uniform for number of active light sources
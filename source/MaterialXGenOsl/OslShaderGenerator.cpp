@@ -171,6 +171,8 @@ OslShaderGenerator::OslShaderGenerator() :
 
 ShaderPtr OslShaderGenerator::generate(const string& name, ElementPtr element, GenContext& context) const
 {
+    MATERIALX_GEN_PROFILE_SCOPE(context, "generate");
+
     resetIdentifiers(context);
     ShaderPtr shader = createShader(name, element, context);
 
@@ -276,15 +278,18 @@ ShaderPtr OslShaderGenerator::generate(const string& name, ElementPtr element, G
     emitScopeEnd(stage);
 
     // Perform token substitution
-    replaceTokens(_tokenSubstitutions, stage);
+    replaceTokens(getTokenTable(), stage);
+    MATERIALX_GEN_PROFILE_COUNT(context, "bytesEmitted", stage.getSourceCode().size());
 
     return shader;
 }
 
 ShaderPtr OslShaderGenerator::createShader(const string& name, ElementPtr element, GenContext& context) const
 {
+    MATERIALX_GEN_PROFILE_SCOPE(context, "createShader");
+
     // Create the root shader graph
-    ShaderGraphPtr graph = ShaderGraph::create(nullptr, name, element, context);
+    ShaderGraphPtr graph = createShaderGraph(name, element, context);
     ShaderPtr shader = std::make_shared<Shader>(name, graph);
 
     // Create our stage.
@@ -61,7 +61,7 @@ ShaderNodePtr ColorManagementSystem::createNode(const ShaderGraph* parent, const
     {
         nodeImpl = SourceCodeNode::create();
         nodeImpl->initialize(*impl, context);
-        context.addNodeImplementation(implName, nodeImpl);
+        nodeImpl = context.addNodeImplementation(implName, nodeImpl);
     }
 
     // Create the node.
@@ -15,7 +15,9 @@ namespace MaterialX
 
 GenContext::GenContext(ShaderGeneratorPtr sg) :
     _sg(sg),
-    _identifierIndex(0)
+    _sourceCache(SourceCache::create()),
+    _identifierIndex(0),
+    _nodeImpls(std::make_shared<NodeImplCache>())
 {
     if (!_sg)
     {
@@ -24,6 +26,27 @@ GenContext::GenContext(ShaderGeneratorPtr sg) :
     _sg->resetIdentifiers(*this);
 }
 
+GenContext GenContext::fork() const
+{
+    GenContext context(*this);
+    context._inputSuffix.clear();
+    context._outputSuffix.clear();
+    _sg->resetIdentifiers(context);
+    return context;
+}
+
+ConstSourceFilePtr GenContext::getSourceFile(const FilePath& filename) const
+{
+#ifdef MATERIALX_GEN_PROFILING
+    const size_t readCount = _sourceCache->getReadCount();
+    ConstSourceFilePtr file = _sourceCache->getSourceFile(resolveSourceFile(filename), _sg->getSyntax());
+    MATERIALX_GEN_PROFILE_COUNT(*this, "filesRead", _sourceCache->getReadCount() - readCount);
+    return file;
+#else
+    return _sourceCache->getSourceFile(resolveSourceFile(filename), _sg->getSyntax());
+#endif
+}
+
 void GenContext::addIdentifier(const string& name)
 {
     if (name.empty())
@@ -57,20 +80,23 @@ void GenContext::clearIdentifiers()
     _identifierIndex = 0;
 }
 
-void GenContext::addNodeImplementation(const string& name, ShaderNodeImplPtr impl)
+ShaderNodeImplPtr GenContext::addNodeImplementation(const string& name, ShaderNodeImplPtr impl)
 {
-    _nodeImpls[name] = impl;
+    std::lock_guard<std::mutex> guard(_nodeImpls->mutex);
+    return _nodeImpls->impls.insert(std::make_pair(name, impl)).first->second;
 }
 
 ShaderNodeImplPtr GenContext::findNodeImplementation(const string& name)
 {
-    auto it = _nodeImpls.find(name);
-    return it != _nodeImpls.end() ? it->second : nullptr;
+    std::lock_guard<std::mutex> guard(_nodeImpls->mutex);
+    auto it = _nodeImpls->impls.find(name);
+    return it != _nodeImpls->impls.end() ? it->second : nullptr;
 }
 
 void GenContext::clearNodeImplementations()
 {
-    _nodeImpls.clear();
+    _nodeImpls = std::make_shared<NodeImplCache>();
+    _sourceCache->clear();
 }
 
 void GenContext::clearUserData()
@@ -12,10 +12,14 @@
 #include <MaterialXGenShader/Library.h>
 
 #include <MaterialXGenShader/GenOptions.h>
+#include <MaterialXGenShader/GenProfiler.h>
 #include <MaterialXGenShader/ShaderNode.h>
+#include <MaterialXGenShader/SourceCache.h>
 
 #include <MaterialXFormat/File.h>
 
+#include <mutex>
+
 namespace MaterialX
 {
 
@@ -65,18 +69,42 @@ class GenUserData : public std::enable_shared_from_this<GenUserData>
 /// @class GenContext 
 /// A context class for shader generation.
 /// Used for thread local storage of data needed during shader generation.
+///
+/// A context may not be used by multiple threads at once, but may be forked
+/// into child contexts for use by separate threads.  All forks and copies of
+/// a context share its cache of shader node implementations, which are
+/// immutable once created, so implementations added through any of them are
+/// visible to all.  Call clearNodeImplementations to give a context a cache
+/// of its own.
 class GenContext
 {
   public:
     /// Constructor.
     GenContext(ShaderGeneratorPtr sg);
 
+    /// Return a new context for shader generation on a separate thread.
+    /// The new context has the same shader generator, options, source code
+    /// search path and user data as this context, and shares its cache of
+    /// shader node implementations.  It has its own set of identifiers and
+    /// input and output suffixes.
+    ///
+    /// User data is shared rather than copied, so user data objects should
+    /// not be modified while forked contexts are in use, and this context
+    /// should only be read while forked contexts are in use.
+    GenContext fork() const;
+
     /// Return shader generatior.
     ShaderGenerator& getShaderGenerator()
     {
         return *_sg;
     }
 
+    /// Return shader generatior.
+    const ShaderGenerator& getShaderGenerator() const
+    {
+        return *_sg;
+    }
+
     /// Return shader generation options.
     GenOptions& getOptions()
     {
@@ -110,7 +138,40 @@ class GenContext
     /// Resolve a file using the registered search paths.
     FilePath resolveSourceFile(const FilePath& filename) const
     {
-        return _sourceCodeSearchPath.find(filename);
+        return _sourceCache->resolve(filename, _sourceCodeSearchPath);
+    }
+
+    /// Resolve a file using the registered search paths, and return it as
+    /// parsed by the source cache, or nullptr if the file could not be read.
+    ConstSourceFilePtr getSourceFile(const FilePath& filename) const;
+
+    /// Set the cache used for resolving and reading source files.  Defaults
+    /// to a new cache for this context, which is shared with its forks.  The
+    /// process-wide cache returned by SourceCache::getGlobal may be set to
+    /// share source files and implementations between unrelated contexts.
+    void setSourceCache(SourceCachePtr cache)
+    {
+        _sourceCache = cache;
+    }
+
+    /// Return the cache used for resolving and reading source files.
+    SourceCachePtr getSourceCache() const
+    {
+        return _sourceCache;
+    }
+
+    /// Set the profiler recording the phases of shader generation, shared by
+    /// this context and its subsequent forks.  Profiling is only recorded
+    /// when MaterialX is built with the MATERIALX_GEN_PROFILING option.
+    void setProfiler(GenProfilerPtr profiler)
+    {
+        _profiler = profiler;
+    }
+
+    /// Return the profiler of this context, or nullptr if none has been set.
+    GenProfilerPtr getProfiler() const
+    {
+        return _profiler;
     }
 
     /// Add the given name to the list of unique identifiers in use.
@@ -123,14 +184,21 @@ class GenContext
     /// Clear all identifiers in use.
     void clearIdentifiers();
 
-    /// Cache a shader node implementation.
-    void addNodeImplementation(const string& name, ShaderNodeImplPtr impl);
+    /// Cache a shader node implementation, making it available to this
+    /// context and all of its forks.  If an implementation with the given
+    /// name was already cached, then the existing implementation is kept
+    /// and returned.
+    ShaderNodeImplPtr addNodeImplementation(const string& name, ShaderNodeImplPtr impl);
 
     /// Find and return a cached shader node implementation,
     /// or return nullptr if no implementation is found.
     ShaderNodeImplPtr findNodeImplementation(const string& name);
 
-    /// Clear all cached shader node implementation.
+    /// Clear all cached shader node implementation, along with the source
+    /// files, resolved paths and implementations held by the source cache,
+    /// so that edits to source files on disk are picked up.  Existing forks
+    /// of this context keep their shared implementation cache, but share
+    /// the cleared source cache.
     void clearNodeImplementations();
 
     /// Add user data to the context to make it
@@ -208,12 +276,23 @@ class GenContext
     // Search path for finding source files.
     FileSearchPath _sourceCodeSearchPath;
 
+    // Cache of resolved and parsed source files.
+    SourceCachePtr _sourceCache;
+
+    // Profiler of shader generation phases.
+    GenProfilerPtr _profiler;
+
     // Set of unique identifier names.
     StringSet _identifiers;
     size_t _identifierIndex;
 
-    // Cached shader node implementations.
-    std::unordered_map<string, ShaderNodeImplPtr> _nodeImpls;
+    // Cached shader node implementations, shared with forked contexts.
+    struct NodeImplCache
+    {
+        std::mutex mutex;
+        std::unordered_map<string, ShaderNodeImplPtr> impls;
+    };
+    std::shared_ptr<NodeImplCache> _nodeImpls;
 
     // User data
     std::unordered_map<string, vector<GenUserDataPtr>> _userData;
@@ -14,7 +14,9 @@ GenOptions::GenOptions() :
     hwTransparency(false),
     hwSpecularEnvironmentMethod(SPECULAR_ENVIRONMENT_FIS),
     hwMaxActiveLightSources(3),
-    hwNormalizeUdimTexCoords(false)
+    hwNormalizeUdimTexCoords(false),
+    hwUniformBuffers(false),
+    optimizeGraphExpressions(false)
 {
 }
 GenOptions::~GenOptions()
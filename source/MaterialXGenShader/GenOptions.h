@@ -93,6 +93,23 @@ class GenOptions
     /// compress a set of UDIMs into a single normalized image for
     /// hardware rendering.
     bool hwNormalizeUdimTexCoords;
+
+    /// Sets whether the public and private uniform blocks of HW shaders
+    /// are emitted as uniform buffers, with their members packed in a
+    /// computed layout, rather than as individual uniforms. Samplers and
+    /// other opaque types remain individual uniforms.
+    /// By default this option is false.
+    bool hwUniformBuffers;
+
+    /// If true the shader graph is further optimized by folding math nodes
+    /// with constant inputs into values, and by merging nodes that compute
+    /// the same expression from the same inputs. Inputs that are published
+    /// as editable uniforms are not considered constant, so the optimization
+    /// mainly takes effect with the reduced shader interface type.
+    /// Nodes are also ordered by name where their topological order leaves
+    /// a choice, so that generated code does not depend on node addresses.
+    /// By default this option is false.
+    bool optimizeGraphExpressions;
 };
 
 } // namespace MaterialX
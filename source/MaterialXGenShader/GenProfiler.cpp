@@ -0,0 +1,268 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/GenProfiler.h>
+
+#include <MaterialXGenShader/GenContext.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace MaterialX
+{
+
+const size_t GenProfiler::npos = std::numeric_limits<size_t>::max();
+
+namespace {
+
+// Return the given string as a quoted JSON string.
+string quoteJson(const string& str)
+{
+    std::ostringstream stream;
+    stream << '"';
+    for (char c : str)
+    {
+        switch (c)
+        {
+            case '"': stream << "\\\""; break;
+            case '\\': stream << "\\\\"; break;
+            case '\n': stream << "\\n"; break;
+            case '\t': stream << "\\t"; break;
+            default:
+                if ((unsigned char) c < 0x20)
+                {
+                    stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int) c << std::dec;
+                }
+                else
+                {
+                    stream << c;
+                }
+        }
+    }
+    stream << '"';
+    return stream.str();
+}
+
+// Scopes combined by name and enclosing scopes.
+struct ScopeSummary
+{
+    string name;
+    size_t calls;
+    double time;
+    vector<size_t> children;
+};
+
+void writeSummary(const vector<ScopeSummary>& summaries, size_t index, const string& indent, std::ostream& stream)
+{
+    const ScopeSummary& summary = summaries[index];
+    stream << indent << "{ \"name\": " << quoteJson(summary.name) <<
+        ", \"calls\": " << summary.calls <<
+        ", \"time\": " << summary.time / 1000.0;
+    if (!summary.children.empty())
+    {
+        stream << ", \"children\": [\n";
+        for (size_t i = 0; i < summary.children.size(); i++)
+        {
+            writeSummary(summaries, summary.children[i], indent + "  ", stream);
+            stream << (i + 1 < summary.children.size() ? ",\n" : "\n");
+        }
+        stream << indent << "]";
+    }
+    stream << " }";
+}
+
+} // anonymous namespace
+
+//
+// GenProfiler methods
+//
+
+GenProfiler::GenProfiler() :
+    _origin(std::chrono::steady_clock::now())
+{
+}
+
+double GenProfiler::getTime() const
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - _origin).count();
+}
+
+size_t GenProfiler::beginScope(const string& name)
+{
+    const std::thread::id threadId = std::this_thread::get_id();
+    const double start = getTime();
+
+    std::lock_guard<std::mutex> guard(_mutex);
+    auto thread = _threads.insert(std::make_pair(threadId, _threads.size())).first;
+    vector<size_t>& activeScopes = _activeScopes[threadId];
+    const size_t index = _scopes.size();
+    _scopes.push_back({ name, activeScopes.empty() ? npos : activeScopes.back(), thread->second, start, -1.0 });
+    activeScopes.push_back(index);
+    return index;
+}
+
+void GenProfiler::endScope(size_t index)
+{
+    const double end = getTime();
+
+    std::lock_guard<std::mutex> guard(_mutex);
+    vector<size_t>& activeScopes = _activeScopes[std::this_thread::get_id()];
+    auto it = std::find(activeScopes.begin(), activeScopes.end(), index);
+    if (it != activeScopes.end())
+    {
+        activeScopes.erase(it);
+        _scopes[index].duration = end - _scopes[index].start;
+    }
+}
+
+void GenProfiler::addCount(const string& name, uint64_t value)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _counters[name] += value;
+}
+
+vector<GenProfiler::Scope> GenProfiler::getScopes() const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _scopes;
+}
+
+GenProfiler::CounterMap GenProfiler::getCounters() const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _counters;
+}
+
+string GenProfiler::exportJson() const
+{
+    const vector<Scope> scopes = getScopes();
+    const CounterMap counters = getCounters();
+
+    // Combine the scopes into a tree of summaries, with the root summary
+    // holding the outermost scopes.  Enclosing scopes always precede the
+    // scopes within them.
+    vector<ScopeSummary> summaries(1, { EMPTY_STRING, 0, 0.0, {} });
+    vector<size_t> summaryIndices(scopes.size(), npos);
+    for (size_t i = 0; i < scopes.size(); i++)
+    {
+        const Scope& scope = scopes[i];
+        const size_t parent = scope.parent != npos ? summaryIndices[scope.parent] : 0;
+        if (scope.duration < 0.0 || parent == npos)
+        {
+            continue;
+        }
+
+        size_t index = npos;
+        for (size_t child : summaries[parent].children)
+        {
+            if (summaries[child].name == scope.name)
+            {
+                index = child;
+                break;
+            }
+        }
+        if (index == npos)
+        {
+            index = summaries.size();
+            summaries[parent].children.push_back(index);
+            summaries.push_back({ scope.name, 0, 0.0, {} });
+        }
+        summaries[index].calls++;
+        summaries[index].time += scope.duration;
+        summaryIndices[i] = index;
+    }
+
+    std::ostringstream stream;
+    stream << "{\n\"scopes\": [\n";
+    const vector<size_t>& roots = summaries[0].children;
+    for (size_t i = 0; i < roots.size(); i++)
+    {
+        writeSummary(summaries, roots[i], "  ", stream);
+        stream << (i + 1 < roots.size() ? ",\n" : "\n");
+    }
+    stream << "],\n\"counters\": {";
+    string separator = "\n";
+    for (const auto& counter : counters)
+    {
+        stream << separator << "  " << quoteJson(counter.first) << ": " << counter.second;
+        separator = ",\n";
+    }
+    stream << "\n}\n}\n";
+    return stream.str();
+}
+
+string GenProfiler::exportChromeTrace() const
+{
+    const vector<Scope> scopes = getScopes();
+    const CounterMap counters = getCounters();
+
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"traceEvents\": [\n";
+    string separator;
+    double end = 0.0;
+    for (const Scope& scope : scopes)
+    {
+        if (scope.duration < 0.0)
+        {
+            continue;
+        }
+        stream << separator << "{\"name\": " << quoteJson(scope.name) <<
+            ", \"ph\": \"X\", \"pid\": 0, \"tid\": " << scope.thread <<
+            ", \"ts\": " << scope.start << ", \"dur\": " << scope.duration << "}";
+        separator = ",\n";
+        end = std::max(end, scope.start + scope.duration);
+    }
+
+    // Counters are given as a single counter event at the end of the trace.
+    if (!counters.empty())
+    {
+        stream << separator << "{\"name\": \"counters\", \"ph\": \"C\", \"pid\": 0, \"tid\": 0, \"ts\": " << end << ", \"args\": {";
+        separator = EMPTY_STRING;
+        for (const auto& counter : counters)
+        {
+            stream << separator << quoteJson(counter.first) << ": " << counter.second;
+            separator = ", ";
+        }
+        stream << "}}";
+    }
+    stream << "\n]}\n";
+    return stream.str();
+}
+
+void GenProfiler::clear()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _scopes.clear();
+    _counters.clear();
+    _threads.clear();
+    _activeScopes.clear();
+}
+
+//
+// GenProfileScope methods
+//
+
+GenProfileScope::GenProfileScope(const GenContext& context, const string& name) :
+    _profiler(context.getProfiler().get()),
+    _index(0)
+{
+    if (_profiler)
+    {
+        _index = _profiler->beginScope(name);
+    }
+}
+
+GenProfileScope::~GenProfileScope()
+{
+    if (_profiler)
+    {
+        _profiler->endScope(_index);
+    }
+}
+
+} // namespace MaterialX
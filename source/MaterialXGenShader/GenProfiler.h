@@ -0,0 +1,168 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_GENPROFILER_H
+#define MATERIALX_GENPROFILER_H
+
+/// @file
+/// Profiling of shader generation
+
+#include <MaterialXGenShader/Library.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace MaterialX
+{
+
+class GenProfiler;
+
+/// Shared pointer to a GenProfiler
+using GenProfilerPtr = shared_ptr<GenProfiler>;
+
+/// @class GenProfiler
+/// A thread-safe recorder of timed scopes and counters for shader generation.
+///
+/// A profiler is attached to a context with GenContext::setProfiler, and is
+/// shared by all forks of the context.  Shader generators record the phases
+/// of generation as nested scopes, and count the nodes created, node
+/// implementations resolved, source files read and bytes of code emitted,
+/// along with the nodes created for each node type.
+///
+/// Shader generators record to the profiler through the
+/// MATERIALX_GEN_PROFILE_SCOPE and MATERIALX_GEN_PROFILE_COUNT macros, which
+/// compile to nothing unless MaterialX is built with the
+/// MATERIALX_GEN_PROFILING option.
+class GenProfiler
+{
+  public:
+    /// A timed scope, with times given in microseconds from the creation
+    /// of the profiler.
+    struct Scope
+    {
+        /// The name of the scope.
+        string name;
+
+        /// The index of the enclosing scope, or npos for outermost scopes.
+        size_t parent;
+
+        /// The index of the thread that recorded the scope.
+        size_t thread;
+
+        /// The time at which the scope began.
+        double start;
+
+        /// The duration of the scope, or a negative value while the scope
+        /// has not yet ended.
+        double duration;
+    };
+
+    /// A map from counter names to their values.
+    using CounterMap = std::map<string, uint64_t>;
+
+  public:
+    GenProfiler();
+    ~GenProfiler() { }
+
+    /// Create and return a new profiler.
+    static GenProfilerPtr create()
+    {
+        return std::make_shared<GenProfiler>();
+    }
+
+    /// Begin a scope with the given name on the calling thread, nested
+    /// within the innermost scope of the thread, and return its index.
+    size_t beginScope(const string& name);
+
+    /// End the scope with the given index, which should be the innermost
+    /// scope of the calling thread.  Scopes that are not active on the
+    /// calling thread are ignored.
+    void endScope(size_t index);
+
+    /// Add the given value to the counter with the given name.
+    void addCount(const string& name, uint64_t value = 1);
+
+    /// Return all scopes recorded, in the order in which they began.
+    vector<Scope> getScopes() const;
+
+    /// Return the values of all counters.
+    CounterMap getCounters() const;
+
+    /// Return the recorded scopes and counters in JSON format.  Scopes with
+    /// the same name and the same enclosing scopes are combined, giving
+    /// their number of calls and their total time in milliseconds.
+    string exportJson() const;
+
+    /// Return the recorded scopes and counters in the Chrome trace event
+    /// format, which can be viewed in chrome://tracing.
+    string exportChromeTrace() const;
+
+    /// Remove all recorded scopes and counters.  No scopes may be active.
+    void clear();
+
+    /// The index of a scope without an enclosing scope.
+    static const size_t npos;
+
+  private:
+    double getTime() const;
+
+  private:
+    std::chrono::steady_clock::time_point _origin;
+    vector<Scope> _scopes;
+    CounterMap _counters;
+    std::map<std::thread::id, size_t> _threads;
+    std::map<std::thread::id, vector<size_t>> _activeScopes;
+    mutable std::mutex _mutex;
+};
+
+/// @class GenProfileScope
+/// A scope recorded by the profiler of a context, if any, from the
+/// construction to the destruction of this object.
+class GenProfileScope
+{
+  public:
+    GenProfileScope(const GenContext& context, const string& name);
+    ~GenProfileScope();
+
+  private:
+    GenProfiler* _profiler;
+    size_t _index;
+};
+
+#ifdef MATERIALX_GEN_PROFILING
+
+#define MATERIALX_GEN_PROFILE_CONCAT_IMPL(a, b) a##b
+#define MATERIALX_GEN_PROFILE_CONCAT(a, b) MATERIALX_GEN_PROFILE_CONCAT_IMPL(a, b)
+
+/// Record a scope with the given name until the end of the enclosing block,
+/// if the given context has a profiler.
+#define MATERIALX_GEN_PROFILE_SCOPE(context, name) \
+    MaterialX::GenProfileScope MATERIALX_GEN_PROFILE_CONCAT(genProfileScope, __LINE__)(context, name)
+
+/// Add the given value to the counter with the given name, if the given
+/// context has a profiler.
+#define MATERIALX_GEN_PROFILE_COUNT(context, name, value)                 \
+    do                                                                     \
+    {                                                                      \
+        MaterialX::GenProfiler* genProfiler = (context).getProfiler().get(); \
+        if (genProfiler)                                                   \
+        {                                                                  \
+            genProfiler->addCount(name, value);                            \
+        }                                                                  \
+    } while (false)
+
+#else
+
+#define MATERIALX_GEN_PROFILE_SCOPE(context, name)
+#define MATERIALX_GEN_PROFILE_COUNT(context, name, value) do { } while (false)
+
+#endif
+
+} // namespace MaterialX
+
+#endif
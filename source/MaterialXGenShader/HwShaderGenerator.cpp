@@ -203,8 +203,10 @@ HwShaderGenerator::HwShaderGenerator(SyntaxPtr syntax) :
 
 ShaderPtr HwShaderGenerator::createShader(const string& name, ElementPtr element, GenContext& context) const
 {
+    MATERIALX_GEN_PROFILE_SCOPE(context, "createShader");
+
     // Create the root shader graph
-    ShaderGraphPtr graph = ShaderGraph::create(nullptr, name, element, context);
+    ShaderGraphPtr graph = createShaderGraph(name, element, context);
     ShaderPtr shader = std::make_shared<Shader>(name, graph);
 
     // Create vertex stage.
@@ -324,12 +326,10 @@ ShaderPtr HwShaderGenerator::createShader(const string& name, ElementPtr element
                     if (!input->getConnection() && input->getType() == Type::FILENAME)
                     {
                         // Create the uniform using the filename type to make this uniform into a texture sampler.
+                        // The input is left unchanged, so that graphs may be shared between shaders, and
+                        // is replaced by the uniform name during code generation.
                         ShaderPort* filename = psPublicUniforms->add(Type::FILENAME, input->getVariable(), input->getValue());
                         filename->setPath(input->getPath());
-
-                        // Assing the uniform name to the input value
-                        // so we can reference it during code generation.
-                        input->setValue(Value::createValue(input->getVariable()));
                     }
                 }
             }
@@ -400,6 +400,16 @@ void HwShaderGenerator::emitFunctionCall(const ShaderNode& node, GenContext& con
     }
 }
 
+string HwShaderGenerator::getUpstreamResult(const ShaderInput* input, GenContext& context) const
+{
+    if (!input->getConnection() && input->getType() == Type::FILENAME &&
+        input->getNode()->hasClassification(ShaderNode::Classification::FILETEXTURE))
+    {
+        return input->getVariable();
+    }
+    return ShaderGenerator::getUpstreamResult(input, context);
+}
+
 void HwShaderGenerator::emitTextureNodes(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const
 {
     // Emit function calls for all texturing nodes
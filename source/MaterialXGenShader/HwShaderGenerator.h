@@ -328,6 +328,11 @@ public:
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage, 
                           bool checkScope = true) const override;
 
+    /// Return the variable name or value of an input, where unconnected
+    /// filename inputs of file texture nodes refer to the texture sampler
+    /// uniforms created for them.
+    string getUpstreamResult(const ShaderInput* input, GenContext& context) const override;
+
     /// Emit code for all texturing nodes.
     virtual void emitTextureNodes(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const;
 
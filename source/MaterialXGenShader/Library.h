@@ -25,6 +25,7 @@ class ShaderOutput;
 class ShaderNodeImpl;
 class GenOptions;
 class GenContext;
+class TokenTable;
 class TypeDesc;
 
 /// A string stream
@@ -36,6 +37,8 @@ using ShaderPtr = shared_ptr<Shader>;
 using ShaderStagePtr = shared_ptr<ShaderStage>;
 /// Shared pointer to a ShaderGenerator
 using ShaderGeneratorPtr = shared_ptr<ShaderGenerator>;
+/// Shared pointer to a ShaderGraph
+using ShaderGraphPtr = shared_ptr<ShaderGraph>;
 /// Shared pointer to a ShaderNodeImpl
 using ShaderNodeImplPtr = shared_ptr<ShaderNodeImpl>;
 /// Shared pointer to a GenContext
@@ -47,7 +47,9 @@ void SourceCodeNode::initialize(const InterfaceElement& element, GenContext& con
     }
     context.getShaderGenerator().getSyntax().makeValidName(_functionName);
 
-    if (!readFile(context.resolveSourceFile(file), _functionSource))
+    // Source files are read and parsed once, and shared by all implementations.
+    _sourceFile = context.getSourceFile(file);
+    if (!_sourceFile)
     {
         throw ExceptionShaderGenError("Can't find source file '" + file.asString() +
                                       "' used by implementation '" + impl.getName() + "'");
@@ -55,22 +57,30 @@ void SourceCodeNode::initialize(const InterfaceElement& element, GenContext& con
 
     if (_inlined)
     {
+        _functionSource = _sourceFile->getContents();
         _functionSource.erase(std::remove(_functionSource.begin(), _functionSource.end(), '\n'), _functionSource.end());
     }
 
-    // Set hash using the function name.
-    // TODO: Could be improved to include the full function signature.
-    _hash = std::hash<string>{}(_functionName);
+    // Set hash using the function name and the source code defining it,
+    // so that only identical function definitions share a hash.
+    const ShaderGenerator& shadergen = context.getShaderGenerator();
+    Hasher hasher;
+    hasher.add(shadergen.getLanguage());
+    hasher.add(shadergen.getTarget());
+    hasher.add(_functionName);
+    hasher.add((uint64_t) _inlined);
+    hasher.add(_sourceFile->getHash());
+    _hash = (size_t) hasher.getValue();
 }
 
 void SourceCodeNode::emitFunctionDefinition(const ShaderNode&, GenContext& context, ShaderStage& stage) const
 {
     BEGIN_SHADER_STAGE(stage, Stage::PIXEL)
         // Emit function definition for non-inlined functions
-        if (!_inlined && !_functionSource.empty())
+        if (!_inlined)
         {
             const ShaderGenerator& shadergen = context.getShaderGenerator();
-            shadergen.emitBlock(_functionSource, context, stage);
+            shadergen.emitSourceFile(_sourceFile, context, stage);
             shadergen.emitLineBreak(stage);
         }
     END_SHADER_STAGE(stage, Stage::PIXEL)
@@ -7,6 +7,7 @@
 #define MATERIALX_SOURCECODENODE_H
 
 #include <MaterialXGenShader/ShaderNodeImpl.h>
+#include <MaterialXGenShader/SourceCache.h>
 
 namespace MaterialX
 {
@@ -29,6 +30,7 @@ protected:
     bool _inlined;
     string _functionName;
     string _functionSource;
+    ConstSourceFilePtr _sourceFile;
 };
 
 } // namespace MaterialX
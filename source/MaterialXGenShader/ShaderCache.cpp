@@ -0,0 +1,564 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/ShaderCache.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/ShaderGenerator.h>
+#include <MaterialXGenShader/SourceCache.h>
+#include <MaterialXGenShader/Util.h>
+
+#include <MaterialXCore/Document.h>
+#include <MaterialXCore/Material.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <unordered_set>
+
+namespace MaterialX
+{
+
+namespace {
+
+const string CACHE_FILE_EXTENSION = "mtlxshader";
+const size_t CACHE_FILE_NAME_LENGTH = 16;
+
+using FileHashFunction = std::function<string(const FilePath&)>;
+
+// Adds the content of an element graph to a hash, along with the node
+// definitions and implementations that it depends upon.  Each element is
+// added at most once.
+class DependencyHasher
+{
+  public:
+    DependencyHasher(Hasher& hasher, GenContext& context, FileHashFunction fileHash) :
+        _hasher(hasher),
+        _context(context),
+        _fileHash(fileHash),
+        _target(context.getShaderGenerator().getTarget()),
+        _language(context.getShaderGenerator().getLanguage())
+    {
+    }
+
+    // Add an element of the shader graph, along with the state it inherits
+    // from its parent and the node definition to which it resolves.
+    void addElement(ConstElementPtr elem)
+    {
+        if (!elem || !visit(elem))
+        {
+            return;
+        }
+        addContent(elem);
+        _hasher.add(elem->getActiveColorSpace());
+        _hasher.add(elem->getActiveFilePrefix());
+
+        ConstElementPtr parent = elem->getParent();
+        if (parent)
+        {
+            addAttributes(parent);
+            ConstNodeGraphPtr graph = parent->asA<NodeGraph>();
+            if (graph)
+            {
+                addDefinition(graph->getNodeDef());
+            }
+        }
+
+        ConstNodePtr node = elem->asA<Node>();
+        if (node)
+        {
+            addDefinition(node->getNodeDef(_target));
+        }
+        ConstShaderRefPtr shaderRef = elem->asA<ShaderRef>();
+        if (shaderRef)
+        {
+            addDefinition(shaderRef->getNodeDef());
+        }
+    }
+
+    // Add a node definition and its implementation for the current target,
+    // recursing into the definitions used by graph implementations.
+    void addDefinition(ConstNodeDefPtr nodeDef)
+    {
+        if (!nodeDef || !visit(nodeDef))
+        {
+            return;
+        }
+        addContent(nodeDef);
+        ElementPtr base = nodeDef->getInheritsFrom();
+        if (base)
+        {
+            addDefinition(base->asA<NodeDef>());
+        }
+
+        InterfaceElementPtr impl = nodeDef->getImplementation(_target, _language);
+        if (!impl || !visit(impl))
+        {
+            return;
+        }
+        addContent(impl);
+
+        ImplementationPtr sourceImpl = impl->asA<Implementation>();
+        if (sourceImpl && !sourceImpl->getFile().empty())
+        {
+            addSourceFile(_context.resolveSourceFile(sourceImpl->getFile()));
+        }
+
+        NodeGraphPtr graph = impl->asA<NodeGraph>();
+        if (graph)
+        {
+            for (NodePtr node : graph->getNodes())
+            {
+                addDefinition(node->getNodeDef(_target));
+            }
+        }
+    }
+
+    // Add the contents of a source file, followed by the files that it
+    // includes.  Each file is added at most once.
+    void addSourceFile(const FilePath& path)
+    {
+        if (!_visitedFiles.insert(path.asString()).second)
+        {
+            return;
+        }
+        _hasher.add(path.asString());
+        _hasher.add(_fileHash(path));
+
+        ConstSourceFilePtr file = _context.getSourceCache()->getSourceFile(path, _context.getShaderGenerator().getSyntax());
+        if (!file)
+        {
+            return;
+        }
+        for (const SourceFile::Line& line : file->getLines())
+        {
+            if (!line.include.empty())
+            {
+                addSourceFile(_context.resolveSourceFile(line.include));
+            }
+        }
+    }
+
+    // Add an element and all of its descendants.
+    void addContent(ConstElementPtr elem)
+    {
+        addAttributes(elem);
+        const vector<ElementPtr>& children = elem->getChildren();
+        _hasher.add((uint64_t) children.size());
+        for (const ElementPtr& child : children)
+        {
+            addContent(child);
+        }
+    }
+
+    // Add the geometric property and type definitions of a document and of
+    // the libraries that it references.
+    void addDocumentDefinitions(ConstDocumentPtr doc)
+    {
+        if (!doc || !visit(doc))
+        {
+            return;
+        }
+        for (GeomPropDefPtr geomPropDef : doc->getGeomPropDefs())
+        {
+            addContent(geomPropDef);
+        }
+        for (TypeDefPtr typeDef : doc->getTypeDefs())
+        {
+            addContent(typeDef);
+        }
+        const vector<ConstDocumentPtr>& libraries = doc->getReferencedLibraries();
+        _hasher.add((uint64_t) libraries.size());
+        for (const ConstDocumentPtr& library : libraries)
+        {
+            addDocumentDefinitions(library);
+        }
+    }
+
+  private:
+    bool visit(ConstElementPtr elem)
+    {
+        return _visited.insert(elem.get()).second;
+    }
+
+    void addAttributes(ConstElementPtr elem)
+    {
+        _hasher.add(elem->getCategory());
+        _hasher.add(elem->getName());
+        const AttributeNames attrNames = elem->getAttributeNames();
+        _hasher.add((uint64_t) attrNames.size());
+        for (const string& attrName : attrNames)
+        {
+            _hasher.add(attrName);
+            _hasher.add(elem->getAttribute(attrName));
+        }
+    }
+
+  private:
+    Hasher& _hasher;
+    GenContext& _context;
+    FileHashFunction _fileHash;
+    string _target;
+    string _language;
+    std::unordered_set<const Element*> _visited;
+    std::unordered_set<string> _visitedFiles;
+};
+
+void addOptions(Hasher& hasher, const GenOptions& options)
+{
+    hasher.add((uint64_t) options.shaderInterfaceType);
+    hasher.add((uint64_t) options.fileTextureVerticalFlip);
+    hasher.add(options.targetColorSpaceOverride);
+    hasher.add((uint64_t) options.hwTransparency);
+    hasher.add((uint64_t) options.hwSpecularEnvironmentMethod);
+    hasher.add((uint64_t) options.hwMaxActiveLightSources);
+    hasher.add((uint64_t) options.hwNormalizeUdimTexCoords);
+    hasher.add((uint64_t) options.optimizeGraphExpressions);
+    hasher.add((uint64_t) options.hwUniformBuffers);
+}
+
+void addLightShaders(Hasher& hasher, GenContext& context)
+{
+    HwLightShadersPtr lightShaders = context.getUserData<HwLightShaders>(HW::USER_DATA_LIGHT_SHADERS);
+    if (!lightShaders)
+    {
+        hasher.add((uint64_t) 0);
+        return;
+    }
+
+    // Add the bound light shaders in a consistent order.
+    vector<std::pair<unsigned int, const ShaderNode*>> bindings;
+    for (const auto& binding : lightShaders->get())
+    {
+        bindings.emplace_back(binding.first, binding.second.get());
+    }
+    std::sort(bindings.begin(), bindings.end());
+    hasher.add((uint64_t) bindings.size());
+    for (const auto& binding : bindings)
+    {
+        hasher.add((uint64_t) binding.first);
+        hasher.add(binding.second->getName());
+        hasher.add(binding.second->getImplementation().getName());
+    }
+}
+
+// Return the path of the file storing the shader with the given hash, which
+// is named by the leading digits of the hash.
+FilePath getCacheFilePath(const FilePath& directory, const string& hash)
+{
+    return directory / FilePath(hash.substr(0, CACHE_FILE_NAME_LENGTH) + "." + CACHE_FILE_EXTENSION);
+}
+
+// Parse a line holding a decimal size, returning false if it holds any other
+// characters or a value greater than the given maximum.
+bool parseSize(const string& line, size_t maxSize, size_t& size)
+{
+    if (line.empty())
+    {
+        return false;
+    }
+    size = 0;
+    for (char c : line)
+    {
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+        size_t digit = (size_t) (c - '0');
+        if (digit > maxSize || size > (maxSize - digit) / 10)
+        {
+            return false;
+        }
+        size = size * 10 + digit;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+//
+// ShaderCache methods
+//
+
+string ShaderCache::computeHash(const string& name, ElementPtr element, GenContext& context)
+{
+    ShaderGenerator& generator = context.getShaderGenerator();
+    ColorManagementSystemPtr cms = generator.getColorManagementSystem();
+
+    Hasher hasher;
+    hasher.add(name);
+    hasher.add(getVersionString());
+    hasher.add(generator.getLanguage());
+    hasher.add(generator.getTarget());
+    hasher.add(generator.getVersion());
+    hasher.add(cms ? cms->getName() : EMPTY_STRING);
+    addOptions(hasher, context.getOptions());
+    addLightShaders(hasher, context);
+
+    // Add the upstream dependency graph of the element.
+    DependencyHasher dependencies(hasher, context, [this](const FilePath& path)
+    {
+        return getFileHash(path);
+    });
+    dependencies.addElement(element);
+    for (Edge edge : element->traverseGraph())
+    {
+        dependencies.addElement(edge.getUpstreamElement());
+    }
+
+    // Add the document-level definitions that may be referenced by node
+    // definitions, including those of referenced libraries.
+    dependencies.addDocumentDefinitions(element->getDocument());
+
+    return hasher.asString(true);
+}
+
+ShaderPtr ShaderCache::generate(const string& name, ElementPtr element, GenContext& context)
+{
+    string hash = computeHash(name, element, context);
+    ShaderPtr shader = findShader(hash);
+    return shader ? shader : generateShader(hash, name, element, context);
+}
+
+StringMap ShaderCache::getSourceCode(const string& name, ElementPtr element, GenContext& context)
+{
+    string hash = computeHash(name, element, context);
+    StringMap sourceCode;
+
+    ShaderPtr shader = findShader(hash);
+    if (!shader)
+    {
+        if (readSourceCode(hash, sourceCode))
+        {
+            return sourceCode;
+        }
+        shader = generateShader(hash, name, element, context);
+    }
+
+    for (size_t i = 0; i < shader->numStages(); i++)
+    {
+        const ShaderStage& stage = shader->getStage(i);
+        sourceCode[stage.getName()] = stage.getSourceCode();
+    }
+    return sourceCode;
+}
+
+void ShaderCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _shaders.clear();
+    _fileHashes.clear();
+}
+
+size_t ShaderCache::getShaderCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _shaders.size();
+}
+
+ShaderPtr ShaderCache::findShader(const string& hash)
+{
+    CachedShader cached;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _shaders.find(hash);
+        if (it == _shaders.end())
+        {
+            return nullptr;
+        }
+        cached = it->second;
+    }
+    return includesCurrent(cached.includes) ? cached.shader : nullptr;
+}
+
+ShaderPtr ShaderCache::generateShader(const string& hash, const string& name, ElementPtr element, GenContext& context)
+{
+    ShaderPtr shader = context.getShaderGenerator().generate(name, element, context);
+
+    // Record the contents of the files included by each stage.
+    StringSet includePaths;
+    for (size_t i = 0; i < shader->numStages(); i++)
+    {
+        const StringSet& stageIncludes = shader->getStage(i).getIncludes();
+        includePaths.insert(stageIncludes.begin(), stageIncludes.end());
+    }
+    IncludeHashes includes;
+    for (const string& path : includePaths)
+    {
+        includes.emplace_back(path, getFileHash(path));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shaders[hash] = { shader, includes };
+        _generatedCount++;
+    }
+    if (!_cacheDirectory.isEmpty())
+    {
+        writeSourceCode(hash, *shader, includes);
+    }
+    return shader;
+}
+
+bool ShaderCache::includesCurrent(const IncludeHashes& includes)
+{
+    for (const auto& include : includes)
+    {
+        if (getFileHash(include.first) != include.second)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ShaderCache::readSourceCode(const string& hash, StringMap& sourceCode)
+{
+    if (_cacheDirectory.isEmpty())
+    {
+        return false;
+    }
+
+    // The stored shader begins with its full hash, which must match the
+    // requested hash, since files are named by only part of it.
+    FilePath path = getCacheFilePath(_cacheDirectory, hash);
+    std::ifstream file(path.asString(), std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return false;
+    }
+    std::streamoff fileSize = file.tellg();
+    file.seekg(0);
+    string storedHash;
+    if (fileSize <= 0 || !std::getline(file, storedHash) || storedHash != hash)
+    {
+        return false;
+    }
+
+    // The number of included files follows, and then the path and content
+    // hash of each on separate lines.
+    string line;
+    size_t includeCount;
+    if (!std::getline(file, line) || !parseSize(line, (size_t) fileSize, includeCount))
+    {
+        return false;
+    }
+    IncludeHashes includes;
+    for (size_t i = 0; i < includeCount; i++)
+    {
+        std::pair<string, string> include;
+        if (!std::getline(file, include.first) || !std::getline(file, include.second))
+        {
+            return false;
+        }
+        includes.push_back(include);
+    }
+    if (!includesCurrent(includes))
+    {
+        return false;
+    }
+
+    // Each stage is stored as its name and size on separate lines, followed
+    // by its source code.  A size exceeding the remaining bytes of the file
+    // marks a corrupt entry.
+    StringMap stages;
+    string stageName;
+    while (std::getline(file, stageName))
+    {
+        if (!std::getline(file, line))
+        {
+            return false;
+        }
+        std::streamoff position = file.tellg();
+        size_t size;
+        if (position < 0 || !parseSize(line, (size_t) (fileSize - position), size))
+        {
+            return false;
+        }
+        string& source = stages[stageName];
+        source.resize(size);
+        if (size && !file.read(&source[0], size))
+        {
+            return false;
+        }
+    }
+    if (!file.eof() || stages.empty())
+    {
+        return false;
+    }
+    sourceCode = stages;
+    return true;
+}
+
+void ShaderCache::writeSourceCode(const string& hash, const Shader& shader, const IncludeHashes& includes) const
+{
+    // Write to a temporary file that is then renamed, so that concurrent
+    // readers never observe a partial file.
+    FilePath path = getCacheFilePath(_cacheDirectory, hash);
+    size_t unique = std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+                    (size_t) std::chrono::steady_clock::now().time_since_epoch().count();
+    string tempPath = path.asString() + "." + std::to_string(unique) + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary);
+        file << hash << '\n' << includes.size() << '\n';
+        for (const auto& include : includes)
+        {
+            file << include.first << '\n' << include.second << '\n';
+        }
+        for (size_t i = 0; i < shader.numStages(); i++)
+        {
+            const ShaderStage& stage = shader.getStage(i);
+            const string& source = stage.getSourceCode();
+            file << stage.getName() << '\n' << source.size() << '\n';
+            file.write(source.data(), source.size());
+        }
+        if (!file)
+        {
+            file.close();
+            std::remove(tempPath.c_str());
+            return;
+        }
+    }
+    if (std::rename(tempPath.c_str(), path.asString().c_str()) != 0)
+    {
+        std::remove(tempPath.c_str());
+    }
+}
+
+string ShaderCache::getFileHash(const FilePath& path)
+{
+    // The modification time is read before the contents, so that an edit
+    // made while the file is hashed is detected by the next call.
+    const int64_t modifiedTime = path.getModifiedTime();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _fileHashes.find(path.asString());
+        if (it != _fileHashes.end() && it->second.modifiedTime == modifiedTime)
+        {
+            return it->second.hash;
+        }
+    }
+
+    // Read and hash the file without holding the lock.
+    Hasher hasher;
+    string contents;
+    if (readFile(path.asString(), contents))
+    {
+        hasher.add(contents);
+    }
+    FileHash fileHash = { modifiedTime, hasher.asString() };
+    std::lock_guard<std::mutex> lock(_mutex);
+    _fileHashes[path.asString()] = fileHash;
+    return fileHash.hash;
+}
+
+} // namespace MaterialX
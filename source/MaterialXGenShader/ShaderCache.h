@@ -0,0 +1,159 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_SHADERCACHE_H
+#define MATERIALX_SHADERCACHE_H
+
+/// @file
+/// Content-addressed cache of generated shaders
+
+#include <MaterialXGenShader/Library.h>
+
+#include <MaterialXGenShader/Shader.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace MaterialX
+{
+
+class GenContext;
+class ShaderCache;
+
+/// Shared pointer to a ShaderCache
+using ShaderCachePtr = shared_ptr<ShaderCache>;
+
+/// @class ShaderCache
+/// A content-addressed cache of generated shaders.
+///
+/// Each shader is identified by a hash of everything that determines its
+/// generated code: the shader name, the upstream dependency graph of the
+/// given element, the node definitions and implementations it resolves to,
+/// the contents of implementation source files and the files they include,
+/// the type and geometric property definitions of the document and its
+/// referenced libraries, the MaterialX library version, the language, target
+/// and version of the shader generator, the color management system, any
+/// bound light shaders, and every field of GenOptions.  Finished shaders are
+/// held in memory, and when a cache directory is set, the source code of
+/// their stages is also stored on disk, where it may be shared between
+/// processes.
+///
+/// Cached shaders also record the contents of every file included by their
+/// stages, including those included by the shader generator itself, and are
+/// generated again when any of these files has been edited.  Source files are
+/// hashed once for each modification time.  Other user data held by the
+/// GenContext is not part of the hash, so the cache should be cleared when
+/// it changes.
+class ShaderCache
+{
+  public:
+    ShaderCache() :
+        _generatedCount(0)
+    {
+    }
+    ~ShaderCache() { }
+
+    /// Create and return a new shader cache.
+    static ShaderCachePtr create()
+    {
+        return std::make_shared<ShaderCache>();
+    }
+
+    /// Set the directory in which the source code of generated shader stages
+    /// is stored.  If the path is empty, then shaders are only cached in
+    /// memory.  Defaults to an empty path.
+    void setCacheDirectory(const FilePath& path)
+    {
+        _cacheDirectory = path;
+    }
+
+    /// Return the directory in which the source code of generated shader
+    /// stages is stored.
+    const FilePath& getCacheDirectory() const
+    {
+        return _cacheDirectory;
+    }
+
+    /// Return the hash identifying the shader that would be generated for
+    /// the given element, as a string of 32 hexadecimal digits.  The first
+    /// 16 digits name the file of the shader in the cache directory, and the
+    /// full hash is stored within the file and verified when it is read.
+    string computeHash(const string& name, ElementPtr element, GenContext& context);
+
+    /// Return the shader for the given element, generating it with the shader
+    /// generator of the given context if it is not already held in memory.
+    ShaderPtr generate(const string& name, ElementPtr element, GenContext& context);
+
+    /// Return the source code of each stage of the shader for the given
+    /// element, keyed by stage name.  The source code is taken from memory
+    /// or the cache directory if available, so that no shader generation is
+    /// required for shaders generated in earlier sessions.
+    StringMap getSourceCode(const string& name, ElementPtr element, GenContext& context);
+
+    /// Remove all shaders from memory.  Source code stored in the cache
+    /// directory is unaffected.
+    void clear();
+
+    /// Return the number of shaders held in memory.
+    size_t getShaderCount() const;
+
+    /// Return the number of shaders generated through this cache.
+    size_t getGeneratedCount() const
+    {
+        return _generatedCount;
+    }
+
+  protected:
+    // The resolved paths of the files included by a shader, paired with the
+    // hashes of their contents at the time of generation.
+    using IncludeHashes = vector<std::pair<string, string>>;
+
+    // A shader held in memory, along with the files that it includes.
+    struct CachedShader
+    {
+        ShaderPtr shader;
+        IncludeHashes includes;
+    };
+
+    // The hash of a source file, along with its modification time when hashed.
+    struct FileHash
+    {
+        int64_t modifiedTime;
+        string hash;
+    };
+
+  protected:
+    // Return the shader held in memory under the given hash, or nullptr if no
+    // shader is held or any of its included files has since been edited.
+    ShaderPtr findShader(const string& hash);
+
+    // Generate a shader and store it under the given hash.
+    ShaderPtr generateShader(const string& hash, const string& name, ElementPtr element, GenContext& context);
+
+    // Read and write the source code of shader stages in the cache directory.
+    bool readSourceCode(const string& hash, StringMap& sourceCode);
+    void writeSourceCode(const string& hash, const Shader& shader, const IncludeHashes& includes) const;
+
+    // Return true if each of the given included files is unchanged.
+    bool includesCurrent(const IncludeHashes& includes);
+
+    // Return the hash of the contents of the given source file, hashing the
+    // file again if it has been modified since it was last hashed.  The hash
+    // is returned by value, since the cache may be cleared on another thread.
+    string getFileHash(const FilePath& path);
+
+  protected:
+    FilePath _cacheDirectory;
+    std::unordered_map<string, CachedShader> _shaders;
+    std::unordered_map<string, FileHash> _fileHashes;
+    std::atomic<size_t> _generatedCount;
+    mutable std::mutex _mutex;
+};
+
+} // namespace MaterialX
+
+#endif
@@ -7,6 +7,7 @@
 
 #include <MaterialXGenShader/GenContext.h>
 #include <MaterialXGenShader/ShaderNodeImpl.h>
+#include <MaterialXGenShader/ShaderVariants.h>
 #include <MaterialXGenShader/Nodes/CompoundNode.h>
 #include <MaterialXGenShader/Nodes/SourceCodeNode.h>
 #include <MaterialXGenShader/Util.h>
@@ -15,9 +16,14 @@
 
 #include <MaterialXCore/Document.h>
 #include <MaterialXCore/Node.h>
+#include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
 
+#include <algorithm>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <typeinfo>
 
 namespace MaterialX
 {
@@ -29,11 +35,87 @@ const string ShaderGenerator::COMMA = ",";
 // ShaderGenerator methods
 //
 
+vector<ShaderPtr> ShaderGenerator::generateAll(const vector<TypedElementPtr>& elements, const GenContext& context,
+                                               unsigned int threadCount) const
+{
+    if (&context.getShaderGenerator() != this)
+    {
+        throw ExceptionShaderGenError("Context for generating shaders must use the same shader generator");
+    }
+
+    if (!threadCount)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threadCount = (unsigned int) std::min((size_t) threadCount, elements.size());
+
+    // Fork one context per worker thread.  Each call claims a context that
+    // is not in use, so no context is used by two threads at once.
+    vector<GenContext> contexts;
+    vector<size_t> freeContexts;
+    for (unsigned int i = 0; i < threadCount; i++)
+    {
+        contexts.push_back(context.fork());
+        freeContexts.push_back(i);
+    }
+    std::mutex contextMutex;
+
+    // Float formatting is set per thread, so apply the formatting of the
+    // calling thread on every worker.
+    const Value::FloatFormat floatFormat = Value::getFloatFormat();
+    const int floatPrecision = Value::getFloatPrecision();
+
+    vector<ShaderPtr> shaders(elements.size());
+    parallelFor(elements.size(), [&](size_t i)
+    {
+        ScopedFloatFormatting formatting(floatFormat, floatPrecision);
+        size_t contextIndex;
+        {
+            std::lock_guard<std::mutex> guard(contextMutex);
+            contextIndex = freeContexts.back();
+            freeContexts.pop_back();
+        }
+        try
+        {
+            const string name = createValidName(elements[i]->getNamePath());
+            shaders[i] = generate(name, elements[i], contexts[contextIndex]);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> guard(contextMutex);
+            freeContexts.push_back(contextIndex);
+            throw;
+        }
+        std::lock_guard<std::mutex> guard(contextMutex);
+        freeContexts.push_back(contextIndex);
+    }, threadCount);
+
+    return shaders;
+}
+
 ShaderGenerator::ShaderGenerator(SyntaxPtr syntax) :
      _syntax(syntax)
 {
 }
 
+ShaderGraphPtr ShaderGenerator::createShaderGraph(const string& name, ElementPtr element, GenContext& context) const
+{
+    shared_ptr<SharedShaderGraph> sharedGraph = context.getUserData<SharedShaderGraph>(SharedShaderGraph::USER_DATA_NAME);
+    ShaderGraphPtr graph = sharedGraph ? sharedGraph->getGraph(element, name) : nullptr;
+    if (graph)
+    {
+        graph->addIdentifiers(context);
+        return graph;
+    }
+
+    graph = ShaderGraph::create(nullptr, name, element, context);
+    if (sharedGraph)
+    {
+        sharedGraph->setGraph(graph, element, name);
+    }
+    return graph;
+}
+
 void ShaderGenerator::emitScopeBegin(ShaderStage& stage, Syntax::Punctuation punc) const
 {
     stage.beginScope(punc);
@@ -84,6 +166,11 @@ void ShaderGenerator::emitInclude(const string& file, GenContext& context, Shade
     stage.addInclude(file, context);
 }
 
+void ShaderGenerator::emitSourceFile(ConstSourceFilePtr file, GenContext& context, ShaderStage& stage) const
+{
+    stage.addSourceFile(file, context);
+}
+
 void ShaderGenerator::emitFunctionDefinition(const ShaderNode& node, GenContext& context, ShaderStage& stage) const
 {
     stage.addFunctionDefinition(node, context);
@@ -100,21 +187,52 @@ void ShaderGenerator::emitFunctionCall(const ShaderNode& node, GenContext& conte
     }
     else
     {
+        MATERIALX_GEN_PROFILE_SCOPE(context, node.getCategory());
         node.getImplementation().emitFunctionCall(node, context, stage);
     }
 }
 
 void ShaderGenerator::emitFunctionDefinitions(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const
 {
+    MATERIALX_GEN_PROFILE_SCOPE(context, "emitFunctionDefinitions");
+
+    // Add the function definitions of a shared graph emitted for a previous
+    // shader, if any were emitted from the same state of the stage.
+    shared_ptr<SharedShaderGraph> sharedGraph = context.getUserData<SharedShaderGraph>(SharedShaderGraph::USER_DATA_NAME);
+    if (sharedGraph && !sharedGraph->isGraph(graph))
+    {
+        sharedGraph = nullptr;
+    }
+    if (sharedGraph)
+    {
+        for (ConstEmittedCodePtr code : sharedGraph->getFunctionDefinitions(stage.getName(), context.getOptions()))
+        {
+            if (stage.addEmittedCode(*code))
+            {
+                return;
+            }
+        }
+    }
+
+    EmittedCodePtr code = sharedGraph ? stage.beginRecording() : nullptr;
+
     // Emit function definitions for all nodes in the graph.
     for (ShaderNode* node : graph.getNodes())
     {
         emitFunctionDefinition(*node, context, stage);
     }
+
+    if (code)
+    {
+        stage.endRecording();
+        sharedGraph->addFunctionDefinitions(stage.getName(), context.getOptions(), code);
+    }
 }
 
 void ShaderGenerator::emitFunctionCalls(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const
 {
+    MATERIALX_GEN_PROFILE_SCOPE(context, "emitFunctionCalls");
+
     // Emit function calls for all nodes in the graph.
     for (ShaderNode* node : graph.getNodes())
     {
@@ -259,9 +377,46 @@ bool ShaderGenerator::implementationRegistered(const string& name) const
     return _implFactory.classRegistered(name);
 }
 
+string ShaderGenerator::getSourceCodeImplementationKey(const ShaderNodeImpl& impl, const InterfaceElement& element,
+                                                       GenContext& context) const
+{
+    // The key is empty if the source file cannot be found, leaving the
+    // error to be reported by initialization of the implementation.
+    ConstSourceFilePtr sourceFile = context.getSourceFile(element.getAttribute(Implementation::FILE_ATTRIBUTE));
+    if (!sourceFile)
+    {
+        return EMPTY_STRING;
+    }
+
+    // Class names are included, so that generators overriding
+    // createSourceCodeImplementation never share implementations of another
+    // class.  These names vary between compilers, which is harmless since
+    // keys are only compared within a process.
+    Hasher hasher;
+    hasher.add(typeid(*this).name());
+    hasher.add(typeid(impl).name());
+    hasher.add(getLanguage());
+    hasher.add(getTarget());
+    hasher.add(getVersion());
+    hasher.add(impl.getLanguage());
+    hasher.add(impl.getTarget());
+    hasher.add(element.getName());
+    const AttributeNames attrNames = element.getAttributeNames();
+    hasher.add((uint64_t) attrNames.size());
+    for (const string& attrName : attrNames)
+    {
+        hasher.add(attrName);
+        hasher.add(element.getAttribute(attrName));
+    }
+    hasher.add(sourceFile->getPath().asString());
+    hasher.add(sourceFile->getHash());
+    return hasher.asString();
+}
+
 ShaderNodeImplPtr ShaderGenerator::getImplementation(const InterfaceElement& element, GenContext& context) const
 {
     const string& name = element.getName();
+    MATERIALX_GEN_PROFILE_COUNT(context, "implementationsResolved", 1);
 
     // Check if it's created and cached already.
     ShaderNodeImplPtr impl = context.findNodeImplementation(name);
@@ -269,6 +424,7 @@ ShaderNodeImplPtr ShaderGenerator::getImplementation(const InterfaceElement& ele
     {
         return impl;
     }
+    MATERIALX_GEN_PROFILE_SCOPE(context, "createImplementation");
 
     if (element.isA<NodeGraph>())
     {
@@ -281,20 +437,36 @@ ShaderNodeImplPtr ShaderGenerator::getImplementation(const InterfaceElement& ele
         impl = _implFactory.create(name);
         if (!impl)
         {
-            // Fall back to the source code implementation.
+            // Fall back to the source code implementation, which is shared
+            // through the source cache by all contexts with the same key.
             impl = createSourceCodeImplementation(static_cast<const Implementation&>(element));
+            const string key = getSourceCodeImplementationKey(*impl, element, context);
+            if (!key.empty())
+            {
+                SourceCachePtr sourceCache = context.getSourceCache();
+                ShaderNodeImplPtr sharedImpl = sourceCache->findImplementation(key);
+                if (!sharedImpl)
+                {
+                    impl->initialize(element, context);
+                    sharedImpl = sourceCache->addImplementation(key, impl);
+                }
+                return context.addNodeImplementation(name, sharedImpl);
+            }
         }
     }
     else
     {
         throw ExceptionShaderGenError("Element '" + name + "' is neither an Implementation nor an NodeGraph");
     }
-    impl->initialize(element, context);
 
-    // Cache it.
-    context.addNodeImplementation(name, impl);
+    // Initialize on a fork of the context, so that identifiers created by
+    // compound implementations do not affect the names of the shader being
+    // generated, which then do not depend on the implementations cached.
+    GenContext initContext = context.fork();
+    impl->initialize(element, initContext);
 
-    return impl;
+    // Cache it, keeping any implementation cached concurrently by a forked context.
+    return context.addNodeImplementation(name, impl);
 }
 
 bool ShaderGenerator::remapEnumeration(const ValueElement&, const string&, std::pair<const TypeDesc*, ValuePtr>&) const
@@ -304,21 +476,35 @@ bool ShaderGenerator::remapEnumeration(const ValueElement&, const string&, std::
 
 namespace
 {
-    void replace(const StringMap& substitutions, ShaderPort* port)
+    void replace(const TokenTable& substitutions, ShaderPort* port)
     {
         string name = port->getName();
-        tokenSubstitution(substitutions, name);
+        substitutions.substitute(name);
         port->setName(name);
         string variable = port->getVariable();
-        tokenSubstitution(substitutions, variable);
+        substitutions.substitute(variable);
         port->setVariable(variable);
     }
 }
 
 void ShaderGenerator::replaceTokens(const StringMap& substitutions, ShaderStage& stage) const
+{
+    replaceTokens(TokenTable(substitutions), stage);
+}
+
+const TokenTable& ShaderGenerator::getTokenTable() const
+{
+    std::call_once(_tokenTableFlag, [this]()
+    {
+        _tokenTable = TokenTable(_tokenSubstitutions);
+    });
+    return _tokenTable;
+}
+
+void ShaderGenerator::replaceTokens(const TokenTable& substitutions, ShaderStage& stage) const
 {
     // Replace tokens in source code
-    tokenSubstitution(substitutions, stage._code);
+    stage.replaceTokens(substitutions);
 
     // Replace tokens on shader interface
     for (size_t i = 0; i < stage._constants.size(); ++i)
@@ -15,9 +15,12 @@
 #include <MaterialXGenShader/Factory.h>
 #include <MaterialXGenShader/ShaderStage.h>
 #include <MaterialXGenShader/Syntax.h>
+#include <MaterialXGenShader/TokenTable.h>
 
 #include <MaterialXCore/Util.h>
 
+#include <mutex>
+
 namespace MaterialX
 {
 
@@ -38,10 +41,32 @@ class ShaderGenerator
     /// Return a unique identifier for the target this generator is for
     virtual const string& getTarget() const = 0;
 
+    /// Return the version string of the language this generator is for,
+    /// or an empty string if the generator is not versioned
+    virtual const string& getVersion() const { return EMPTY_STRING; }
+
     /// Generate a shader starting from the given element, translating
     /// the element and all dependencies upstream into shader code.
     virtual ShaderPtr generate(const string& name, ElementPtr element, GenContext& context) const = 0;
 
+    /// Generate shaders for all of the given elements in parallel, returning
+    /// them in the order of the given elements.  Each shader is named by the
+    /// name path of its element, and is generated on a fork of the given
+    /// context, which must use this shader generator.  One fork is created
+    /// per thread, and all forks share the implementation cache of the given
+    /// context.  If generation fails for any element, then the exception of
+    /// the failing element with the lowest index is rethrown.  Values are
+    /// formatted with the float format and precision of the calling thread
+    /// on every worker thread.  As with serial generation, the order of
+    /// nodes in the generated code only reproduces across threads and runs
+    /// when GenOptions::optimizeGraphExpressions is enabled.
+    /// @param elements Elements to generate shaders for.
+    /// @param context Context to fork for each generating thread.
+    /// @param threadCount Maximum number of threads to use, or zero to use
+    ///    one thread per hardware core.
+    vector<ShaderPtr> generateAll(const vector<TypedElementPtr>& elements, const GenContext& context,
+                                  unsigned int threadCount = 0) const;
+
     /// Start a new scope using the given bracket type.
     virtual void emitScopeBegin(ShaderStage& stage, Syntax::Punctuation punc = Syntax::CURLY_BRACKETS) const;
 
@@ -73,6 +98,10 @@ class ShaderGenerator
     /// only included once for the shader stage.
     virtual void emitInclude(const string& file, GenContext& context, ShaderStage& stage) const;
 
+    /// Add the lines of a parsed source file, resolving any
+    /// include statements it contains.
+    virtual void emitSourceFile(ConstSourceFilePtr file, GenContext& context, ShaderStage& stage) const;
+
     /// Add a value.
     template<typename T>
     void emitValue(const T& value, ShaderStage& stage) const
@@ -169,6 +198,11 @@ class ShaderGenerator
     /// Protected constructor
     ShaderGenerator(SyntaxPtr syntax);
 
+    /// Create the shader graph for an element.  If a SharedShaderGraph is
+    /// present in the context, then a graph already built for the element
+    /// is returned instead, and a newly built graph is stored for reuse.
+    ShaderGraphPtr createShaderGraph(const string& name, ElementPtr element, GenContext& context) const;
+
     /// Create a new stage in a shader.
     virtual ShaderStagePtr createStage(const string& name, Shader& shader) const;
 
@@ -177,6 +211,15 @@ class ShaderGenerator
     /// Derived classes can override this to use custom source code implementations.
     virtual ShaderNodeImplPtr createSourceCodeImplementation(const Implementation& impl) const;
 
+    /// Return the key identifying a source code implementation created for the
+    /// given implementation element, from the classes of the generator and
+    /// implementation, their language, target and version, the element
+    /// attributes and the contents of its source file.  Implementations with the same key are
+    /// shared by all contexts and shader generators using the same source cache.
+    /// Returns an empty string if the source file of the element is not found.
+    string getSourceCodeImplementationKey(const ShaderNodeImpl& impl, const InterfaceElement& element,
+                                          GenContext& context) const;
+
     /// Create a compound implementation which is the implementation class to use
     /// for nodes using a nodegraph as their implementation.
     /// Derived classes can override this to use custom compound implementations.
@@ -191,6 +234,14 @@ class ShaderGenerator
     /// Replace tokens with identifiers according to the given substitutions map.
     void replaceTokens(const StringMap& substitutions, ShaderStage& stage) const;
 
+    /// Replace tokens with identifiers according to the given token table.
+    void replaceTokens(const TokenTable& substitutions, ShaderStage& stage) const;
+
+    /// Return the token table compiled from the token substitutions of this
+    /// generator.  The table is compiled on first use, so the substitutions
+    /// should not be edited after the generator has been constructed.
+    const TokenTable& getTokenTable() const;
+
   protected:
     static const string SEMICOLON;
     static const string COMMA;
@@ -199,6 +250,10 @@ class ShaderGenerator
     Factory<ShaderNodeImpl> _implFactory;
     ColorManagementSystemPtr _colorManagementSystem;
     StringMap _tokenSubstitutions;
+
+  private:
+    mutable TokenTable _tokenTable;
+    mutable std::once_flag _tokenTableFlag;
 };
 
 } // namespace MaterialX
@@ -13,9 +13,195 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 namespace MaterialX
 {
 
+namespace
+{
+
+// A math operation that can be evaluated per component on constant inputs.
+struct FoldOperation
+{
+    const char* inputs[3];
+    size_t numInputs;
+    bool (*evaluate)(const float* args, float& result);
+};
+
+const std::unordered_map<string, FoldOperation> FOLD_OPERATIONS =
+{
+    { "add", { { "in1", "in2" }, 2, [](const float* a, float& r) { r = a[0] + a[1]; return true; } } },
+    { "subtract", { { "in1", "in2" }, 2, [](const float* a, float& r) { r = a[0] - a[1]; return true; } } },
+    { "multiply", { { "in1", "in2" }, 2, [](const float* a, float& r) { r = a[0] * a[1]; return true; } } },
+    { "divide", { { "in1", "in2" }, 2, [](const float* a, float& r) { r = a[0] / a[1]; return a[1] != 0.0f; } } },
+    { "min", { { "in1", "in2" }, 2, [](const float* a, float& r) { r = std::min(a[0], a[1]); return true; } } },
+    { "max", { { "in1", "in2" }, 2, [](const float* a, float& r) { r = std::max(a[0], a[1]); return true; } } },
+    { "clamp", { { "in", "low", "high" }, 3, [](const float* a, float& r) { r = std::min(std::max(a[0], a[1]), a[2]); return true; } } },
+    { "mix", { { "fg", "bg", "mix" }, 3, [](const float* a, float& r) { r = a[1] * (1.0f - a[2]) + a[0] * a[2]; return true; } } }
+};
+
+template<class T> void appendComponents(const T& vec, vector<float>& components)
+{
+    for (size_t i = 0; i < T::numElements(); ++i)
+    {
+        components.push_back(vec[i]);
+    }
+}
+
+template<class T> ValuePtr createVectorValue(const vector<float>& components)
+{
+    T vec;
+    for (size_t i = 0; i < T::numElements(); ++i)
+    {
+        vec[i] = components[i];
+    }
+    return Value::createValue<T>(vec);
+}
+
+// Return the components of a float or vector value.
+bool getComponents(ValuePtr value, vector<float>& components)
+{
+    components.clear();
+    if (!value)
+    {
+        return false;
+    }
+    if (value->isA<float>())
+    {
+        components.push_back(value->asA<float>());
+    }
+    else if (value->isA<Vector2>())
+    {
+        appendComponents(value->asA<Vector2>(), components);
+    }
+    else if (value->isA<Vector3>())
+    {
+        appendComponents(value->asA<Vector3>(), components);
+    }
+    else if (value->isA<Vector4>())
+    {
+        appendComponents(value->asA<Vector4>(), components);
+    }
+    else if (value->isA<Color2>())
+    {
+        appendComponents(value->asA<Color2>(), components);
+    }
+    else if (value->isA<Color3>())
+    {
+        appendComponents(value->asA<Color3>(), components);
+    }
+    else if (value->isA<Color4>())
+    {
+        appendComponents(value->asA<Color4>(), components);
+    }
+    return !components.empty();
+}
+
+// Create a float or vector value of the given type from its components.
+ValuePtr createFoldedValue(const TypeDesc* type, const vector<float>& components)
+{
+    if (type == Type::FLOAT)
+    {
+        return Value::createValue<float>(components[0]);
+    }
+    else if (type == Type::VECTOR2)
+    {
+        return createVectorValue<Vector2>(components);
+    }
+    else if (type == Type::VECTOR3)
+    {
+        return createVectorValue<Vector3>(components);
+    }
+    else if (type == Type::VECTOR4)
+    {
+        return createVectorValue<Vector4>(components);
+    }
+    else if (type == Type::COLOR2)
+    {
+        return createVectorValue<Color2>(components);
+    }
+    else if (type == Type::COLOR3)
+    {
+        return createVectorValue<Color3>(components);
+    }
+    else if (type == Type::COLOR4)
+    {
+        return createVectorValue<Color4>(components);
+    }
+    return nullptr;
+}
+
+// Append a key that identifies the exact value to the given string.  Float
+// components are keyed by their bits, and other values are formatted with
+// enough digits to distinguish every float they hold.
+void appendValueKey(ValuePtr value, vector<float>& components, string& key)
+{
+    if (!value)
+    {
+        return;
+    }
+    if (getComponents(value, components))
+    {
+        for (float component : components)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &component, sizeof(bits));
+            key += std::to_string(bits) + ",";
+        }
+    }
+    else
+    {
+        ScopedFloatFormatting format(Value::FloatFormatDefault, std::numeric_limits<float>::max_digits10);
+        key += value->getValueString();
+    }
+}
+
+// Return true if the given input holds a constant value.  Unconnected inputs
+// that are published as editable uniforms in the complete shader interface
+// are not constant.
+bool isConstantInput(const ShaderNode& node, const ShaderInput& input, GenContext& context)
+{
+    return !input.getConnection() && input.getChannels().empty() &&
+           (context.getOptions().shaderInterfaceType == SHADER_INTERFACE_REDUCED ||
+            !input.getType()->isEditable() || !node.isEditable(input));
+}
+
+// Replace the downstream connections of an output by the given value,
+// swizzling the value where channels are set on a downstream input.
+void setDownstreamValue(GenContext& context, ShaderOutput* output, ValuePtr value, const TypeDesc* type, const string* path)
+{
+    // Iterate a copy of the connection set since the
+    // original set will change when breaking connections.
+    ShaderInputSet downstreamConnections = output->getConnections();
+    for (ShaderInput* downstream : downstreamConnections)
+    {
+        output->breakConnection(downstream);
+        downstream->setValue(value);
+        if (path)
+        {
+            downstream->setPath(*path);
+        }
+
+        // Swizzle the input value. Once done clear the channel to indicate
+        // no further swizzling is reqiured.
+        const string& channels = downstream->getChannels();
+        if (!channels.empty())
+        {
+            downstream->setValue(context.getShaderGenerator().getSyntax().getSwizzledValue(value,
+                                                                                      type,
+                                                                                      channels,
+                                                                                      downstream->getType()));
+            downstream->setType(downstream->getType());
+            downstream->setChannels(EMPTY_STRING);
+        }
+    }
+}
+
+} // anonymous namespace
+
 //
 // ShaderGraph methods
 //
@@ -66,6 +252,8 @@ void ShaderGraph::addOutputSockets(const InterfaceElement& elem)
 
 void ShaderGraph::addUpstreamDependencies(const Element& root, ConstMaterialPtr material, GenContext& context)
 {
+    MATERIALX_GEN_PROFILE_SCOPE(context, "addUpstreamDependencies");
+
     // Keep track of our root node in the graph.
     // This is needed when the graph is a shader graph and we need
     // to make connections for BindInputs during traversal below.
@@ -317,6 +505,8 @@ void ShaderGraph::addColorTransformNode(ShaderOutput* output, const ColorSpaceTr
 
 ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const NodeGraph& nodeGraph, GenContext& context)
 {
+    MATERIALX_GEN_PROFILE_SCOPE(context, "ShaderGraph::create");
+
     NodeDefPtr nodeDef = nodeGraph.getNodeDef();
     if (!nodeDef)
     {
@@ -357,6 +547,8 @@ ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const NodeGraph& n
 
 ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const string& name, ElementPtr element, GenContext& context)
 {
+    MATERIALX_GEN_PROFILE_SCOPE(context, "ShaderGraph::create");
+
     ShaderGraphPtr graph;
     ElementPtr root;
     MaterialPtr material;
@@ -759,10 +951,16 @@ void ShaderGraph::finalize(GenContext& context)
     }
 
     // Sort the nodes in topological order.
-    topologicalSort();
+    {
+        MATERIALX_GEN_PROFILE_SCOPE(context, "topologicalSort");
+        topologicalSort(context.getOptions().optimizeGraphExpressions);
+    }
 
     // Calculate scopes for all nodes in the graph.
-    calculateScopes();
+    {
+        MATERIALX_GEN_PROFILE_SCOPE(context, "calculateScopes");
+        calculateScopes();
+    }
 
     // Set variable names for inputs and outputs in the graph.
     setVariableNames(context);
@@ -804,6 +1002,8 @@ void ShaderGraph::disconnect(ShaderNode* node) const
 
 void ShaderGraph::optimize(GenContext& context)
 {
+    MATERIALX_GEN_PROFILE_SCOPE(context, "optimize");
+
     size_t numEdits = 0;
     for (ShaderNode* node : getNodes())
     {
@@ -857,6 +1057,13 @@ void ShaderGraph::optimize(GenContext& context)
         }
     }
 
+    if (context.getOptions().optimizeGraphExpressions)
+    {
+        topologicalSort(true);
+        numEdits += foldConstants(context);
+        numEdits += mergeDuplicates(context);
+    }
+
     if (numEdits > 0)
     {
         std::set<ShaderNode*> usedNodes;
@@ -873,7 +1080,10 @@ void ShaderGraph::optimize(GenContext& context)
             }
         }
 
-        // Remove any unused nodes
+        // Remove any unused nodes, keeping the existing order of used nodes
+        // so that generated code does not depend on node addresses.
+        vector<ShaderNode*> usedNodeOrder;
+        usedNodeOrder.reserve(usedNodes.size());
         for (ShaderNode* node : _nodeOrder)
         {
             if (usedNodes.count(node) == 0)
@@ -884,10 +1094,13 @@ void ShaderGraph::optimize(GenContext& context)
                 // Erase from storage
                 _nodeMap.erase(node->getName());
             }
+            else
+            {
+                usedNodeOrder.push_back(node);
+            }
         }
 
-        _nodeOrder.resize(usedNodes.size());
-        _nodeOrder.assign(usedNodes.begin(), usedNodes.end());
+        _nodeOrder = usedNodeOrder;
     }
 }
 
@@ -913,32 +1126,126 @@ void ShaderGraph::bypass(GenContext& context, ShaderNode* node, size_t inputInde
     {
         // No node connected upstream to re-route,
         // so push the input's value and element path downstream instead.
-        // Iterate a copy of the connection set since the
-        // original set will change when breaking connections.
-        ShaderInputSet downstreamConnections = output->getConnections();
-        for (ShaderInput* downstream : downstreamConnections)
+        setDownstreamValue(context, output, input->getValue(), input->getType(), &input->getPath());
+    }
+}
+
+size_t ShaderGraph::foldConstants(GenContext& context)
+{
+    // Nodes are visited in topological order, so that values folded
+    // upstream are available when visiting the nodes downstream.
+    size_t numFolded = 0;
+    vector<float> components[3];
+    vector<float> result;
+    for (ShaderNode* node : _nodeOrder)
+    {
+        auto it = FOLD_OPERATIONS.find(node->getCategory());
+        if (it == FOLD_OPERATIONS.end() || node->numOutputs() != 1)
         {
-            output->breakConnection(downstream);
-            downstream->setValue(input->getValue());
-            downstream->setPath(input->getPath());
+            continue;
+        }
+        const FoldOperation& operation = it->second;
+        ShaderOutput* output = node->getOutput();
+        const TypeDesc* type = output->getType();
+        const size_t size = type->getSize();
+
+        bool foldable = true;
+        for (size_t i = 0; i < operation.numInputs && foldable; ++i)
+        {
+            const ShaderInput* input = node->getInput(operation.inputs[i]);
+            foldable = input && isConstantInput(*node, *input, context) &&
+                       getComponents(input->getValue(), components[i]) &&
+                       (components[i].size() == 1 || components[i].size() == size);
+        }
+
+        // Evaluate per component, broadcasting scalar inputs.
+        result.resize(size);
+        for (size_t c = 0; c < size && foldable; ++c)
+        {
+            float args[3];
+            for (size_t i = 0; i < operation.numInputs; ++i)
+            {
+                args[i] = components[i].size() == 1 ? components[i][0] : components[i][c];
+            }
+            foldable = operation.evaluate(args, result[c]);
+        }
+
+        ValuePtr value = foldable ? createFoldedValue(type, result) : nullptr;
+        if (value)
+        {
+            setDownstreamValue(context, output, value, type, nullptr);
+            ++numFolded;
+        }
+    }
+    return numFolded;
+}
+
+size_t ShaderGraph::mergeDuplicates(GenContext& context)
+{
+    // Nodes are visited in topological order, so that duplicates merged
+    // upstream make the nodes downstream of them duplicates as well.
+    size_t numMerged = 0;
+    std::unordered_map<string, ShaderNode*> expressions;
+    vector<float> components;
+    for (ShaderNode* node : _nodeOrder)
+    {
+        if (!node->hasClassification(ShaderNode::Classification::TEXTURE) ||
+            node->hasClassification(ShaderNode::Classification::CONDITIONAL) ||
+            node->hasClassification(ShaderNode::Classification::CONSTANT))
+        {
+            continue;
+        }
 
-            // Swizzle the input value. Once done clear the channel to indicate
-            // no further swizzling is reqiured.
-            const string& channels = downstream->getChannels();
-            if (!channels.empty())
+        // Identify the expression by its implementation and inputs.
+        string key = std::to_string(reinterpret_cast<size_t>(&node->getImplementation()));
+        bool mergeable = true;
+        for (const ShaderInput* input : node->getInputs())
+        {
+            const ShaderOutput* upstream = input->getConnection();
+            if (upstream)
+            {
+                key += "|c" + std::to_string(reinterpret_cast<size_t>(upstream)) + input->getChannels();
+            }
+            else if (isConstantInput(*node, *input, context))
+            {
+                key += "|v" + input->getType()->getName() + ":";
+                appendValueKey(input->getValue(), components, key);
+            }
+            else
             {
-                downstream->setValue(context.getShaderGenerator().getSyntax().getSwizzledValue(input->getValue(),
-                                                                                          input->getType(), 
-                                                                                          channels,
-                                                                                          downstream->getType()));
-                downstream->setType(downstream->getType());
-                downstream->setChannels(EMPTY_STRING);
+                mergeable = false;
+                break;
             }
         }
+        if (!mergeable)
+        {
+            continue;
+        }
+
+        auto it = expressions.insert(std::make_pair(key, node));
+        if (it.second)
+        {
+            continue;
+        }
+
+        // Re-route the downstream connections to the first node.
+        ShaderNode* first = it.first->second;
+        for (size_t i = 0; i < node->numOutputs(); ++i)
+        {
+            ShaderOutput* output = node->getOutput(i);
+            ShaderInputSet downstreamConnections = output->getConnections();
+            for (ShaderInput* downstream : downstreamConnections)
+            {
+                output->breakConnection(downstream);
+                downstream->makeConnection(first->getOutput(i));
+            }
+        }
+        ++numMerged;
     }
+    return numMerged;
 }
 
-void ShaderGraph::topologicalSort()
+void ShaderGraph::topologicalSort(bool orderByName)
 {
     // Calculate a topological order of the children, using Kahn's algorithm
     // to avoid recursion.
@@ -983,7 +1290,16 @@ void ShaderGraph::topologicalSort()
         // adding node to the queue if in-degrees becomes 0.
         for (const auto& output : node->getOutputs())
         {
-            for (const auto& input : output->getConnections())
+            vector<ShaderInput*> connections(output->getConnections().begin(), output->getConnections().end());
+            if (orderByName)
+            {
+                std::sort(connections.begin(), connections.end(), [](const ShaderInput* a, const ShaderInput* b)
+                {
+                    int nodeOrder = a->getNode()->getName().compare(b->getNode()->getName());
+                    return nodeOrder != 0 ? nodeOrder < 0 : a->getName() < b->getName();
+                });
+            }
+            for (const auto& input : connections)
             {
                 if (input->getNode() != this)
                 {
@@ -1074,6 +1390,8 @@ void ShaderGraph::calculateScopes()
 
 void ShaderGraph::setVariableNames(GenContext& context)
 {
+    MATERIALX_GEN_PROFILE_SCOPE(context, "setVariableNames");
+
     // Make sure inputs and outputs have variable names valid for the
     // target shading language, and are unique to avoid name conflicts.
 
@@ -1107,6 +1425,29 @@ void ShaderGraph::setVariableNames(GenContext& context)
     }
 }
 
+void ShaderGraph::addIdentifiers(GenContext& context) const
+{
+    for (const ShaderGraphInputSocket* inputSocket : getInputSockets())
+    {
+        context.addIdentifier(inputSocket->getVariable());
+    }
+    for (const ShaderGraphOutputSocket* outputSocket : getOutputSockets())
+    {
+        context.addIdentifier(outputSocket->getVariable());
+    }
+    for (const ShaderNode* node : getNodes())
+    {
+        for (const ShaderInput* input : node->getInputs())
+        {
+            context.addIdentifier(input->getVariable());
+        }
+        for (const ShaderOutput* output : node->getOutputs())
+        {
+            context.addIdentifier(output->getVariable());
+        }
+    }
+}
+
 void ShaderGraph::populateInputColorTransformMap(ColorManagementSystemPtr colorManagementSystem, ShaderNodePtr shaderNode, ValueElementPtr input, const string& targetColorSpace)
 {
     ShaderInput* shaderInput = shaderNode->getInput(input->getName());
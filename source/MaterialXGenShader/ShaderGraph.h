@@ -101,6 +101,10 @@ class ShaderGraph : public ShaderNode
     /// Return an iterator for traversal upstream from the given output
     static ShaderGraphEdgeIterator traverseUpstream(ShaderOutput* output);
 
+    /// Add the variable names of the graph to the identifiers in use by the
+    /// given context, as required when generating code from an existing graph.
+    void addIdentifiers(GenContext& context) const;
+
   protected:
     /// Add input sockets from an interface element (nodedef, nodegraph or node)
     void addInputSockets(const InterfaceElement& elem, GenContext& context);
@@ -128,14 +132,26 @@ class ShaderGraph : public ShaderNode
     /// Optimize the graph, removing redundant paths.
     void optimize(GenContext& context);
 
+    /// Fold math nodes with constant inputs into values pushed downstream,
+    /// returning the number of nodes folded.
+    size_t foldConstants(GenContext& context);
+
+    /// Merge nodes computing the same expression from the same inputs,
+    /// returning the number of nodes merged.
+    size_t mergeDuplicates(GenContext& context);
+
     /// Bypass a node for a particular input and output,
     /// effectively connecting the input's upstream connection
     /// with the output's downstream connections.
     void bypass(GenContext& context, ShaderNode* node, size_t inputIndex, size_t outputIndex = 0);
 
     /// Sort the nodes in topological order.
+    /// @param orderByName If true, then the downstream connections of each
+    ///    output are visited in order of node and input name, so that the
+    ///    order does not depend on node addresses.  If false, then they are
+    ///    visited in address order.
     /// @throws ExceptionFoundCycle if a cycle is encountered.
-    void topologicalSort();
+    void topologicalSort(bool orderByName);
 
     /// Calculate scopes for all nodes in the graph
     void calculateScopes();
@@ -194,11 +194,18 @@ void ShaderNode::ScopeInfo::merge(const ScopeInfo &fromScope)
 ShaderNodePtr ShaderNode::create(const ShaderGraph* parent, const string& name, const NodeDef& nodeDef, GenContext& context)
 {
     ShaderNodePtr newNode = std::make_shared<ShaderNode>(parent, name);
+    newNode->_category = nodeDef.getNodeString();
+    MATERIALX_GEN_PROFILE_COUNT(context, "nodesCreated", 1);
+    MATERIALX_GEN_PROFILE_COUNT(context, "nodesCreated/" + newNode->_category, 1);
 
     const ShaderGenerator& shadergen = context.getShaderGenerator();
 
     // Find the implementation for this nodedef
-    InterfaceElementPtr impl = nodeDef.getImplementation(shadergen.getTarget(), shadergen.getLanguage());
+    InterfaceElementPtr impl;
+    {
+        MATERIALX_GEN_PROFILE_SCOPE(context, "NodeDef::getImplementation");
+        impl = nodeDef.getImplementation(shadergen.getTarget(), shadergen.getLanguage());
+    }
     if (impl)
     {
         newNode->_impl = shadergen.getImplementation(*impl, context);
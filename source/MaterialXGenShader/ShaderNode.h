@@ -303,6 +303,13 @@ class ShaderNode
         return _name;
     }
 
+    /// Return the category of this node, as given by its nodedef,
+    /// or an empty string if the node was not created from a nodedef.
+    const string& getCategory() const
+    {
+        return _category;
+    }
+
     /// Return the implementation used for this node.
     const ShaderNodeImpl& getImplementation() const
     {
@@ -379,6 +386,7 @@ class ShaderNode
   protected:
     const ShaderGraph* _parent;
     string _name;
+    string _category;
     unsigned int _classification;
 
     std::unordered_map<string, ShaderInputPtr> _inputMap;
@@ -7,12 +7,15 @@
 
 #include <MaterialXGenShader/GenContext.h>
 #include <MaterialXGenShader/Syntax.h>
+#include <MaterialXGenShader/TokenTable.h>
 #include <MaterialXGenShader/Util.h>
 
 #include <MaterialXCore/Document.h>
 #include <MaterialXCore/Node.h>
 #include <MaterialXCore/Value.h>
 
+#include <algorithm>
+
 namespace MaterialX
 {
 
@@ -87,6 +90,18 @@ void VariableBlock::add(ShaderPortPtr port)
     }
 }
 
+const VariableBlock::BufferEntry* VariableBlock::findBufferEntry(const string& name) const
+{
+    for (const BufferEntry& entry : _bufferLayout)
+    {
+        if (entry.variable->getName() == name)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
 //
 // ShaderStage methods
 //
@@ -95,10 +110,45 @@ ShaderStage::ShaderStage(const string& name, ConstSyntaxPtr syntax) :
     _name(name),
     _syntax(syntax),
     _indentations(0),
-    _constants("Constants", "cn")
+    _constants("Constants", "cn"),
+    _codeValid(false)
 {
 }
 
+const string& ShaderStage::getSourceCode() const
+{
+    // A single segment of owned text, as left by token replacement,
+    // is returned directly without being copied.
+    if (_segments.empty() || (_segments.size() == 1 && !_segments[0].line))
+    {
+        return _text;
+    }
+
+    if (!_codeValid)
+    {
+        size_t length = 0;
+        for (const CodeSegment& segment : _segments)
+        {
+            length += segment.length;
+        }
+        _code.clear();
+        _code.reserve(length);
+        for (const CodeSegment& segment : _segments)
+        {
+            if (segment.line)
+            {
+                _code += segment.line->code;
+            }
+            else
+            {
+                _code.append(_text, segment.offset, segment.length);
+            }
+        }
+        _codeValid = true;
+    }
+    return _code;
+}
+
 VariableBlockPtr ShaderStage::createUniformBlock(const string& name, const string& instance)
 {
     auto it = _uniforms.find(name);
@@ -195,15 +245,18 @@ void ShaderStage::beginScope(Syntax::Punctuation punc)
     switch (punc) {
     case Syntax::CURLY_BRACKETS:
         beginLine();
-        _code += "{" + _syntax->getNewline();
+        appendText("{");
+        appendText(_syntax->getNewline());
         break;
     case Syntax::PARENTHESES:
         beginLine();
-        _code += "(" + _syntax->getNewline();
+        appendText("(");
+        appendText(_syntax->getNewline());
         break;
     case Syntax::SQUARE_BRACKETS:
         beginLine();
-        _code += "[" + _syntax->getNewline();
+        appendText("[");
+        appendText(_syntax->getNewline());
         break;
     }
 
@@ -225,28 +278,28 @@ void ShaderStage::endScope(bool semicolon, bool newline)
     switch (punc) {
     case Syntax::CURLY_BRACKETS:
         beginLine();
-        _code += "}";
+        appendText("}");
         break;
     case Syntax::PARENTHESES:
         beginLine();
-        _code += ")";
+        appendText(")");
         break;
     case Syntax::SQUARE_BRACKETS:
         beginLine();
-        _code += "]";
+        appendText("]");
         break;
     }
     if (semicolon)
-        _code += ";";
+        appendText(";");
     if (newline)
-        _code += _syntax->getNewline();
+        appendText(_syntax->getNewline());
 }
 
 void ShaderStage::beginLine()
 {
     for (int i = 0; i < _indentations; ++i)
     {
-        _code += _syntax->getIndentation();
+        appendText(_syntax->getIndentation());
     }
 }
 
@@ -254,19 +307,19 @@ void ShaderStage::endLine(bool semicolon)
 {
     if (semicolon)
     {
-        _code += ";";
+        appendText(";");
     }
     newLine();
 }
 
 void ShaderStage::newLine()
 {
-    _code += _syntax->getNewline();
+    appendText(_syntax->getNewline());
 }
 
 void ShaderStage::addString(const string& str)
 {
-    _code += str;
+    appendText(str);
 }
 
 void ShaderStage::addLine(const string& str, bool semicolon)
@@ -279,7 +332,8 @@ void ShaderStage::addLine(const string& str, bool semicolon)
 void ShaderStage::addComment(const string& str)
 {
     beginLine();
-    _code += _syntax->getSingleLineComment() + str;
+    appendText(_syntax->getSingleLineComment());
+    appendText(str);
     endLine(false);
 }
 
@@ -321,26 +375,268 @@ void ShaderStage::addInclude(const string& file, GenContext& context)
 
     if (!_includes.count(path))
     {
-        string content;
-        if (!readFile(path, content))
+        ConstSourceFilePtr sourceFile = context.getSourceCache()->getSourceFile(path, *_syntax);
+        if (!sourceFile)
         {
             throw ExceptionShaderGenError("Could not find include file: '" + file + "'");
         }
         _includes.insert(path);
-        addBlock(content, context);
+        if (_recording)
+        {
+            _recording->includes.insert(path);
+        }
+        addSourceFile(sourceFile, context);
+    }
+    else if (_recording && !_recording->includes.count(path))
+    {
+        _recording->skippedIncludes.insert(path);
+    }
+}
+
+void ShaderStage::addSourceFile(ConstSourceFilePtr file, GenContext& context)
+{
+    // Keep the file alive for as long as its lines are referenced.
+    _sourceFiles.push_back(file);
+
+    for (const SourceFile::Line& line : file->getLines())
+    {
+        if (line.include.empty())
+        {
+            beginLine();
+            appendLine(line);
+            endLine(false);
+        }
+        else
+        {
+            addInclude(line.include, context);
+        }
     }
 }
 
 void ShaderStage::addFunctionDefinition(const ShaderNode& node, GenContext& context)
 {
     const ShaderNodeImpl& impl = node.getImplementation();
-    const size_t id = impl.getHash();
-
-    if (!_definedFunctions.count(id))
+    if (_definedFunctions.insert(impl.getHash()).second)
     {
-        _definedFunctions.insert(id);
+        if (_recording)
+        {
+            _recording->definedFunctions.insert(impl.getHash());
+        }
         impl.emitFunctionDefinition(node, context, *this);
     }
+    else if (_recording && !_recording->definedFunctions.count(impl.getHash()))
+    {
+        _recording->skippedFunctions.insert(impl.getHash());
+    }
+}
+
+EmittedCodePtr ShaderStage::beginRecording()
+{
+    _recording = std::make_shared<EmittedCode>();
+    _recording->startIndentations = _indentations;
+    _recording->startSegment = _segments.size();
+    _recording->startText = _text.size();
+    _recording->startSourceFile = _sourceFiles.size();
+    return _recording;
+}
+
+void ShaderStage::endRecording()
+{
+    EmittedCode& code = *_recording;
+
+    // Start from the last segment before the recording, as owned text
+    // appended during the recording may have extended it.
+    for (size_t i = code.startSegment > 0 ? code.startSegment - 1 : 0; i < _segments.size(); i++)
+    {
+        const CodeSegment& segment = _segments[i];
+        if (segment.line)
+        {
+            if (i >= code.startSegment)
+            {
+                code.code.push_back(std::make_pair(segment.line, EMPTY_STRING));
+            }
+        }
+        else
+        {
+            size_t begin = std::max(segment.offset, code.startText);
+            size_t end = segment.offset + segment.length;
+            if (end > begin)
+            {
+                code.code.push_back(std::make_pair(nullptr, _text.substr(begin, end - begin)));
+            }
+        }
+    }
+    code.sourceFiles.assign(_sourceFiles.begin() + code.startSourceFile, _sourceFiles.end());
+    _recording = nullptr;
+}
+
+bool ShaderStage::addEmittedCode(const EmittedCode& code)
+{
+    if (code.startIndentations != _indentations)
+    {
+        return false;
+    }
+    for (const string& include : code.includes)
+    {
+        if (_includes.count(include))
+        {
+            return false;
+        }
+    }
+    for (const string& include : code.skippedIncludes)
+    {
+        if (!_includes.count(include))
+        {
+            return false;
+        }
+    }
+    for (size_t hash : code.definedFunctions)
+    {
+        if (_definedFunctions.count(hash))
+        {
+            return false;
+        }
+    }
+    for (size_t hash : code.skippedFunctions)
+    {
+        if (!_definedFunctions.count(hash))
+        {
+            return false;
+        }
+    }
+
+    for (const auto& piece : code.code)
+    {
+        if (piece.first)
+        {
+            appendLine(*piece.first);
+        }
+        else
+        {
+            appendText(piece.second);
+        }
+    }
+    _sourceFiles.insert(_sourceFiles.end(), code.sourceFiles.begin(), code.sourceFiles.end());
+    _includes.insert(code.includes.begin(), code.includes.end());
+    _definedFunctions.insert(code.definedFunctions.begin(), code.definedFunctions.end());
+    return true;
+}
+
+void ShaderStage::appendText(const string& str)
+{
+    if (str.empty())
+    {
+        return;
+    }
+
+    for (size_t pos = str.find(TOKEN_PREFIX); pos != string::npos; pos = str.find(TOKEN_PREFIX, pos + 1))
+    {
+        _textTokens.push_back(_text.size() + pos);
+    }
+
+    // Extend the last segment if it ends with the owned text.
+    if (!_segments.empty() && !_segments.back().line)
+    {
+        _segments.back().length += str.size();
+    }
+    else
+    {
+        _segments.push_back({ nullptr, _text.size(), str.size() });
+    }
+    _text += str;
+    _codeValid = false;
+}
+
+void ShaderStage::appendLine(const SourceFile::Line& line)
+{
+    if (line.code.empty())
+    {
+        return;
+    }
+    _segments.push_back({ &line, 0, line.code.size() });
+    _codeValid = false;
+}
+
+void ShaderStage::replaceTokens(const TokenTable& substitutions)
+{
+    size_t length = 0;
+    for (const CodeSegment& segment : _segments)
+    {
+        length += segment.length;
+    }
+
+    string text;
+    text.reserve(length);
+    vector<size_t> textTokens;
+
+    // Owned segments are ordered by offset, so a single cursor walks
+    // the tokens of the owned text.
+    size_t ownedToken = 0;
+    for (const CodeSegment& segment : _segments)
+    {
+        const string& source = segment.line ? segment.line->code : _text;
+        const size_t begin = segment.offset;
+        const size_t end = segment.offset + segment.length;
+
+        const size_t* tokens;
+        size_t tokenCount;
+        if (segment.line)
+        {
+            tokens = segment.line->tokens.data();
+            tokenCount = segment.line->tokens.size();
+        }
+        else
+        {
+            while (ownedToken < _textTokens.size() && _textTokens[ownedToken] < begin)
+            {
+                ++ownedToken;
+            }
+            size_t last = ownedToken;
+            while (last < _textTokens.size() && _textTokens[last] < end)
+            {
+                ++last;
+            }
+            tokens = _textTokens.data() + ownedToken;
+            tokenCount = last - ownedToken;
+            ownedToken = last;
+        }
+
+        size_t pos = begin;
+        for (size_t i = 0; i < tokenCount; ++i)
+        {
+            const size_t start = tokens[i];
+            const size_t tokenEnd = TokenTable::tokenEnd(source, start, end);
+
+            text.append(source, pos, start - pos);
+            const string* value = substitutions.find(source.data() + start + 1, tokenEnd - start - 1);
+            if (value)
+            {
+                for (size_t p = value->find(TOKEN_PREFIX); p != string::npos; p = value->find(TOKEN_PREFIX, p + 1))
+                {
+                    textTokens.push_back(text.size() + p);
+                }
+                text += *value;
+            }
+            else
+            {
+                textTokens.push_back(text.size());
+                text.append(source, start, tokenEnd - start);
+            }
+            pos = tokenEnd;
+        }
+        text.append(source, pos, end - pos);
+    }
+
+    _text.swap(text);
+    _textTokens.swap(textTokens);
+    _segments.clear();
+    if (!_text.empty())
+    {
+        _segments.push_back({ nullptr, 0, _text.size() });
+    }
+    _sourceFiles.clear();
+    _code.clear();
+    _codeValid = false;
 }
 
 }
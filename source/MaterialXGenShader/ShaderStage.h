@@ -13,6 +13,7 @@
 
 #include <MaterialXGenShader/GenOptions.h>
 #include <MaterialXGenShader/ShaderGraph.h>
+#include <MaterialXGenShader/SourceCache.h>
 #include <MaterialXGenShader/Syntax.h>
 
 #include <MaterialXCore/Library.h>
@@ -21,6 +22,7 @@
 #include <queue>
 #include <sstream>
 #include <unordered_map>
+#include <unordered_set>
 
 /// Macro for being/end of statements to be picked up by a given shader stage.
 /// For shaders that are multi-stage all code generation statements adding code 
@@ -56,10 +58,23 @@ using ShaderPortPredicate = std::function<bool(ShaderPort*)>;
 /// A block of variables in a shader stage
 class VariableBlock
 {
+  public:
+    /// The placement of a variable within the buffer layout of a block.
+    /// The offset and stride are given in bytes, where the stride is the
+    /// distance between consecutive array elements or matrix columns,
+    /// and is zero for other types.
+    struct BufferEntry
+    {
+        ShaderPort* variable;
+        size_t offset;
+        size_t stride;
+    };
+
   public:
     VariableBlock(const string& name, const string& instance) :
         _name(name),
-        _instance(instance)
+        _instance(instance),
+        _bufferSize(0)
     {}
 
     /// Get the name of this block.
@@ -114,13 +129,74 @@ class VariableBlock
     /// Add an existing shader port to this block.
     void add(ShaderPortPtr port);
 
+    /// Set the buffer layout of this block, giving the placement of each
+    /// variable stored in the buffer and the total size of the buffer in
+    /// bytes. Variables not listed in the layout are not part of the buffer.
+    void setBufferLayout(const vector<BufferEntry>& layout, size_t size)
+    {
+        _bufferLayout = layout;
+        _bufferSize = size;
+    }
+
+    /// Return true if a buffer layout has been set on this block.
+    bool hasBufferLayout() const { return !_bufferLayout.empty(); }
+
+    /// Return the buffer layout of this block, ordered by offset.
+    const vector<BufferEntry>& getBufferLayout() const { return _bufferLayout; }
+
+    /// Return the size in bytes of the buffer holding this block.
+    size_t getBufferSize() const { return _bufferSize; }
+
+    /// Return the buffer entry for a variable by name, or nullptr if
+    /// the variable is not part of the buffer layout.
+    const BufferEntry* findBufferEntry(const string& name) const;
+
   private:
     string _name;
     string _instance;
     std::unordered_map<string, ShaderPortPtr> _variableMap;
     vector<ShaderPort*> _variableOrder;
+    vector<BufferEntry> _bufferLayout;
+    size_t _bufferSize;
+};
+
+
+/// @struct EmittedCode
+/// Code emitted into a shader stage between calls to ShaderStage::beginRecording
+/// and ShaderStage::endRecording, which can be added to further stages without
+/// being emitted again.
+struct EmittedCode
+{
+    /// The code in order, each piece either a line of a source file, or
+    /// text owned by the recording when the line is nullptr.
+    vector<std::pair<const SourceFile::Line*, string>> code;
+
+    /// Source files referenced by the lines of the code.
+    vector<ConstSourceFilePtr> sourceFiles;
+
+    /// Files included, and hash ID's of the functions defined, by the code.
+    StringSet includes;
+    std::unordered_set<size_t> definedFunctions;
+
+    /// Files and functions the code would have added, had they not already
+    /// been part of the stage.  The code is only added to stages which hold
+    /// all of these, and none of the files and functions added by the code.
+    StringSet skippedIncludes;
+    std::unordered_set<size_t> skippedFunctions;
+
+    /// Indentation level, and positions within the stage, at the start
+    /// of the recording.
+    int startIndentations = 0;
+    size_t startSegment = 0;
+    size_t startText = 0;
+    size_t startSourceFile = 0;
 };
 
+/// Shared pointer to an EmittedCode
+using EmittedCodePtr = shared_ptr<EmittedCode>;
+
+/// Shared pointer to a constant EmittedCode
+using ConstEmittedCodePtr = shared_ptr<const EmittedCode>;
 
 /// @class ShaderStage
 /// A shader stage, containing the state and 
@@ -138,7 +214,13 @@ class ShaderStage
     const string& getFunctionName() const { return _functionName; }
 
     /// Return the stage source code.
-    const string& getSourceCode() const { return _code; }
+    const string& getSourceCode() const;
+
+    /// Return the resolved paths of all files included by the stage.
+    const StringSet& getIncludes() const
+    {
+        return _includes;
+    }
 
     /// Create a new uniform variable block.
     VariableBlockPtr createUniformBlock(const string& name, const string& instance = EMPTY_STRING);
@@ -223,24 +305,61 @@ class ShaderStage
     /// only included once for the shader stage.
     void addInclude(const string& file, GenContext& context);
 
+    /// Add the lines of a parsed source file, adding the contents
+    /// of the files it includes in place of its include statements.
+    /// The lines are referenced rather than copied into the stage.
+    void addSourceFile(ConstSourceFilePtr file, GenContext& context);
+
     /// Add a value.
     template<typename T>
     void addValue(const T& value)
     {
         StringStream str;
         str << value;
-        _code += str.str();
+        appendText(str.str());
     }
 
     /// Add the function definition for a node.
     void addFunctionDefinition(const ShaderNode& node, GenContext& context);
 
+    /// Begin recording the code emitted into the stage.
+    EmittedCodePtr beginRecording();
+
+    /// End the current recording, storing the code emitted since it began.
+    void endRecording();
+
+    /// Add code recorded from another stage, if it would have been emitted
+    /// the same way into this stage.  Returns false, leaving the stage
+    /// unchanged, if not.
+    bool addEmittedCode(const EmittedCode& code);
+
     /// Set stage function name.
     void setFunctionName(const string& functionName) 
     { 
         _functionName = functionName;
     }
 
+  private:
+    /// A contiguous range of the stage source code, either referencing
+    /// a line of a source file or a range of the text owned by the stage.
+    struct CodeSegment
+    {
+        const SourceFile::Line* line;
+        size_t offset;
+        size_t length;
+    };
+
+    /// Append a string to the text owned by the stage.
+    void appendText(const string& str);
+
+    /// Append a reference to a line of a source file.
+    void appendLine(const SourceFile::Line& line);
+
+    /// Replace tokens in the source code in a single pass over all
+    /// segments, leaving the result as a single segment of owned text.
+    /// Tokens do not extend across segment boundaries.
+    void replaceTokens(const TokenTable& substitutions);
+
   private:
     /// Name of the stage
     const string _name;
@@ -261,7 +380,10 @@ class ShaderStage
     StringSet _includes;
 
     /// Set of hash ID's for functions that has been defined.
-    std::set<size_t> _definedFunctions;
+    std::unordered_set<size_t> _definedFunctions;
+
+    /// Code being recorded, if any.
+    EmittedCodePtr _recording;
 
     /// Block holding constant variables for this stage.
     VariableBlock _constants;
@@ -275,8 +397,20 @@ class ShaderStage
     /// Map of blocks holding output variables for this stage.
     VariableBlockMap _outputs;
 
-    /// Resulting source code for this stage.
-    string _code;
+    /// Text owned by the stage, and the positions of the tokens within it.
+    string _text;
+    vector<size_t> _textTokens;
+
+    /// Segments making up the source code, in order.
+    vector<CodeSegment> _segments;
+
+    /// Source files referenced by the segments.
+    vector<ConstSourceFilePtr> _sourceFiles;
+
+    /// Resulting source code for this stage, assembled from the segments
+    /// when more than a single segment of owned text is present.
+    mutable string _code;
+    mutable bool _codeValid;
 
     friend class ShaderGenerator;
 };
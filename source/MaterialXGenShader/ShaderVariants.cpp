@@ -0,0 +1,128 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/ShaderVariants.h>
+
+#include <MaterialXGenShader/ShaderGenerator.h>
+
+namespace MaterialX
+{
+
+const string SharedShaderGraph::USER_DATA_NAME = "sharedgraph";
+
+namespace {
+
+// Return a key identifying the options that are read while shader graphs
+// are built, by ShaderGraph::create and the setValues methods of node
+// implementations.
+string getGraphKey(const GenOptions& options)
+{
+    return std::to_string(options.shaderInterfaceType) + "," +
+           std::to_string(options.optimizeGraphExpressions) + "," +
+           std::to_string(options.hwNormalizeUdimTexCoords) + "," +
+           options.targetColorSpaceOverride;
+}
+
+// Return a key identifying the stage and the options that are read while
+// the function definitions of shader graphs are emitted.
+string getFunctionDefinitionKey(const string& stage, const GenOptions& options)
+{
+    return stage + "," +
+           std::to_string(options.hwTransparency) + "," +
+           std::to_string(options.fileTextureVerticalFlip);
+}
+
+} // anonymous namespace
+
+//
+// SharedShaderGraph methods
+//
+
+void SharedShaderGraph::addFunctionDefinitions(const string& stage, const GenOptions& options, ConstEmittedCodePtr code)
+{
+    _functionDefinitions[getFunctionDefinitionKey(stage, options)].push_back(code);
+    _functionDefinitionCount++;
+}
+
+const vector<ConstEmittedCodePtr>& SharedShaderGraph::getFunctionDefinitions(const string& stage, const GenOptions& options) const
+{
+    static const vector<ConstEmittedCodePtr> EMPTY_DEFINITIONS;
+    auto it = _functionDefinitions.find(getFunctionDefinitionKey(stage, options));
+    return it != _functionDefinitions.end() ? it->second : EMPTY_DEFINITIONS;
+}
+
+//
+// ShaderVariants methods
+//
+
+void ShaderVariants::generate(const string& name, ElementPtr element, const vector<ShaderPermutation>& permutations,
+                              const GenContext& context)
+{
+    _shaders.clear();
+    _sourceIndices.clear();
+    _sources.clear();
+    _functionDefinitionCount = 0;
+
+    std::unordered_map<string, shared_ptr<SharedShaderGraph>> sharedGraphs;
+    std::unordered_map<string, size_t> sourceIndices;
+    for (const ShaderPermutation& permutation : permutations)
+    {
+        GenContext variantContext = context.fork();
+        variantContext.getOptions() = permutation.options;
+        for (const auto& userData : permutation.userData)
+        {
+            variantContext.pushUserData(userData.first, userData.second);
+        }
+
+        shared_ptr<SharedShaderGraph>& sharedGraph = sharedGraphs[getGraphKey(permutation.options)];
+        if (!sharedGraph)
+        {
+            sharedGraph = SharedShaderGraph::create();
+        }
+        variantContext.pushUserData(SharedShaderGraph::USER_DATA_NAME, sharedGraph);
+
+        ShaderPtr shader = context.getShaderGenerator().generate(name, element, variantContext);
+        _shaders.push_back(shader);
+
+        // Store each distinct stage source code once.
+        std::unordered_map<string, size_t> stageIndices;
+        for (size_t i = 0; i < shader->numStages(); i++)
+        {
+            const ShaderStage& stage = shader->getStage(i);
+            auto it = sourceIndices.insert(std::make_pair(stage.getSourceCode(), _sources.size()));
+            if (it.second)
+            {
+                _sources.push_back(stage.getSourceCode());
+            }
+            stageIndices[stage.getName()] = it.first->second;
+        }
+        _sourceIndices.push_back(stageIndices);
+    }
+    _graphCount = sharedGraphs.size();
+    for (const auto& sharedGraph : sharedGraphs)
+    {
+        _functionDefinitionCount += sharedGraph.second->getFunctionDefinitionCount();
+    }
+}
+
+const string& ShaderVariants::getSourceCode(size_t index, const string& stage) const
+{
+    const std::unordered_map<string, size_t>& stageIndices = _sourceIndices[index];
+    auto it = stageIndices.find(stage);
+    return it != stageIndices.end() ? _sources[it->second] : EMPTY_STRING;
+}
+
+size_t ShaderVariants::getSourceIndex(size_t index, const string& stage) const
+{
+    const std::unordered_map<string, size_t>& stageIndices = _sourceIndices[index];
+    auto it = stageIndices.find(stage);
+    if (it == stageIndices.end())
+    {
+        throw ExceptionShaderGenError("Shader variant has no stage named '" + stage + "'");
+    }
+    return it->second;
+}
+
+} // namespace MaterialX
@@ -0,0 +1,188 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_SHADERVARIANTS_H
+#define MATERIALX_SHADERVARIANTS_H
+
+/// @file
+/// Generation of shader variants with shared graph construction
+
+#include <MaterialXGenShader/Library.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/Shader.h>
+
+namespace MaterialX
+{
+
+/// @struct ShaderPermutation
+/// A permutation of the options and user data used to generate a shader.
+struct ShaderPermutation
+{
+    /// The options used to generate the shader.
+    GenOptions options;
+
+    /// User data pushed to the context while generating the shader, such as
+    /// light shaders bound with HwShaderGenerator::bindLightShader, given as
+    /// pairs of user data names and user data.
+    vector<std::pair<string, GenUserDataPtr>> userData;
+};
+
+/// @class SharedShaderGraph
+/// User data holding the shader graph of an element, allowing shader
+/// generators to reuse the graph for further shaders of the same element
+/// rather than building it again.
+///
+/// When this user data is present, ShaderGenerator::createShaderGraph keeps
+/// the first graph it creates for an element, and returns the same graph
+/// for later shaders of that element and name.  The graph is not modified
+/// during code generation, so it may be shared by several shaders, as long
+/// as they are generated with the same options affecting graph construction.
+///
+/// The function definitions emitted for the graph into each stage are kept
+/// as well, and ShaderGenerator::emitFunctionDefinitions adds them to the
+/// stages of later shaders rather than emitting them again, when the stage
+/// is in the same state and the options read during their emission match.
+class SharedShaderGraph : public GenUserData
+{
+  public:
+    SharedShaderGraph() { }
+
+    /// Create and return new shared graph user data.
+    static shared_ptr<SharedShaderGraph> create()
+    {
+        return std::make_shared<SharedShaderGraph>();
+    }
+
+    /// Set the shader graph built for the given element and shader name.
+    void setGraph(ShaderGraphPtr graph, ConstElementPtr element, const string& name)
+    {
+        _graph = graph;
+        _element = element;
+        _name = name;
+    }
+
+    /// Return the shader graph built for the given element and shader name,
+    /// or nullptr if no such graph has been set.
+    ShaderGraphPtr getGraph(ConstElementPtr element, const string& name) const
+    {
+        return (element == _element && name == _name) ? _graph : nullptr;
+    }
+
+    /// Return true if the given graph is the shared graph.
+    bool isGraph(const ShaderGraph& graph) const
+    {
+        return &graph == _graph.get();
+    }
+
+    /// Add the function definitions emitted for the shared graph into the
+    /// given stage with the given options.
+    void addFunctionDefinitions(const string& stage, const GenOptions& options, ConstEmittedCodePtr code);
+
+    /// Return the function definitions emitted for the shared graph into
+    /// the given stage with the given options.
+    const vector<ConstEmittedCodePtr>& getFunctionDefinitions(const string& stage, const GenOptions& options) const;
+
+    /// Return the number of function definition blocks emitted for the
+    /// shared graph.
+    size_t getFunctionDefinitionCount() const
+    {
+        return _functionDefinitionCount;
+    }
+
+    /// The name of this user data in generation contexts.
+    static const string USER_DATA_NAME;
+
+  private:
+    ShaderGraphPtr _graph;
+    ConstElementPtr _element;
+    string _name;
+    std::unordered_map<string, vector<ConstEmittedCodePtr>> _functionDefinitions;
+    size_t _functionDefinitionCount = 0;
+};
+
+/// @class ShaderVariants
+/// The variants of a shader generated for a set of permutations of the
+/// generation options, with shared graph construction.
+///
+/// Permutations differing only in options that do not affect the shader
+/// graph share a single graph, so that the element is translated into a
+/// graph once for each distinct combination of the shader interface type,
+/// target color space override, UDIM texture coordinate normalization and
+/// graph optimization options.  The function definitions emitted for a
+/// shared graph are shared as well, between variants that also agree on the
+/// transparency and texture orientation options, and that emit the same
+/// includes and functions ahead of the definitions.  The rest of each stage is
+/// generated for each variant, and identical stage source code is
+/// deduplicated once generation is complete.
+class ShaderVariants
+{
+  public:
+    ShaderVariants() :
+        _graphCount(0),
+        _functionDefinitionCount(0)
+    {
+    }
+    ~ShaderVariants() { }
+
+    /// Generate a variant of the shader for the given element for each of
+    /// the given permutations, using the shader generator of the given
+    /// context.  Each variant is generated on a fork of the context, with
+    /// the options and user data of its permutation.
+    void generate(const string& name, ElementPtr element, const vector<ShaderPermutation>& permutations,
+                  const GenContext& context);
+
+    /// Return the number of variants.
+    size_t size() const
+    {
+        return _shaders.size();
+    }
+
+    /// Return the shader generated for the permutation at the given index.
+    ShaderPtr getShader(size_t index) const
+    {
+        return _shaders[index];
+    }
+
+    /// Return the source code of the given stage of the variant at the
+    /// given index, or an empty string if the variant has no such stage.
+    const string& getSourceCode(size_t index, const string& stage) const;
+
+    /// Return the index of the source code of the given stage of the variant
+    /// at the given index within the distinct source code of all variants.
+    /// Variants with identical code for a stage share the same index.
+    /// Throws an exception if the variant has no such stage.
+    size_t getSourceIndex(size_t index, const string& stage) const;
+
+    /// Return the distinct source code of all stages of all variants.
+    const StringVec& getSources() const
+    {
+        return _sources;
+    }
+
+    /// Return the number of shader graphs built for the variants.
+    size_t getGraphCount() const
+    {
+        return _graphCount;
+    }
+
+    /// Return the number of function definition blocks emitted for the
+    /// variants, each of which is shared by all variants it applies to.
+    size_t getFunctionDefinitionCount() const
+    {
+        return _functionDefinitionCount;
+    }
+
+  private:
+    vector<ShaderPtr> _shaders;
+    vector<std::unordered_map<string, size_t>> _sourceIndices;
+    StringVec _sources;
+    size_t _graphCount;
+    size_t _functionDefinitionCount;
+};
+
+} // namespace MaterialX
+
+#endif
@@ -0,0 +1,145 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/SourceCache.h>
+
+#include <MaterialXGenShader/Syntax.h>
+#include <MaterialXGenShader/Util.h>
+
+namespace MaterialX
+{
+
+//
+// SourceFile methods
+//
+
+SourceFile::SourceFile(const FilePath& path, const string& contents, const Syntax& syntax) :
+    _path(path),
+    _contents(contents)
+{
+    Hasher hasher;
+    hasher.add(_contents);
+    _hash = hasher.getValue();
+
+    const string& INCLUDE = syntax.getIncludeStatement();
+    const string& QUOTE   = syntax.getStringQuote();
+
+    size_t start = 0;
+    while (start < _contents.size())
+    {
+        size_t end = _contents.find('\n', start);
+        if (end == string::npos)
+        {
+            end = _contents.size();
+        }
+        string line = _contents.substr(start, end - start);
+        start = end + 1;
+
+        size_t pos = line.find(INCLUDE);
+        if (pos != string::npos)
+        {
+            // Store the filename of the include statement, skipping
+            // statements without a quoted filename.
+            size_t startQuote = line.find_first_of(QUOTE);
+            size_t endQuote = line.find_last_of(QUOTE);
+            if (startQuote != string::npos && endQuote != string::npos && endQuote > startQuote)
+            {
+                size_t length = (endQuote - startQuote) - 1;
+                if (length)
+                {
+                    _lines.push_back({ EMPTY_STRING, line.substr(startQuote + 1, length), {} });
+                }
+            }
+        }
+        else
+        {
+            vector<size_t> tokens;
+            for (size_t token = line.find(TOKEN_PREFIX); token != string::npos; token = line.find(TOKEN_PREFIX, token + 1))
+            {
+                tokens.push_back(token);
+            }
+            _lines.push_back({ line, EMPTY_STRING, tokens });
+        }
+    }
+}
+
+//
+// SourceCache methods
+//
+
+SourceCachePtr SourceCache::getGlobal()
+{
+    static SourceCachePtr cache = SourceCache::create();
+    return cache;
+}
+
+FilePath SourceCache::resolve(const FilePath& filename, const FileSearchPath& searchPath)
+{
+    const string key = searchPath.asString() + PATH_LIST_SEPARATOR + filename.asString();
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        auto it = _resolvedPaths.find(key);
+        if (it != _resolvedPaths.end())
+        {
+            return it->second;
+        }
+    }
+
+    // Search the file system outside of the lock, keeping the first
+    // result stored by any thread.
+    FilePath path = searchPath.find(filename);
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _resolvedPaths.insert(std::make_pair(key, path)).first->second;
+}
+
+ConstSourceFilePtr SourceCache::getSourceFile(const FilePath& path, const Syntax& syntax)
+{
+    // Files are parsed separately for each form of include statement.
+    const string key = path.asString() + '\n' + syntax.getIncludeStatement() + '\n' + syntax.getStringQuote();
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        auto it = _files.find(key);
+        if (it != _files.end())
+        {
+            return it->second;
+        }
+    }
+
+    // Read and parse the file outside of the lock, keeping the first
+    // result stored by any thread.  Files that cannot be read are cached
+    // as well, so that they are not searched for again.
+    ConstSourceFilePtr file;
+    string contents;
+    if (readFile(path.asString(), contents))
+    {
+        file = std::make_shared<SourceFile>(path, contents, syntax);
+    }
+    _readCount++;
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _files.insert(std::make_pair(key, file)).first->second;
+}
+
+ShaderNodeImplPtr SourceCache::findImplementation(const string& key)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    auto it = _impls.find(key);
+    return it != _impls.end() ? it->second : nullptr;
+}
+
+ShaderNodeImplPtr SourceCache::addImplementation(const string& key, ShaderNodeImplPtr impl)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _impls.insert(std::make_pair(key, impl)).first->second;
+}
+
+void SourceCache::clear()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _resolvedPaths.clear();
+    _files.clear();
+    _impls.clear();
+}
+
+} // namespace MaterialX
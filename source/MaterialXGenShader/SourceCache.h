@@ -0,0 +1,155 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_SOURCECACHE_H
+#define MATERIALX_SOURCECACHE_H
+
+/// @file
+/// Cache of parsed source code files
+
+#include <MaterialXGenShader/Library.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace MaterialX
+{
+
+class SourceFile;
+class SourceCache;
+class Syntax;
+
+/// Shared pointer to a constant SourceFile
+using ConstSourceFilePtr = shared_ptr<const SourceFile>;
+
+/// Shared pointer to a SourceCache
+using SourceCachePtr = shared_ptr<SourceCache>;
+
+/// @class SourceFile
+/// A source code file that has been read and split into lines, with each
+/// include statement parsed into the name of the file it includes.
+class SourceFile
+{
+  public:
+    /// A line of source code.  For include statements, the code is empty
+    /// and the included filename is given instead.  The positions of
+    /// substitution tokens within the code are recorded, so that tokens
+    /// can be replaced without searching each line again.
+    struct Line
+    {
+        string code;
+        string include;
+        vector<size_t> tokens;
+    };
+
+  public:
+    /// Construct a source file from its contents, using the given syntax to
+    /// recognize include statements.
+    SourceFile(const FilePath& path, const string& contents, const Syntax& syntax);
+    ~SourceFile() { }
+
+    /// Return the resolved path of the file.
+    const FilePath& getPath() const
+    {
+        return _path;
+    }
+
+    /// Return the full contents of the file.
+    const string& getContents() const
+    {
+        return _contents;
+    }
+
+    /// Return the lines of the file.
+    const vector<Line>& getLines() const
+    {
+        return _lines;
+    }
+
+    /// Return a hash of the contents of the file.
+    uint64_t getHash() const
+    {
+        return _hash;
+    }
+
+  private:
+    FilePath _path;
+    string _contents;
+    vector<Line> _lines;
+    uint64_t _hash;
+};
+
+/// @class SourceCache
+/// A thread-safe cache of source code files and their resolved paths.
+///
+/// Each file is resolved, read and parsed once, after which shader generation
+/// requires no further access to the file system.  By default each generation
+/// context has its own cache, shared with its forks, and contexts may opt in
+/// to sharing a cache such as the process-wide cache returned by getGlobal.
+/// The cache should be cleared when source files are added or edited on disk.
+///
+/// The cache also holds the source code implementations of nodes, keyed by a
+/// hash of everything that determines them, so that an implementation is
+/// created once and shared by all contexts and shader generators using the
+/// cache.
+class SourceCache
+{
+  public:
+    SourceCache() :
+        _readCount(0)
+    {
+    }
+    ~SourceCache() { }
+
+    /// Create and return a new source cache.
+    static SourceCachePtr create()
+    {
+        return std::make_shared<SourceCache>();
+    }
+
+    /// Return the process-wide source cache, which is only used by contexts
+    /// to which it has been explicitly assigned.
+    static SourceCachePtr getGlobal();
+
+    /// Resolve the given filename using the given search path, returning the
+    /// resolved path, or the filename itself if no file was found.
+    FilePath resolve(const FilePath& filename, const FileSearchPath& searchPath);
+
+    /// Return the source file at the given resolved path, parsed with the
+    /// given syntax, or nullptr if the file could not be read or is empty.
+    ConstSourceFilePtr getSourceFile(const FilePath& path, const Syntax& syntax);
+
+    /// Return the shared node implementation with the given key, or nullptr
+    /// if no implementation with the key has been added.
+    ShaderNodeImplPtr findImplementation(const string& key);
+
+    /// Add a node implementation under the given key, sharing it with all
+    /// users of the cache.  If an implementation with the given key was
+    /// already added, then the existing implementation is kept and returned.
+    ShaderNodeImplPtr addImplementation(const string& key, ShaderNodeImplPtr impl);
+
+    /// Remove all resolved paths, files and implementations from the cache.
+    void clear();
+
+    /// Return the number of files read from disk by this cache.
+    size_t getReadCount() const
+    {
+        return _readCount;
+    }
+
+  protected:
+    std::unordered_map<string, FilePath> _resolvedPaths;
+    std::unordered_map<string, ConstSourceFilePtr> _files;
+    std::unordered_map<string, ShaderNodeImplPtr> _impls;
+    std::atomic<size_t> _readCount;
+    std::mutex _mutex;
+};
+
+} // namespace MaterialX
+
+#endif
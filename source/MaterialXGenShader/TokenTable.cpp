@@ -0,0 +1,152 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/TokenTable.h>
+
+#include <MaterialXGenShader/Util.h>
+
+#include <cctype>
+#include <cstring>
+
+namespace MaterialX
+{
+
+namespace
+{
+
+// Number of times the table may double in size in search of
+// a layout without collisions.
+const int MAX_TABLE_GROWTH = 3;
+
+} // anonymous namespace
+
+TokenTable::TokenTable(const StringMap& substitutions) :
+    _mask(0)
+{
+    for (const auto& it : substitutions)
+    {
+        if (!it.first.empty() && it.first[0] == TOKEN_PREFIX)
+        {
+            _entries.push_back({ it.first.substr(1), it.second });
+        }
+    }
+    if (_entries.empty())
+    {
+        return;
+    }
+
+    vector<size_t> hashes;
+    for (const Entry& entry : _entries)
+    {
+        hashes.push_back(hash(entry.name.data(), entry.name.size()));
+    }
+
+    // Start with a load factor of at most one half, and grow the table
+    // until every name hashes to a separate slot.  Any collisions that
+    // remain are resolved by linear probing.
+    size_t size = 2;
+    while (size < _entries.size() * 2)
+    {
+        size *= 2;
+    }
+    for (int growth = 0; growth <= MAX_TABLE_GROWTH; ++growth, size *= 2)
+    {
+        _mask = size - 1;
+        _slots.assign(size, -1);
+        bool collision = false;
+        for (size_t i = 0; i < _entries.size(); ++i)
+        {
+            size_t slot = hashes[i] & _mask;
+            if (_slots[slot] >= 0)
+            {
+                collision = true;
+                while (_slots[slot] >= 0)
+                {
+                    slot = (slot + 1) & _mask;
+                }
+            }
+            _slots[slot] = (int) i;
+        }
+        if (!collision)
+        {
+            break;
+        }
+    }
+}
+
+size_t TokenTable::hash(const char* name, size_t length)
+{
+    // FNV-1a
+    size_t h = 2166136261u;
+    for (size_t i = 0; i < length; ++i)
+    {
+        h = (h ^ (unsigned char) name[i]) * 16777619u;
+    }
+    return h;
+}
+
+const string* TokenTable::find(const char* name, size_t length) const
+{
+    if (_entries.empty())
+    {
+        return nullptr;
+    }
+    for (size_t slot = hash(name, length) & _mask; _slots[slot] >= 0; slot = (slot + 1) & _mask)
+    {
+        const Entry& entry = _entries[_slots[slot]];
+        if (entry.name.size() == length && std::memcmp(entry.name.data(), name, length) == 0)
+        {
+            return &entry.value;
+        }
+    }
+    return nullptr;
+}
+
+size_t TokenTable::tokenEnd(const string& source, size_t start, size_t end)
+{
+    size_t pos = start + 1;
+    while (pos < end && isalnum((unsigned char) source[pos]))
+    {
+        ++pos;
+    }
+    return pos;
+}
+
+void TokenTable::substitute(string& source) const
+{
+    size_t start = source.find(TOKEN_PREFIX);
+    if (start == string::npos)
+    {
+        return;
+    }
+
+    const size_t length = source.size();
+    string result;
+    result.reserve(length + length / 4);
+    size_t pos = 0;
+    for (; start != string::npos; start = source.find(TOKEN_PREFIX, pos))
+    {
+        // A prefix at the very end of the source is kept as is.
+        if (start + 1 == length)
+        {
+            break;
+        }
+        result.append(source, pos, start - pos);
+        pos = tokenEnd(source, start, length);
+        const string* value = find(source.data() + start + 1, pos - start - 1);
+        if (value)
+        {
+            result += *value;
+        }
+        else
+        {
+            result.append(source, start, pos - start);
+        }
+    }
+    result.append(source, pos, string::npos);
+    source.swap(result);
+}
+
+} // namespace MaterialX
@@ -0,0 +1,74 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_TOKENTABLE_H
+#define MATERIALX_TOKENTABLE_H
+
+/// @file
+/// Compiled table of token substitutions
+
+#include <MaterialXGenShader/Library.h>
+
+namespace MaterialX
+{
+
+/// @class TokenTable
+/// A table of token substitutions, compiled from a substitution map for
+/// repeated use.
+///
+/// Tokens start with '$' and consist of the alphanumeric characters that
+/// follow it.  Token names are stored in an open-addressed hash table,
+/// sized where possible so that each name has a slot of its own, and the
+/// hash of a token is computed while scanning its name, so substitution
+/// is performed in a single pass without creating intermediate strings.
+class TokenTable
+{
+  public:
+    /// Construct an empty table.
+    TokenTable() :
+        _mask(0)
+    {
+    }
+
+    /// Construct a table from the given substitution map.  Keys that do
+    /// not start with '$' can never match a token and are ignored.
+    explicit TokenTable(const StringMap& substitutions);
+
+    ~TokenTable() { }
+
+    /// Return true if the table contains no substitutions.
+    bool empty() const
+    {
+        return _entries.empty();
+    }
+
+    /// Return the replacement for the token with the given name, not
+    /// including its '$' prefix, or nullptr if the token has no replacement.
+    const string* find(const char* name, size_t length) const;
+
+    /// Return the position one past the end of the token starting at the
+    /// given position, stopping at the given end position.
+    static size_t tokenEnd(const string& source, size_t start, size_t end);
+
+    /// Perform token substitution on the given string in place.
+    void substitute(string& source) const;
+
+  private:
+    struct Entry
+    {
+        string name;
+        string value;
+    };
+
+    static size_t hash(const char* name, size_t length);
+
+    vector<Entry> _entries;
+    vector<int> _slots;
+    size_t _mask;
+};
+
+} // namespace MaterialX
+
+#endif
@@ -5,14 +5,17 @@
 
 #include <MaterialXGenShader/Util.h>
 
+#include <MaterialXGenShader/TokenTable.h>
+
 #include <MaterialXGenShader/Shader.h>
 #include <MaterialXGenShader/HwShaderGenerator.h>
 #include <MaterialXGenShader/GenContext.h>
 
+#include <MaterialXFormat/File.h>
 #include <MaterialXFormat/XmlIo.h>
 #include <MaterialXFormat/PugiXML/pugixml.hpp>
 
-#include <fstream>
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <unordered_set>
@@ -29,25 +32,28 @@ string removeExtension(const string& filename)
 
 bool readFile(const string& filename, string& contents)
 {
-    std::ifstream file(filename, std::ios::in);
-    if (file)
+    // Copy directly from a memory mapping of the file, avoiding the
+    // intermediate buffers of a stream read.
+    MappedFile file;
+    if (!file.open(filename))
     {
-        StringStream stream;
-        stream << file.rdbuf();
-        file.close();
-        if (stream)
-        {
-            contents = stream.str();
-            return (contents.size() > 0);
-        }
         return false;
     }
-    return false;
+    contents.assign(file.getData(), file.getSize());
+#if defined(_WIN32)
+    // Match the line endings of a text-mode read.
+    contents.erase(std::remove(contents.begin(), contents.end(), '\r'), contents.end());
+#endif
+    return (contents.size() > 0);
 }
 
 void loadDocuments(const FilePath& rootPath, const FileSearchPath& searchPath, const StringSet& skipFiles, const StringSet& includeFiles,
-                   vector<DocumentPtr>& documents, StringVec& documentsPaths, StringVec& errors)
+                   vector<DocumentPtr>& documents, StringVec& documentsPaths, StringVec& errors,
+                   unsigned int threadCount)
 {
+    // Gather the files to be loaded.
+    FilePathVec filePaths;
+    FilePathVec fileDirs;
     for (const FilePath& dir : rootPath.getSubDirectories())
     {
         for (const FilePath& file : dir.getFilesInDirectory(MTLX_EXTENSION))
@@ -55,42 +61,80 @@ void loadDocuments(const FilePath& rootPath, const FileSearchPath& searchPath, c
             if (!skipFiles.count(file) &&
                (includeFiles.empty() || includeFiles.count(file)))
             {
-                DocumentPtr doc = createDocument();
-                const FilePath filePath = dir / file;
-                try
-                {
-                    FileSearchPath readSearchPath(searchPath.asString());
-                    readSearchPath.append(dir);
-                    readFromXmlFile(doc, filePath, readSearchPath.asString());
-                    documents.push_back(doc);
-                    documentsPaths.push_back(filePath.asString());
-                }
-                catch (Exception& e)
-                {
-                    errors.push_back("Failed to load: " + filePath.asString() + ". Error: " + e.what());
-                }
+                filePaths.push_back(dir / file);
+                fileDirs.push_back(dir);
             }
         }
     }
+
+    // Read the files into separate documents.
+    vector<DocumentPtr> loadedDocs(filePaths.size());
+    StringVec loadErrors(filePaths.size());
+    parallelFor(filePaths.size(), [&](size_t index)
+    {
+        DocumentPtr doc = createDocument();
+        try
+        {
+            FileSearchPath readSearchPath(searchPath.asString());
+            readSearchPath.append(fileDirs[index]);
+            readFromXmlFile(doc, filePaths[index], readSearchPath.asString());
+            loadedDocs[index] = doc;
+        }
+        catch (Exception& e)
+        {
+            loadErrors[index] = "Failed to load: " + filePaths[index].asString() + ". Error: " + e.what();
+        }
+    }, threadCount);
+
+    // Return the results in file order.
+    for (size_t i = 0; i < filePaths.size(); i++)
+    {
+        if (loadedDocs[i])
+        {
+            documents.push_back(loadedDocs[i]);
+            documentsPaths.push_back(filePaths[i].asString());
+        }
+        else
+        {
+            errors.push_back(loadErrors[i]);
+        }
+    }
 }
 
-void loadLibrary(const FilePath& file, DocumentPtr doc)
+namespace
+{
+
+DocumentPtr readLibrary(const FilePath& file)
 {
     DocumentPtr libDoc = createDocument();
     XmlReadOptions readOptions;
     readOptions.skipConflictingElements = true;
     readFromXmlFile(libDoc, file, EMPTY_STRING, &readOptions);
+    return libDoc;
+}
+
+void importLibrary(DocumentPtr libDoc, DocumentPtr doc)
+{
     CopyOptions copyOptions;
     copyOptions.skipConflictingElements = true;
     doc->importLibrary(libDoc, &copyOptions);
 }
 
+} // anonymous namespace
+
+void loadLibrary(const FilePath& file, DocumentPtr doc)
+{
+    importLibrary(readLibrary(file), doc);
+}
+
 StringVec loadLibraries(const StringVec& libraryNames,
                         const FileSearchPath& searchPath,
                         DocumentPtr doc,
-                        const StringSet* excludeFiles)
+                        const StringSet* excludeFiles,
+                        unsigned int threadCount)
 {
     StringVec loadedLibraries;
+    FilePathVec libraryFiles;
     for (const std::string& libraryName : libraryNames)
     {
         FilePath libraryPath = searchPath.find(libraryName);
@@ -101,23 +145,37 @@ StringVec loadLibraries(const StringVec& libraryNames,
                 if (!excludeFiles || !excludeFiles->count(filename))
                 {
                     const FilePath& file = path / filename;
-                    loadLibrary(file, doc);
+                    libraryFiles.push_back(file);
                     loadedLibraries.push_back(file.asString());
                 }
             }
         }
     }
+
+    // Read the library files, and then import them in order so that the
+    // results of a concurrent read match a serial load.
+    vector<DocumentPtr> libDocs(libraryFiles.size());
+    parallelFor(libraryFiles.size(), [&](size_t index)
+    {
+        libDocs[index] = readLibrary(libraryFiles[index]);
+    }, threadCount);
+    for (DocumentPtr libDoc : libDocs)
+    {
+        importLibrary(libDoc, doc);
+    }
+
     return loadedLibraries;
 }
 
 StringVec loadLibraries(const StringVec& libraryNames,
                         const FilePath& filePath,
                         DocumentPtr doc,
-                        const StringSet* excludeFiles)
+                        const StringSet* excludeFiles,
+                        unsigned int threadCount)
 {
     FileSearchPath searchPath;
     searchPath.append(filePath);
-    return loadLibraries(libraryNames, searchPath, doc, excludeFiles);
+    return loadLibraries(libraryNames, searchPath, doc, excludeFiles, threadCount);
 }
 
 namespace
@@ -695,37 +753,26 @@ ValueElementPtr findNodeDefChild(const string& path, DocumentPtr doc, const stri
     return valueElement;
 }
 
-namespace
-{
-    const char TOKEN_PREFIX = '$';
-}
+const char TOKEN_PREFIX = '$';
 
-void tokenSubstitution(const StringMap& substitutions, string& source)
+string Hasher::asString(bool withCheck) const
 {
-    string buffer;
-    size_t pos = 0, len = source.length();
-    while (pos < len)
+    const char* digits = "0123456789abcdef";
+    string str(withCheck ? 32 : 16, '0');
+    for (int i = 0; i < 16; i++)
     {
-        size_t p1 = source.find_first_of(TOKEN_PREFIX, pos);
-        if (p1 != string::npos && p1 + 1 < len)
+        str[15 - i] = digits[(_hash >> (i * 4)) & 0xf];
+        if (withCheck)
         {
-            buffer += source.substr(pos, p1 - pos);
-            pos = p1 + 1;
-            string token = { TOKEN_PREFIX };
-            while (pos < len && isalnum(source[pos]))
-            {
-                token += source[pos++];
-            }
-            auto it = substitutions.find(token);
-            buffer += (it != substitutions.end() ? it->second : token);
-        }
-        else
-        {
-            buffer += source.substr(pos);
-            break;
+            str[31 - i] = digits[(_check >> (i * 4)) & 0xf];
         }
     }
-    source = buffer;
+    return str;
+}
+
+void tokenSubstitution(const StringMap& substitutions, string& source)
+{
+    TokenTable(substitutions).substitute(source);
 }
 
 FilePathVec getUdimPaths(const FilePath& filePath, const StringVec& udimIdentifiers)
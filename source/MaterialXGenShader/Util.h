@@ -17,6 +17,8 @@
 
 #include <MaterialXFormat/File.h>
 
+#include <cstdint>
+
 namespace MaterialX
 {
 
@@ -28,28 +30,39 @@ string removeExtension(const string& filename);
 /// Reads the contents of a file into the given string
 bool readFile(const string& filename, string& content);
 
-/// Scans for all documents under a root path and returns documents which can be loaded
+/// Scans for all documents under a root path and returns documents which can be loaded.
+/// Documents are returned in directory scan order.
+/// @param threadCount The maximum number of threads used to read documents.
+///    If zero, then the hardware concurrency of the system is used.  Defaults
+///    to one, reading documents serially on the calling thread.
 void loadDocuments(const FilePath& rootPath,
                    const FileSearchPath& searchPath,
                    const StringSet& skipFiles, const StringSet& includeFiles,
                    vector<DocumentPtr>& documents, StringVec& documentsPaths,
-                   StringVec& errorLog);
+                   StringVec& errorLog,
+                   unsigned int threadCount = 1);
 
 /// Load a given MaterialX library into a document
 void loadLibrary(const FilePath& file, DocumentPtr doc);
 
 /// Load all MaterialX files with given library names in given search paths.
-/// Note that all library files will have a URI set on them.
+/// Note that all library files will have a URI set on them.  Library files are
+/// imported in directory scan order.
+/// @param threadCount The maximum number of threads used to read library files.
+///    If zero, then the hardware concurrency of the system is used.  Defaults
+///    to one, reading library files serially on the calling thread.
 StringVec loadLibraries(const StringVec& libraryNames,
                         const FileSearchPath& searchPath,
                         DocumentPtr doc,
-                        const StringSet* excludeFiles = nullptr);
+                        const StringSet* excludeFiles = nullptr,
+                        unsigned int threadCount = 1);
 
 /// Load all MaterialX files with given library names in a given path.
 StringVec loadLibraries(const StringVec& libraryNames,
                         const FilePath& filePath,
                         DocumentPtr doc,
-                        const StringSet* excludeFiles = nullptr);
+                        const StringSet* excludeFiles = nullptr,
+                        unsigned int threadCount = 1);
 
 /// Returns true if the given element is a surface shader with the potential
 /// of beeing transparent. This can be used by HW shader generators to determine
@@ -90,12 +103,83 @@ void findRenderableElements(ConstDocumentPtr doc, vector<TypedElementPtr>& eleme
 /// if the path is to a Node as definitions for Nodes can be target specific.
 ValueElementPtr findNodeDefChild(const string& path, DocumentPtr doc, const string& target);
 
+/// The character that begins a substitution token in shader source code.
+extern const char TOKEN_PREFIX;
+
 /// Perform token substitutions on the given source string, using the given substituation map.
 /// Tokens are required to start with '$' and can only consist of alphanumeric characters.
 /// The full token name, including '$' and all following alphanumeric character, will be replaced
 /// by the corresponding string in the substitution map, if the token exists in the map.
+/// When the same map is applied repeatedly, a TokenTable should be compiled from it instead.
 void tokenSubstitution(const StringMap& substitutions, string& source);
 
+/// @class Hasher
+/// An incremental 64-bit FNV-1a hash of strings and integers.  The hash is
+/// stable across platforms and sessions, so it may be used to identify
+/// content in persistent caches.  A second 64-bit check value is computed
+/// alongside it with a different offset basis and multiplier, so that keys
+/// whose hashes collide may still be told apart.
+class Hasher
+{
+  public:
+    Hasher() :
+        _hash(14695981039346656037ULL),
+        _check(0x6a09e667f3bcc908ULL)
+    {
+    }
+
+    /// Add a string, prefixed by its length so that adjacent strings
+    /// cannot be confused.
+    void add(const string& str)
+    {
+        add((uint64_t) str.size());
+        for (char c : str)
+        {
+            addByte((unsigned char) c);
+        }
+    }
+
+    /// Add an integer.
+    void add(uint64_t value)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            addByte((unsigned char) (value >> (i * 8)));
+        }
+    }
+
+    /// Return the value of the hash.
+    uint64_t getValue() const
+    {
+        return _hash;
+    }
+
+    /// Return the check value computed alongside the hash.
+    uint64_t getCheckValue() const
+    {
+        return _check;
+    }
+
+    /// Return the value of the hash as a string of 16 hexadecimal digits.
+    /// @param withCheck If true, then the check value is appended as 16
+    ///    further digits.  Defaults to false.
+    string asString(bool withCheck = false) const;
+
+  private:
+    void addByte(unsigned char byte)
+    {
+        _hash ^= byte;
+        _hash *= 1099511628211ULL;
+        _check ^= byte;
+        _check *= 0x9e3779b97f4a7c15ULL;
+        _check ^= _check >> 29;
+    }
+
+  private:
+    uint64_t _hash;
+    uint64_t _check;
+};
+
 /// Perform UDIM token replace using an input file path and a list of token
 /// replacements (UDIM identifiers). A new path will be created for
 /// each identifier.
@@ -6,6 +6,8 @@
 #include <MaterialXGenShader/Util.h>
 #include <MaterialXRender/GeometryHandler.h>
 
+#include <algorithm>
+
 namespace MaterialX
 {
 void GeometryHandler::addLoader(GeometryLoaderPtr loader)
@@ -30,6 +32,7 @@ void GeometryHandler::supportedExtensions(StringSet& extensions)
 void GeometryHandler::clearGeometry()
 {
     _meshes.clear();
+    _loadOptions.clear();
     computeBounds();
 }
 
@@ -75,15 +78,17 @@ void GeometryHandler::computeBounds()
     }
 }
 
-bool GeometryHandler::loadGeometry(const FilePath& filePath)
+bool GeometryHandler::loadGeometry(const FilePath& filePath, const GeometryLoadOptions& options)
 {
-    // Early return if already loaded
-    if (hasGeometry(filePath))
+    // Early return if already loaded with the same options
+    auto previousOptions = _loadOptions.find(filePath);
+    if (previousOptions != _loadOptions.end() && previousOptions->second == options && hasGeometry(filePath))
     {
         return true;
     }
 
     bool loaded = false;
+    MeshList meshes;
 
     std::pair <GeometryLoaderMap::iterator, GeometryLoaderMap::iterator> range;
     string extension = filePath.getExtension();
@@ -92,16 +97,23 @@ bool GeometryHandler::loadGeometry(const FilePath& filePath)
     GeometryLoaderMap::iterator last = --range.first;
     for (auto it = first; it != last; --it)
     {
-        loaded = it->second->load(filePath, _meshes);
+        loaded = it->second->load(filePath, meshes, options);
         if (loaded)
         {
             break;
         }
+        meshes.clear();
     }
 
-    // Recompute bounds if load was successful
+    // Replace any meshes loaded from this location, and recompute bounds if
+    // load was successful
     if (loaded)
     {
+        _meshes.erase(std::remove_if(_meshes.begin(), _meshes.end(),
+                                     [&filePath](const MeshPtr& mesh) { return mesh->getSourceUri() == filePath.asString(); }),
+                      _meshes.end());
+        _meshes.insert(_meshes.end(), meshes.begin(), meshes.end());
+        _loadOptions[filePath] = options;
         computeBounds();
     }
 
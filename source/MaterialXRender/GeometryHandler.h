@@ -20,6 +20,32 @@ namespace MaterialX
 /// Shared pointer to a GeometryLoader
 using GeometryLoaderPtr = std::shared_ptr<class GeometryLoader>;
 
+/// @struct GeometryLoadOptions
+/// A set of options controlling the construction of meshes by geometry loaders.
+struct GeometryLoadOptions
+{
+    GeometryLoadOptions() :
+        indexedVertices(false)
+    {
+    }
+    ~GeometryLoadOptions() { }
+
+    bool operator==(const GeometryLoadOptions& rhs) const
+    {
+        return indexedVertices == rhs.indexedVertices;
+    }
+    bool operator!=(const GeometryLoadOptions& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    /// If true, then face corners with identical positions, normals and
+    /// texture coordinates share a single vertex, referenced by the index
+    /// buffers of mesh partitions.  If false, then each face corner is
+    /// given its own vertex.  Defaults to false.
+    bool indexedVertices;
+};
+
 /// @class GeometryLoader
 /// Base class representing a geometry loader. A loader can be
 /// associated with one or more file extensions.
@@ -45,6 +71,18 @@ class GeometryLoader
     /// @return True if load was successful
     virtual bool load(const FilePath& filePath, MeshList& meshList) = 0;
 
+    /// Load geometry from disk using the given options.  Derived classes
+    /// supporting options should override this method, and the default
+    /// implementation ignores the options and calls the load method above.
+    /// @param filePath Path to file to load
+    /// @param meshList List of meshes to update
+    /// @param options Options controlling the construction of meshes
+    /// @return True if load was successful
+    virtual bool load(const FilePath& filePath, MeshList& meshList, const GeometryLoadOptions& /*options*/)
+    {
+        return load(filePath, meshList);
+    }
+
   protected:
     /// List of supported string extensions
     StringSet _extensions;
@@ -90,8 +128,12 @@ class GeometryHandler
     // Find all meshes loaded from a given location
     void getGeometry(MeshList& meshes, const string& location);
 
-    /// Load geometry from a given location
-    bool loadGeometry(const FilePath& filePath);
+    /// Load geometry from a given location.  Geometry already loaded from
+    /// the location is kept if it was loaded with the same options, and is
+    /// otherwise replaced once the location has been loaded again.
+    /// @param filePath Path to file to load
+    /// @param options Options controlling the construction of meshes
+    bool loadGeometry(const FilePath& filePath, const GeometryLoadOptions& options = GeometryLoadOptions());
 
     /// Get list of meshes
     const MeshList& getMeshes() const
@@ -117,6 +159,7 @@ class GeometryHandler
 
     GeometryLoaderMap _geometryLoaders;
     MeshList _meshes;
+    std::map<string, GeometryLoadOptions> _loadOptions;
     Vector3 _minimumBounds;
     Vector3 _maximumBounds;
 };
@@ -0,0 +1,49 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_OBJVERTEXKEY_H
+#define MATERIALX_OBJVERTEXKEY_H
+
+/// @file
+/// Vertex keys shared by the OBJ geometry loaders.  This header is internal
+/// to MaterialXRender.
+
+#include <cstdint>
+#include <functional>
+
+namespace MaterialX
+{
+
+/// The position, normal and texture coordinate indices of a face corner.
+/// Corners with equal keys share a vertex when vertices are indexed.
+struct VertexKey
+{
+    bool operator==(const VertexKey& rhs) const
+    {
+        return position == rhs.position &&
+               normal == rhs.normal &&
+               texcoord == rhs.texcoord;
+    }
+
+    int position;
+    int64_t normal;
+    int texcoord;
+};
+
+/// Hash function for vertex keys.
+struct VertexKeyHash
+{
+    size_t operator()(const VertexKey& key) const
+    {
+        size_t hash = std::hash<int>()(key.position);
+        hash = hash * 31 + std::hash<int64_t>()(key.normal);
+        hash = hash * 31 + std::hash<int>()(key.texcoord);
+        return hash;
+    }
+};
+
+} // namespace MaterialX
+
+#endif
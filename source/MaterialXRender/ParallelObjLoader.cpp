@@ -0,0 +1,645 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXRender/ParallelObjLoader.h>
+#include <MaterialXRender/ObjVertexKey.h>
+
+#include <MaterialXCore/Util.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+namespace MaterialX
+{
+
+namespace {
+
+const size_t MIN_CHUNK_SIZE = 1 << 16;
+const size_t CHUNKS_PER_THREAD = 4;
+const size_t MIN_VERTEX_RANGE_SIZE = 1 << 14;
+const size_t FACE_VERTEX_COUNT = 3;
+
+const double POWERS_OF_TEN[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+const int MAX_EXACT_POWER = 22;
+const int MAX_MANTISSA_DIGITS = 19;
+
+// The flags of a corner whose indices are relative to the start of its chunk.
+const unsigned char RELATIVE_POSITION = 1 << 0;
+const unsigned char RELATIVE_NORMAL = 1 << 1;
+const unsigned char RELATIVE_TEXCOORD = 1 << 2;
+
+// The zero-based position, normal and texture coordinate indices of a
+// triangle corner, with -1 for missing normals and texture coordinates.
+struct Corner
+{
+    int position;
+    int normal;
+    int texcoord;
+    unsigned char relative;
+};
+
+// A group or object statement, beginning a new partition at the given
+// corner.  Group statements without names keep the current name.
+struct Group
+{
+    size_t corner;
+    string name;
+    bool hasName;
+};
+
+// The vertex data, triangle corners and groups parsed from a range of lines.
+struct Chunk
+{
+    MeshFloatBuffer positions;
+    MeshFloatBuffer normals;
+    MeshFloatBuffer texcoords;
+    vector<Corner> corners;
+    vector<Group> groups;
+    string error;
+};
+
+// A range of triangle corners forming a partition.
+struct PartitionRange
+{
+    string name;
+    size_t begin;
+    size_t end;
+};
+
+// The bounding box of a range of vertices.
+struct Bounds
+{
+    Vector3 min;
+    Vector3 max;
+};
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool isDigit(char c)
+{
+    return (unsigned int) (c - '0') < 10;
+}
+
+const char* skipSpace(const char* s, const char* end)
+{
+    while (s < end && isSpace(*s))
+    {
+        s++;
+    }
+    return s;
+}
+
+// Parse a floating-point number at the given position, returning the
+// position following it, or the given position if no number is found.
+// Digits are accumulated into an integer mantissa, which is scaled by an
+// exact power of ten for all but extreme exponents.
+const char* parseFloat(const char* s, const char* end, float& value)
+{
+    const char* start = s;
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+'))
+    {
+        negative = *s == '-';
+        s++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool found = false;
+    for (; s < end && isDigit(*s); s++)
+    {
+        found = true;
+        if (digits < MAX_MANTISSA_DIGITS)
+        {
+            mantissa = mantissa * 10 + (uint64_t) (*s - '0');
+            digits += mantissa ? 1 : 0;
+        }
+        else
+        {
+            exponent++;
+        }
+    }
+    if (s < end && *s == '.')
+    {
+        for (s++; s < end && isDigit(*s); s++)
+        {
+            found = true;
+            if (digits < MAX_MANTISSA_DIGITS)
+            {
+                mantissa = mantissa * 10 + (uint64_t) (*s - '0');
+                digits += mantissa ? 1 : 0;
+                exponent--;
+            }
+        }
+    }
+    if (!found)
+    {
+        value = 0.0f;
+        return start;
+    }
+
+    if (s < end && (*s == 'e' || *s == 'E'))
+    {
+        const char* e = s + 1;
+        bool negativeExponent = false;
+        if (e < end && (*e == '-' || *e == '+'))
+        {
+            negativeExponent = *e == '-';
+            e++;
+        }
+        if (e < end && isDigit(*e))
+        {
+            int exponentValue = 0;
+            for (; e < end && isDigit(*e); e++)
+            {
+                if (exponentValue < 10000)
+                {
+                    exponentValue = exponentValue * 10 + (*e - '0');
+                }
+            }
+            exponent += negativeExponent ? -exponentValue : exponentValue;
+            s = e;
+        }
+    }
+
+    double result = (double) mantissa;
+    if (exponent < 0)
+    {
+        result = (exponent >= -MAX_EXACT_POWER) ? result / POWERS_OF_TEN[-exponent] : result * std::pow(10.0, exponent);
+    }
+    else if (exponent > 0)
+    {
+        result = (exponent <= MAX_EXACT_POWER) ? result * POWERS_OF_TEN[exponent] : result * std::pow(10.0, exponent);
+    }
+    value = (float) (negative ? -result : result);
+    return s;
+}
+
+// Parse an integer at the given position, returning the position following
+// it, or the given position if no integer is found.
+const char* parseInt(const char* s, const char* end, int& value)
+{
+    const char* start = s;
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+'))
+    {
+        negative = *s == '-';
+        s++;
+    }
+    if (s == end || !isDigit(*s))
+    {
+        return start;
+    }
+    int64_t result = 0;
+    for (; s < end && isDigit(*s); s++)
+    {
+        if (result <= std::numeric_limits<int>::max())
+        {
+            result = result * 10 + (*s - '0');
+        }
+    }
+    result = std::min<int64_t>(result, std::numeric_limits<int>::max());
+    value = (int) (negative ? -result : result);
+    return s;
+}
+
+// Parse the given number of floating-point values, appending them to the
+// given buffer.  Missing values are given as zero.
+void parseFloats(const char* s, const char* end, size_t count, MeshFloatBuffer& buffer)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        float value;
+        s = parseFloat(skipSpace(s, end), end, value);
+        buffer.push_back(value);
+    }
+}
+
+// Parse an OBJ face index at the given position, converting it to a
+// zero-based index.  Negative indices are relative to the given count of
+// elements preceding the face within the chunk, and are flagged in the
+// given corner.
+const char* parseIndex(const char* s, const char* end, size_t count, unsigned char relativeFlag,
+                       int& index, Corner& corner, string& error)
+{
+    int value = 0;
+    const char* next = parseInt(s, end, value);
+    if (next == s || value == 0)
+    {
+        error = "Invalid face index '" + string(s, std::find_if(s, end, isSpace)) + "'";
+        return end;
+    }
+    if (value > 0)
+    {
+        index = value - 1;
+    }
+    else
+    {
+        index = (int) count + value;
+        corner.relative |= relativeFlag;
+    }
+    return next;
+}
+
+// Parse the lines in the given range of the file.
+void parseChunk(const char* begin, const char* end, Chunk& chunk)
+{
+    vector<Corner> polygon;
+    const char* line = begin;
+    while (line < end && chunk.error.empty())
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', (size_t) (end - line)));
+        if (!lineEnd)
+        {
+            lineEnd = end;
+        }
+        const char* s = skipSpace(line, lineEnd);
+        const char* e = lineEnd;
+        while (e > s && isSpace(e[-1]))
+        {
+            e--;
+        }
+        line = (lineEnd < end) ? lineEnd + 1 : end;
+        if (e - s < 2)
+        {
+            continue;
+        }
+
+        if (s[0] == 'v' && isSpace(s[1]))
+        {
+            parseFloats(s + 2, e, MeshStream::STRIDE_3D, chunk.positions);
+        }
+        else if (e - s > 2 && s[0] == 'v' && s[1] == 'n' && isSpace(s[2]))
+        {
+            parseFloats(s + 3, e, MeshStream::STRIDE_3D, chunk.normals);
+        }
+        else if (e - s > 2 && s[0] == 'v' && s[1] == 't' && isSpace(s[2]))
+        {
+            parseFloats(s + 3, e, MeshStream::STRIDE_2D, chunk.texcoords);
+        }
+        else if (s[0] == 'f' && isSpace(s[1]))
+        {
+            // Parse the corners of the polygon, in the forms v, v/vt, v//vn
+            // and v/vt/vn.
+            polygon.clear();
+            s = skipSpace(s + 2, e);
+            while (s < e && chunk.error.empty())
+            {
+                Corner corner = { -1, -1, -1, 0 };
+                s = parseIndex(s, e, chunk.positions.size() / MeshStream::STRIDE_3D, RELATIVE_POSITION,
+                               corner.position, corner, chunk.error);
+                if (s < e && *s == '/')
+                {
+                    s++;
+                    if (s < e && *s != '/')
+                    {
+                        s = parseIndex(s, e, chunk.texcoords.size() / MeshStream::STRIDE_2D, RELATIVE_TEXCOORD,
+                                       corner.texcoord, corner, chunk.error);
+                    }
+                    if (s < e && *s == '/')
+                    {
+                        s = parseIndex(s + 1, e, chunk.normals.size() / MeshStream::STRIDE_3D, RELATIVE_NORMAL,
+                                       corner.normal, corner, chunk.error);
+                    }
+                }
+                polygon.push_back(corner);
+                s = skipSpace(s, e);
+            }
+
+            // Triangulate the polygon as a fan.
+            for (size_t i = 2; i < polygon.size(); i++)
+            {
+                chunk.corners.push_back(polygon[0]);
+                chunk.corners.push_back(polygon[i - 1]);
+                chunk.corners.push_back(polygon[i]);
+            }
+        }
+        else if (s[0] == 'g' && isSpace(s[1]))
+        {
+            // Multiple group names are joined into a single name.
+            Group group = { chunk.corners.size(), EMPTY_STRING, false };
+            for (s = skipSpace(s + 2, e); s < e; s = skipSpace(s, e))
+            {
+                const char* nameEnd = std::find_if(s, e, isSpace);
+                group.name += (group.hasName ? " " : "") + string(s, nameEnd);
+                group.hasName = true;
+                s = nameEnd;
+            }
+            chunk.groups.push_back(group);
+        }
+        else if (s[0] == 'o' && isSpace(s[1]))
+        {
+            chunk.groups.push_back({ chunk.corners.size(), string(s + 2, e), true });
+        }
+    }
+}
+
+bool isValidIndex(int index, size_t count)
+{
+    return index >= 0 && (size_t) index < count;
+}
+
+// Return true if the given optional index is either missing or valid.
+// Relative indices are never missing, even where they resolve to -1.
+bool isValidOptionalIndex(int index, bool relative, size_t count)
+{
+    return (index == -1 && !relative) || isValidIndex(index, count);
+}
+
+} // anonymous namespace
+
+bool ParallelObjLoader::load(const FilePath& filePath, MeshList& meshList, const GeometryLoadOptions& options)
+{
+    MappedFile file;
+    if (!file.open(filePath) || !file.getData())
+    {
+        std::cerr << "Unable to read OBJ file: " << filePath.asString() << std::endl;
+        return false;
+    }
+    const char* data = file.getData();
+    const size_t size = file.getSize();
+
+    unsigned int threadCount = _threadCount;
+    if (!threadCount)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    // Split the file into chunks of whole lines, and parse each chunk on
+    // a single thread.
+    const size_t chunkCount = std::max<size_t>(1, std::min(size / MIN_CHUNK_SIZE,
+                                                           (size_t) threadCount * CHUNKS_PER_THREAD));
+    vector<const char*> chunkStarts(chunkCount + 1, data + size);
+    chunkStarts[0] = data;
+    for (size_t i = 1; i < chunkCount; i++)
+    {
+        const char* start = std::max(data + size * i / chunkCount, chunkStarts[i - 1]);
+        const char* lineEnd = static_cast<const char*>(std::memchr(start, '\n', (size_t) (data + size - start)));
+        chunkStarts[i] = lineEnd ? lineEnd + 1 : data + size;
+    }
+    vector<Chunk> chunks(chunkCount);
+    parallelFor(chunkCount, [&](size_t i)
+    {
+        parseChunk(chunkStarts[i], chunkStarts[i + 1], chunks[i]);
+    }, threadCount);
+
+    // Compute the offsets of each chunk within the combined data, and the
+    // corner ranges of partitions, which begin at each group statement.
+    vector<size_t> positionOffsets(chunkCount + 1, 0);
+    vector<size_t> normalOffsets(chunkCount + 1, 0);
+    vector<size_t> texcoordOffsets(chunkCount + 1, 0);
+    vector<size_t> cornerOffsets(chunkCount + 1, 0);
+    vector<PartitionRange> partitionRanges;
+    PartitionRange partitionRange = { EMPTY_STRING, 0, 0 };
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        const Chunk& chunk = chunks[i];
+        if (!chunk.error.empty())
+        {
+            std::cerr << "Error reading OBJ file " << filePath.asString() << ": " << chunk.error << std::endl;
+            return false;
+        }
+        positionOffsets[i + 1] = positionOffsets[i] + chunk.positions.size() / MeshStream::STRIDE_3D;
+        normalOffsets[i + 1] = normalOffsets[i] + chunk.normals.size() / MeshStream::STRIDE_3D;
+        texcoordOffsets[i + 1] = texcoordOffsets[i] + chunk.texcoords.size() / MeshStream::STRIDE_2D;
+        cornerOffsets[i + 1] = cornerOffsets[i] + chunk.corners.size();
+        for (const Group& group : chunk.groups)
+        {
+            partitionRange.end = cornerOffsets[i] + group.corner;
+            if (partitionRange.end > partitionRange.begin)
+            {
+                partitionRanges.push_back(partitionRange);
+            }
+            partitionRange.begin = partitionRange.end;
+            if (group.hasName)
+            {
+                partitionRange.name = group.name;
+            }
+        }
+    }
+    partitionRange.end = cornerOffsets[chunkCount];
+    if (partitionRange.end > partitionRange.begin)
+    {
+        partitionRanges.push_back(partitionRange);
+    }
+
+    const size_t positionCount = positionOffsets[chunkCount];
+    const size_t normalCount = normalOffsets[chunkCount];
+    const size_t texcoordCount = texcoordOffsets[chunkCount];
+    const size_t cornerCount = cornerOffsets[chunkCount];
+    if (!positionCount)
+    {
+        return false;
+    }
+
+    // Combine the data of all chunks, resolving relative indices and
+    // validating all indices.
+    MeshFloatBuffer filePositions(positionCount * MeshStream::STRIDE_3D);
+    MeshFloatBuffer fileNormals(normalCount * MeshStream::STRIDE_3D);
+    MeshFloatBuffer fileTexcoords(texcoordCount * MeshStream::STRIDE_2D);
+    vector<Corner> corners(cornerCount);
+    std::atomic<bool> validIndices(true);
+    parallelFor(chunkCount, [&](size_t i)
+    {
+        Chunk& chunk = chunks[i];
+        std::copy(chunk.positions.begin(), chunk.positions.end(), filePositions.begin() + positionOffsets[i] * MeshStream::STRIDE_3D);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), fileNormals.begin() + normalOffsets[i] * MeshStream::STRIDE_3D);
+        std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), fileTexcoords.begin() + texcoordOffsets[i] * MeshStream::STRIDE_2D);
+        for (size_t c = 0; c < chunk.corners.size(); c++)
+        {
+            Corner corner = chunk.corners[c];
+            corner.position += (corner.relative & RELATIVE_POSITION) ? (int) positionOffsets[i] : 0;
+            corner.normal += (corner.relative & RELATIVE_NORMAL) ? (int) normalOffsets[i] : 0;
+            corner.texcoord += (corner.relative & RELATIVE_TEXCOORD) ? (int) texcoordOffsets[i] : 0;
+            if (!isValidIndex(corner.position, positionCount) ||
+                !isValidOptionalIndex(corner.normal, (corner.relative & RELATIVE_NORMAL) != 0, normalCount) ||
+                !isValidOptionalIndex(corner.texcoord, (corner.relative & RELATIVE_TEXCOORD) != 0, texcoordCount))
+            {
+                validIndices = false;
+            }
+            corners[cornerOffsets[i] + c] = corner;
+        }
+        chunk = Chunk();
+    }, threadCount);
+    if (!validIndices)
+    {
+        std::cerr << "Error reading OBJ file " << filePath.asString() << ": Face index out of range" << std::endl;
+        return false;
+    }
+
+    // Assign a vertex to each corner.  Unless vertices are indexed, each
+    // corner has its own vertex, and otherwise corners are deduplicated as
+    // in TinyObjLoader, on a single thread.
+    vector<unsigned int> cornerVertices;
+    vector<size_t> vertexCorners;
+    if (options.indexedVertices)
+    {
+        std::unordered_map<VertexKey, unsigned int, VertexKeyHash> vertexMap;
+        cornerVertices.resize(cornerCount);
+        int64_t faceNormalKey = -1;
+        for (size_t face = 0; face < cornerCount; face += FACE_VERTEX_COUNT)
+        {
+            const Corner* faceCorners = &corners[face];
+            bool hasNormals = faceCorners[0].normal >= 0 && faceCorners[1].normal >= 0 && faceCorners[2].normal >= 0;
+            bool hasTexcoords = faceCorners[0].texcoord >= 0 && faceCorners[1].texcoord >= 0 && faceCorners[2].texcoord >= 0;
+            for (size_t i = 0; i < FACE_VERTEX_COUNT; i++)
+            {
+                VertexKey key = { faceCorners[i].position,
+                                  hasNormals ? (int64_t) faceCorners[i].normal : faceNormalKey,
+                                  hasTexcoords ? faceCorners[i].texcoord : -1 };
+                auto it = vertexMap.insert(std::make_pair(key, (unsigned int) vertexCorners.size()));
+                if (it.second)
+                {
+                    vertexCorners.push_back(face + i);
+                }
+                cornerVertices[face + i] = it.first->second;
+            }
+            faceNormalKey -= hasNormals ? 0 : 1;
+        }
+    }
+    const size_t vertexCount = options.indexedVertices ? vertexCorners.size() : cornerCount;
+
+    MeshPtr mesh = Mesh::create(filePath);
+    mesh->setSourceUri(filePath);
+    MeshStreamPtr positionStream = MeshStream::create("i_" + MeshStream::POSITION_ATTRIBUTE, MeshStream::POSITION_ATTRIBUTE, 0);
+    MeshFloatBuffer& positions = positionStream->getData();
+    mesh->addStream(positionStream);
+
+    MeshStreamPtr normalStream = MeshStream::create("i_" + MeshStream::NORMAL_ATTRIBUTE, MeshStream::NORMAL_ATTRIBUTE, 0);
+    MeshFloatBuffer& normals = normalStream->getData();
+    mesh->addStream(normalStream);
+
+    MeshStreamPtr texCoordStream = MeshStream::create("i_" + MeshStream::TEXCOORD_ATTRIBUTE + "_0", MeshStream::TEXCOORD_ATTRIBUTE, 0);
+    texCoordStream->setStride(MeshStream::STRIDE_2D);
+    MeshFloatBuffer& texcoords = texCoordStream->getData();
+    mesh->addStream(texCoordStream);
+
+    MeshStreamPtr tangentStream = MeshStream::create("i_" + MeshStream::TANGENT_ATTRIBUTE, MeshStream::TANGENT_ATTRIBUTE, 0);
+    tangentStream->setStride(MeshStream::STRIDE_3D);
+    mesh->addStream(tangentStream);
+
+    // Fill the streams over ranges of vertices, computing the bounds of
+    // each range, then combine the bounds of all ranges.
+    positions.resize(vertexCount * MeshStream::STRIDE_3D);
+    normals.resize(vertexCount * MeshStream::STRIDE_3D);
+    texcoords.resize(vertexCount * MeshStream::STRIDE_2D);
+    const float MAX_FLOAT = std::numeric_limits<float>::max();
+    const size_t rangeCount = std::max<size_t>(1, std::min(vertexCount / MIN_VERTEX_RANGE_SIZE,
+                                                           (size_t) threadCount * CHUNKS_PER_THREAD));
+    const Bounds emptyBounds = { { MAX_FLOAT, MAX_FLOAT, MAX_FLOAT }, { -MAX_FLOAT, -MAX_FLOAT, -MAX_FLOAT } };
+    vector<Bounds> rangeBounds(rangeCount, emptyBounds);
+    parallelFor(rangeCount, [&](size_t r)
+    {
+        Bounds& bounds = rangeBounds[r];
+        for (size_t v = vertexCount * r / rangeCount; v < vertexCount * (r + 1) / rangeCount; v++)
+        {
+            const size_t corner = options.indexedVertices ? vertexCorners[v] : v;
+            const Corner* faceCorners = &corners[corner - corner % FACE_VERTEX_COUNT];
+            const Corner& vertexCorner = corners[corner];
+
+            Vector3 position;
+            for (unsigned int k = 0; k < MeshStream::STRIDE_3D; k++)
+            {
+                position[k] = filePositions[vertexCorner.position * MeshStream::STRIDE_3D + k];
+                positions[v * MeshStream::STRIDE_3D + k] = position[k];
+                bounds.min[k] = std::min(position[k], bounds.min[k]);
+                bounds.max[k] = std::max(position[k], bounds.max[k]);
+            }
+
+            // Copy normals, or compute face normals.
+            if (faceCorners[0].normal >= 0 && faceCorners[1].normal >= 0 && faceCorners[2].normal >= 0)
+            {
+                for (unsigned int k = 0; k < MeshStream::STRIDE_3D; k++)
+                {
+                    normals[v * MeshStream::STRIDE_3D + k] = fileNormals[vertexCorner.normal * MeshStream::STRIDE_3D + k];
+                }
+            }
+            else
+            {
+                Vector3 p[FACE_VERTEX_COUNT];
+                for (size_t i = 0; i < FACE_VERTEX_COUNT; i++)
+                {
+                    for (unsigned int k = 0; k < MeshStream::STRIDE_3D; k++)
+                    {
+                        p[i][k] = filePositions[faceCorners[i].position * MeshStream::STRIDE_3D + k];
+                    }
+                }
+                Vector3 faceNorm = (p[1] - p[0]).cross(p[2] - p[0]).getNormalized();
+                for (unsigned int k = 0; k < MeshStream::STRIDE_3D; k++)
+                {
+                    normals[v * MeshStream::STRIDE_3D + k] = faceNorm[k];
+                }
+            }
+
+            // Copy texture coordinates.
+            if (faceCorners[0].texcoord >= 0 && faceCorners[1].texcoord >= 0 && faceCorners[2].texcoord >= 0)
+            {
+                for (unsigned int k = 0; k < MeshStream::STRIDE_2D; k++)
+                {
+                    texcoords[v * MeshStream::STRIDE_2D + k] = fileTexcoords[vertexCorner.texcoord * MeshStream::STRIDE_2D + k];
+                }
+            }
+        }
+    }, threadCount);
+    Vector3 boxMin = emptyBounds.min;
+    Vector3 boxMax = emptyBounds.max;
+    for (const Bounds& bounds : rangeBounds)
+    {
+        for (unsigned int k = 0; k < MeshStream::STRIDE_3D; k++)
+        {
+            boxMin[k] = std::min(bounds.min[k], boxMin[k]);
+            boxMax[k] = std::max(bounds.max[k], boxMax[k]);
+        }
+    }
+    mesh->setVertexCount(vertexCount);
+
+    // Fill the indices of each partition.
+    for (const PartitionRange& range : partitionRanges)
+    {
+        MeshPartitionPtr part = MeshPartition::create();
+        part->setIdentifier(range.name);
+        part->getIndices().resize(range.end - range.begin);
+        part->setFaceCount((range.end - range.begin) / FACE_VERTEX_COUNT);
+        mesh->addPartition(part);
+    }
+    parallelFor(partitionRanges.size(), [&](size_t p)
+    {
+        const PartitionRange& range = partitionRanges[p];
+        MeshIndexBuffer& indices = mesh->getPartition(p)->getIndices();
+        for (size_t c = range.begin; c < range.end; c++)
+        {
+            indices[c - range.begin] = options.indexedVertices ? cornerVertices[c] : (unsigned int) c;
+        }
+    }, threadCount);
+
+    mesh->setMinimumBounds(boxMin);
+    mesh->setMaximumBounds(boxMax);
+    Vector3 sphereCenter = (boxMax + boxMin) * 0.5;
+    mesh->setSphereCenter(sphereCenter);
+    mesh->setSphereRadius((sphereCenter - boxMin).getMagnitude());
+
+    MeshStreamPtr bitangentStream = MeshStream::create("i_" + MeshStream::BITANGENT_ATTRIBUTE, MeshStream::BITANGENT_ATTRIBUTE, 0);
+    mesh->generateTangents(positionStream, texCoordStream, normalStream, tangentStream, bitangentStream);
+    mesh->addStream(bitangentStream);
+
+    meshList.push_back(mesh);
+    return true;
+}
+
+} // namespace MaterialX
@@ -0,0 +1,74 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_PARALLELOBJLOADER_H
+#define MATERIALX_PARALLELOBJLOADER_H
+
+/// @file
+/// Multithreaded OBJ geometry format loader
+
+#include <MaterialXCore/Library.h>
+#include <MaterialXRender/GeometryHandler.h>
+
+namespace MaterialX
+{
+/// Shared pointer to a ParallelObjLoader
+using ParallelObjLoaderPtr = std::shared_ptr<class ParallelObjLoader>;
+
+/// @class ParallelObjLoader
+/// Geometry loader reading OBJ files on multiple threads.
+///
+/// The file is mapped into memory and split into ranges of whole lines,
+/// which are parsed in parallel.  The mesh streams are then filled, and
+/// the bounds of the mesh computed, in parallel over ranges of vertices.
+///
+/// Meshes match those of TinyObjLoader for the same options, with one mesh
+/// per file and one partition per group or object.  Polygons are
+/// triangulated as fans, which matches the triangulation of TinyObjLoader
+/// for convex polygons.
+class ParallelObjLoader : public GeometryLoader
+{
+  public:
+    /// Static instance create function
+    static ParallelObjLoaderPtr create() { return std::make_shared<ParallelObjLoader>(); }
+
+    /// Default constructor
+    ParallelObjLoader() :
+        _threadCount(0)
+    {
+        _extensions = { "obj", "OBJ" };
+    }
+
+    /// Default destructor
+    virtual ~ParallelObjLoader() {}
+
+    /// Set the number of threads used to load files.  If zero, then the
+    /// number of hardware threads is used.  Defaults to zero.
+    void setThreadCount(unsigned int threadCount)
+    {
+        _threadCount = threadCount;
+    }
+
+    /// Return the number of threads used to load files.
+    unsigned int getThreadCount() const
+    {
+        return _threadCount;
+    }
+
+    /// Load geometry from disk with default options
+    bool load(const FilePath& filePath, MeshList& meshList) override
+    {
+        return load(filePath, meshList, GeometryLoadOptions());
+    }
+
+    /// Load geometry from disk using the given options
+    bool load(const FilePath& filePath, MeshList& meshList, const GeometryLoadOptions& options) override;
+
+  private:
+    unsigned int _threadCount;
+};
+
+} // namespace MaterialX
+#endif
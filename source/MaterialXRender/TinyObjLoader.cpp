@@ -4,6 +4,7 @@
 //
 
 #include <MaterialXRender/TinyObjLoader.h>
+#include <MaterialXRender/ObjVertexKey.h>
 #include <MaterialXCore/Util.h>
 
 #if defined(__GNUC__) && !defined(__clang__)
@@ -17,10 +18,12 @@
 #endif
 
 #include <iostream>
+#include <unordered_map>
 
 namespace MaterialX
 {
-bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
+
+bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList, const GeometryLoadOptions& options)
 {
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
@@ -59,31 +62,56 @@ bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
 
     MeshStreamPtr tangentStream = MeshStream::create("i_" + MeshStream::TANGENT_ATTRIBUTE, MeshStream::TANGENT_ATTRIBUTE, 0);
     tangentStream->setStride(MeshStream::STRIDE_3D);
-    MeshFloatBuffer& tangents = tangentStream->getData();
     mesh->addStream(tangentStream);
 
-    // Explode the geometry, since we may have unshared geometry
-    // in position, normal or uv
+    // Unless vertices are indexed, explode the geometry, since we may have
+    // unshared geometry in position, normal or uv.
     size_t totalIndexCount = 0;
     for (const tinyobj::shape_t& shape : shapes)
     {
         totalIndexCount += shape.mesh.indices.size();
     }
-    positions.resize(totalIndexCount * MeshStream::STRIDE_3D);
-    normals.resize(totalIndexCount * MeshStream::STRIDE_3D);
-    texcoords.resize(totalIndexCount * MeshStream::STRIDE_2D);
-    tangents.resize(totalIndexCount * MeshStream::STRIDE_3D);
-    mesh->setVertexCount(totalIndexCount);
+    size_t reserveCount = options.indexedVertices ? std::min(totalIndexCount, vertexCount) : totalIndexCount;
+    positions.reserve(reserveCount * MeshStream::STRIDE_3D);
+    normals.reserve(reserveCount * MeshStream::STRIDE_3D);
+    texcoords.reserve(reserveCount * MeshStream::STRIDE_2D);
 
     const float MAX_FLOAT = std::numeric_limits<float>::max();
     Vector3 boxMin = { MAX_FLOAT, MAX_FLOAT, MAX_FLOAT };
     Vector3 boxMax = { -MAX_FLOAT, -MAX_FLOAT, -MAX_FLOAT };
 
-    int writeIndex0 = 0;
-    int writeIndex1 = 1;
-    int writeIndex2 = 2;
+    // Return the index of the vertex for the given face corner, adding a new
+    // vertex unless vertices are indexed and a matching vertex exists.
+    std::unordered_map<VertexKey, unsigned int, VertexKeyHash> vertexMap;
+    auto addVertex = [&](const VertexKey& key, const Vector3& v, const Vector3& n, const Vector2& t) -> unsigned int
+    {
+        if (options.indexedVertices)
+        {
+            auto it = vertexMap.find(key);
+            if (it != vertexMap.end())
+            {
+                return it->second;
+            }
+        }
+        unsigned int index = (unsigned int) (positions.size() / MeshStream::STRIDE_3D);
+        for (unsigned int k = 0; k < MeshStream::STRIDE_3D; k++)
+        {
+            positions.push_back(v[k]);
+            normals.push_back(n[k]);
+        }
+        for (unsigned int k = 0; k < MeshStream::STRIDE_2D; k++)
+        {
+            texcoords.push_back(t[k]);
+        }
+        if (options.indexedVertices)
+        {
+            vertexMap[key] = index;
+        }
+        return index;
+    };
 
     const size_t FACE_VERTEX_COUNT = 3;
+    int64_t faceNormalKey = -1;
     for (const tinyobj::shape_t& shape : shapes)
     {
         size_t indexCount = shape.mesh.indices.size();
@@ -102,93 +130,80 @@ bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
 
         for (size_t faceIndex = 0; faceIndex < faceCount; faceIndex++)
         {
-            const tinyobj::index_t& indexObj0 = shape.mesh.indices[faceIndex * 3 + 0];
-            const tinyobj::index_t& indexObj1 = shape.mesh.indices[faceIndex * 3 + 1];
-            const tinyobj::index_t& indexObj2 = shape.mesh.indices[faceIndex * 3 + 2];
- 
-            // Copy indices.
-            indices[faceIndex * MeshStream::STRIDE_3D + 0] = writeIndex0;
-            indices[faceIndex * MeshStream::STRIDE_3D + 1] = writeIndex1;
-            indices[faceIndex * MeshStream::STRIDE_3D + 2] = writeIndex2;
+            const tinyobj::index_t* indexObj = &shape.mesh.indices[faceIndex * FACE_VERTEX_COUNT];
+            VertexKey keys[FACE_VERTEX_COUNT];
 
             // Copy positions and compute bounding box.
             Vector3 v[MeshStream::STRIDE_3D];
-            for (unsigned int k = 0; k < MeshStream::STRIDE_3D; k++)
+            for (size_t i = 0; i < FACE_VERTEX_COUNT; i++)
             {
-                v[0][k] = attrib.vertices[indexObj0.vertex_index * MeshStream::STRIDE_3D + k];
-                v[1][k] = attrib.vertices[indexObj1.vertex_index * MeshStream::STRIDE_3D + k];
-                v[2][k] = attrib.vertices[indexObj2.vertex_index * MeshStream::STRIDE_3D + k];
-
-                boxMin[k] = std::min(v[0][k], boxMin[k]);
-                boxMin[k] = std::min(v[1][k], boxMin[k]);
-                boxMin[k] = std::min(v[2][k], boxMin[k]);
-
-                boxMax[k] = std::max(v[0][k], boxMax[k]);
-                boxMax[k] = std::max(v[1][k], boxMax[k]);
-                boxMax[k] = std::max(v[2][k], boxMax[k]);
+                keys[i].position = indexObj[i].vertex_index;
+                for (unsigned int k = 0; k < MeshStream::STRIDE_3D; k++)
+                {
+                    v[i][k] = attrib.vertices[indexObj[i].vertex_index * MeshStream::STRIDE_3D + k];
+                    boxMin[k] = std::min(v[i][k], boxMin[k]);
+                    boxMax[k] = std::max(v[i][k], boxMax[k]);
+                }
             }
 
-            Vector3* pos = reinterpret_cast<Vector3*>(&(positions[writeIndex0 * MeshStream::STRIDE_3D]));
-            *pos = v[0];
-            pos = reinterpret_cast<Vector3*>(&(positions[writeIndex1 * MeshStream::STRIDE_3D]));
-            *pos = v[1];
-            pos = reinterpret_cast<Vector3*>(&(positions[writeIndex2 * MeshStream::STRIDE_3D]));
-            *pos = v[2];
-
-            // Copy or compute normals
+            // Copy or compute normals.  Vertices with computed face normals
+            // are never shared between faces.
             Vector3 n[3];
-            if (indexObj0.normal_index >= 0 &&
-                indexObj1.normal_index >= 0 &&
-                indexObj2.normal_index >= 0)
+            if (indexObj[0].normal_index >= 0 &&
+                indexObj[1].normal_index >= 0 &&
+                indexObj[2].normal_index >= 0)
             {
-                for (int k = 0; k < 3; k++)
+                for (size_t i = 0; i < FACE_VERTEX_COUNT; i++)
                 {
-                    n[0][k] = attrib.normals[indexObj0.normal_index * MeshStream::STRIDE_3D + k];
-                    n[1][k] = attrib.normals[indexObj1.normal_index * MeshStream::STRIDE_3D + k];
-                    n[2][k] = attrib.normals[indexObj2.normal_index * MeshStream::STRIDE_3D + k];
+                    keys[i].normal = indexObj[i].normal_index;
+                    for (int k = 0; k < 3; k++)
+                    {
+                        n[i][k] = attrib.normals[indexObj[i].normal_index * MeshStream::STRIDE_3D + k];
+                    }
                 }
             }
             else
             {
                 Vector3 faceNorm = (v[1] - v[0]).cross(v[2] - v[0]).getNormalized();
-                n[0] = faceNorm;
-                n[1] = faceNorm;
-                n[2] = faceNorm;
+                for (size_t i = 0; i < FACE_VERTEX_COUNT; i++)
+                {
+                    keys[i].normal = faceNormalKey;
+                    n[i] = faceNorm;
+                }
+                faceNormalKey--;
             }
 
-            Vector3* norm = reinterpret_cast<Vector3*>(&(normals[writeIndex0 * MeshStream::STRIDE_3D]));
-            *norm = n[0];
-            norm = reinterpret_cast<Vector3*>(&(normals[writeIndex1 * MeshStream::STRIDE_3D]));
-            *norm = n[1];
-            norm = reinterpret_cast<Vector3*>(&(normals[writeIndex2 * MeshStream::STRIDE_3D]));
-            *norm = n[2];
-
             // Copy texture coordinates.
             Vector2 t[3];
-            if (indexObj0.texcoord_index >= 0 &&
-                indexObj1.texcoord_index >= 0 &&
-                indexObj2.texcoord_index >= 0)
+            if (indexObj[0].texcoord_index >= 0 &&
+                indexObj[1].texcoord_index >= 0 &&
+                indexObj[2].texcoord_index >= 0)
             {
-                for (int k = 0; k < 2; k++)
+                for (size_t i = 0; i < FACE_VERTEX_COUNT; i++)
                 {
-                    t[0][k] = attrib.texcoords[indexObj0.texcoord_index * MeshStream::STRIDE_2D + k];
-                    t[1][k] = attrib.texcoords[indexObj1.texcoord_index * MeshStream::STRIDE_2D + k];
-                    t[2][k] = attrib.texcoords[indexObj2.texcoord_index * MeshStream::STRIDE_2D + k];
+                    keys[i].texcoord = indexObj[i].texcoord_index;
+                    for (int k = 0; k < 2; k++)
+                    {
+                        t[i][k] = attrib.texcoords[indexObj[i].texcoord_index * MeshStream::STRIDE_2D + k];
+                    }
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < FACE_VERTEX_COUNT; i++)
+                {
+                    keys[i].texcoord = -1;
                 }
             }
 
-            Vector2* texcoord = reinterpret_cast<Vector2*>(&(texcoords[writeIndex0 * MeshStream::STRIDE_2D]));
-            *texcoord = t[0];
-            texcoord = reinterpret_cast<Vector2*>(&(texcoords[writeIndex1 * MeshStream::STRIDE_2D]));
-            *texcoord = t[1];
-            texcoord = reinterpret_cast<Vector2*>(&(texcoords[writeIndex2 * MeshStream::STRIDE_2D]));
-            *texcoord = t[2];
-
-            writeIndex0 += MeshStream::STRIDE_3D;
-            writeIndex1 += MeshStream::STRIDE_3D;
-            writeIndex2 += MeshStream::STRIDE_3D;
+            // Copy indices.
+            for (size_t i = 0; i < FACE_VERTEX_COUNT; i++)
+            {
+                indices[faceIndex * FACE_VERTEX_COUNT + i] = addVertex(keys[i], v[i], n[i], t[i]);
+            }
         }
     }
+    mesh->setVertexCount(positions.size() / MeshStream::STRIDE_3D);
 
     mesh->setMinimumBounds(boxMin);
     mesh->setMaximumBounds(boxMax);
@@ -196,6 +211,7 @@ bool TinyObjLoader::load(const FilePath& filePath, MeshList& meshList)
     mesh->setSphereCenter(sphereCenter);
     mesh->setSphereRadius((sphereCenter - boxMin).getMagnitude());
 
+    // Tangents are accumulated over the faces sharing each vertex.
     MeshStreamPtr bitangentStream = MeshStream::create("i_" + MeshStream::BITANGENT_ATTRIBUTE, MeshStream::BITANGENT_ATTRIBUTE, 0);
     mesh->generateTangents(positionStream, texCoordStream, normalStream, tangentStream, bitangentStream);
     mesh->addStream(bitangentStream);
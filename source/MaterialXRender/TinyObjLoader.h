@@ -35,8 +35,14 @@ class TinyObjLoader : public GeometryLoader
     /// Default destructor
     virtual ~TinyObjLoader() {}
 
-    /// Load geometry from disk
-    bool load(const FilePath& filePath, MeshList& meshList) override;
+    /// Load geometry from disk with default options
+    bool load(const FilePath& filePath, MeshList& meshList) override
+    {
+        return load(filePath, meshList, GeometryLoadOptions());
+    }
+
+    /// Load geometry from disk using the given options
+    bool load(const FilePath& filePath, MeshList& meshList, const GeometryLoadOptions& options) override;
 };
 
 } // namespace MaterialX
@@ -10,6 +10,7 @@
 #include <MaterialXGenShader/Util.h>
 
 #include <cmath>
+#include <cstring>
 #include <iostream>
 
 namespace MaterialX
@@ -104,6 +105,12 @@ void GlslProgram::deleteProgram()
         _programId = UNDEFINED_OPENGL_RESOURCE_ID;
     }
 
+    for (const UniformBuffer& buffer : _uniformBuffers)
+    {
+        glDeleteBuffers(1, &buffer.bufferId);
+    }
+    _uniformBuffers.clear();
+
     // Program deleted, so also clear cached input lists
     clearInputLists();
 }
@@ -237,6 +244,11 @@ unsigned int GlslProgram::build()
         glDeleteShader(fragmentShaderId);
     }
 
+    if (errors.empty())
+    {
+        createUniformBuffers();
+    }
+
     // If we encountered any errors while trying to create return list
     // of all errors. That is we collect all errors per stage plus any
     // errors during linking and throw one exception for them all so that
@@ -250,6 +262,28 @@ unsigned int GlslProgram::build()
     return _programId;
 }
 
+void GlslProgram::createUniformBuffers()
+{
+    GLint blockCount = 0;
+    glGetProgramiv(_programId, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+    for (GLint i = 0; i < blockCount; i++)
+    {
+        // Each block is bound to the binding point matching its index.
+        GLint dataSize = 0;
+        glGetActiveUniformBlockiv(_programId, GLuint(i), GL_UNIFORM_BLOCK_DATA_SIZE, &dataSize);
+        glUniformBlockBinding(_programId, GLuint(i), GLuint(i));
+
+        UniformBuffer buffer;
+        buffer.data.assign(size_t(dataSize), 0);
+        buffer.modified = true;
+        glGenBuffers(1, &buffer.bufferId);
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer.bufferId);
+        glBufferData(GL_UNIFORM_BUFFER, dataSize, nullptr, GL_DYNAMIC_DRAW);
+        _uniformBuffers.push_back(buffer);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, UNDEFINED_OPENGL_RESOURCE_ID);
+}
+
 bool GlslProgram::bind()
 {
     if (_programId > UNDEFINED_OPENGL_RESOURCE_ID)
@@ -290,6 +324,7 @@ void GlslProgram::bindInputs(ViewHandlerPtr viewHandler,
     bindTextures(imageHandler);
     bindTimeAndFrame();
     bindLighting(lightHandler, imageHandler);
+    bindUniformBuffers();
 
     // Set up raster state for transparency as needed
     if (_shader->hasAttribute(HW::ATTR_TRANSPARENT))
@@ -461,27 +496,33 @@ void GlslProgram::bindStreams(MeshPtr mesh)
     findInputs(HW::GEOMATTR + "_", uniformList, foundList, false);
     for (const auto& Input : foundList)
     {
-        // Only handle float1-4 types for now
+        // Only handle float1-4 types for now.  Inputs held in uniform
+        // buffers are written to their buffer.
+        ValuePtr value;
         switch (Input.second->gltype)
         {
             case GL_INT:
-                glUniform1i(Input.second->location, 1);
+                value = Value::createValue(1);
                 break;
             case GL_FLOAT:
-                glUniform1f(Input.second->location, 0.0f);
+                value = Value::createValue(0.0f);
                 break;
             case GL_FLOAT_VEC2:
-                glUniform2f(Input.second->location, 0.0f, 0.0f);
+                value = Value::createValue(Vector2(0.0f, 0.0f));
                 break;
             case GL_FLOAT_VEC3:
-                glUniform3f(Input.second->location, 0.0f, 0.0f, 0.0f);
+                value = Value::createValue(Vector3(0.0f, 0.0f, 0.0f));
                 break;
             case GL_FLOAT_VEC4:
-                glUniform4f(Input.second->location, 0.0f, 0.0f, 0.0f, 1.0f);
+                value = Value::createValue(Vector4(0.0f, 0.0f, 0.0f, 1.0f));
                 break;
             default:
                 break;
         }
+        if (value)
+        {
+            bindUniform(*Input.second, *value);
+        }
     }
 
     checkErrors();
@@ -560,7 +601,7 @@ MaterialX::ValuePtr GlslProgram::findUniformValue(const std::string& uniformName
     if (uniform != uniformList.end())
     {
         int location = uniform->second->location;
-        if (location >= 0)
+        if (location >= 0 || uniform->second->bufferIndex >= 0)
         {
             return uniform->second->value;
         }
@@ -672,11 +713,7 @@ void GlslProgram::bindLighting(LightHandlerPtr lightHandler, ImageHandlerPtr ima
     auto input = uniformList.find(HW::NUM_ACTIVE_LIGHT_SOURCES);
     if (input != uniformList.end())
     {
-        location = input->second->location;
-        if (location >= 0)
-        {
-            glUniform1i(location, int(lightCount));
-        }
+        bindUniform(*input->second, *Value::createValue(int(lightCount)));
     }
     else
     {
@@ -718,9 +755,9 @@ void GlslProgram::bindLighting(LightHandlerPtr lightHandler, ImageHandlerPtr ima
                 {
                     // This is our radiance texture so set the mip count.
                     auto mipsUniform = uniformList.find(HW::ENV_RADIANCE_MIPS);
-                    if (mipsUniform != uniformList.end() && mipsUniform->second->location >= 0)
+                    if (mipsUniform != uniformList.end())
                     {
-                        glUniform1i(mipsUniform->second->location, desc.mipCount);
+                        bindUniform(*mipsUniform->second, *Value::createValue(int(desc.mipCount)));
                     }
                 }
             }
@@ -861,6 +898,161 @@ void GlslProgram::bindUniform(int location, const Value& value)
     }
 }
 
+void GlslProgram::bindUniform(const Input& input, const Value& value)
+{
+    if (input.bufferIndex >= 0)
+    {
+        writeUniformBuffer(input, value);
+    }
+    else
+    {
+        bindUniform(input.location, value);
+    }
+}
+
+void GlslProgram::bindUniform(const Input& input, const Matrix44& matrix)
+{
+    if (input.bufferIndex >= 0)
+    {
+        writeUniformBuffer(input, *Value::createValue(matrix));
+    }
+    else if (input.location >= 0)
+    {
+        glUniformMatrix4fv(input.location, 1, false, matrix.getTranspose().data());
+    }
+}
+
+bool GlslProgram::setUniformValue(const string& name, const Value& value)
+{
+    const GlslProgram::InputMap& uniformList = getUniformsList();
+    auto input = uniformList.find(name);
+    if (input == uniformList.end())
+    {
+        return false;
+    }
+    bindUniform(*input->second, value);
+    return true;
+}
+
+void GlslProgram::writeUniformBuffer(const Input& input, const Value& value)
+{
+    UniformBuffer& buffer = _uniformBuffers[input.bufferIndex];
+    writeUniformBufferValue(buffer.data, input.bufferOffset, input.bufferStride, value);
+    buffer.modified = true;
+}
+
+void GlslProgram::writeUniformBufferValue(vector<char>& data, size_t offset, size_t stride, const Value& value)
+{
+    auto write = [&data](size_t start, const void* source, size_t size)
+    {
+        if (start + size <= data.size())
+        {
+            memcpy(&data[start], source, size);
+        }
+    };
+
+    // Vectors are written as consecutive components, while matrices are
+    // written one column at a time and arrays one element at a time.
+    const string& type = value.getTypeString();
+    if (type == "float")
+    {
+        float v = value.asA<float>();
+        write(offset, &v, sizeof(v));
+    }
+    else if (type == "integer")
+    {
+        int v = value.asA<int>();
+        write(offset, &v, sizeof(v));
+    }
+    else if (type == "boolean")
+    {
+        int v = value.asA<bool>() ? 1 : 0;
+        write(offset, &v, sizeof(v));
+    }
+    else if (type == "color2")
+    {
+        write(offset, value.asA<Color2>().data(), 2 * sizeof(float));
+    }
+    else if (type == "color3")
+    {
+        write(offset, value.asA<Color3>().data(), 3 * sizeof(float));
+    }
+    else if (type == "color4")
+    {
+        write(offset, value.asA<Color4>().data(), 4 * sizeof(float));
+    }
+    else if (type == "vector2")
+    {
+        write(offset, value.asA<Vector2>().data(), 2 * sizeof(float));
+    }
+    else if (type == "vector3")
+    {
+        write(offset, value.asA<Vector3>().data(), 3 * sizeof(float));
+    }
+    else if (type == "vector4")
+    {
+        write(offset, value.asA<Vector4>().data(), 4 * sizeof(float));
+    }
+    else if (type == "matrix33")
+    {
+        Matrix33 m = value.asA<Matrix33>();
+        for (size_t col = 0; col < 3; col++)
+        {
+            Vector3 column(m[0][col], m[1][col], m[2][col]);
+            write(offset + col * stride, column.data(), 3 * sizeof(float));
+        }
+    }
+    else if (type == "matrix44")
+    {
+        Matrix44 m = value.asA<Matrix44>();
+        for (size_t col = 0; col < 4; col++)
+        {
+            Vector4 column(m[0][col], m[1][col], m[2][col], m[3][col]);
+            write(offset + col * stride, column.data(), 4 * sizeof(float));
+        }
+    }
+    else if (type == "floatarray")
+    {
+        const vector<float>& v = value.asA<vector<float>>();
+        for (size_t i = 0; i < v.size(); i++)
+        {
+            write(offset + i * stride, &v[i], sizeof(float));
+        }
+    }
+    else if (type == "integerarray")
+    {
+        const vector<int>& v = value.asA<vector<int>>();
+        for (size_t i = 0; i < v.size(); i++)
+        {
+            write(offset + i * stride, &v[i], sizeof(int));
+        }
+    }
+    else
+    {
+        throw ExceptionShaderValidationError(
+            "GLSL input binding error.",
+            { "Unsupported data type when setting uniform buffer value" }
+        );
+    }
+}
+
+void GlslProgram::bindUniformBuffers()
+{
+    for (size_t i = 0; i < _uniformBuffers.size(); i++)
+    {
+        UniformBuffer& buffer = _uniformBuffers[i];
+        if (buffer.modified)
+        {
+            glBindBuffer(GL_UNIFORM_BUFFER, buffer.bufferId);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, GLsizeiptr(buffer.data.size()), buffer.data.data());
+            buffer.modified = false;
+        }
+        glBindBufferBase(GL_UNIFORM_BUFFER, GLuint(i), buffer.bufferId);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, UNDEFINED_OPENGL_RESOURCE_ID);
+    checkErrors();
+}
+
 
 void GlslProgram::bindViewInformation(ViewHandlerPtr viewHandler)
 {
@@ -878,8 +1070,6 @@ void GlslProgram::bindViewInformation(ViewHandlerPtr viewHandler)
         throw ExceptionShaderValidationError(errorType, errors);
     }
 
-    GLint location = GlslProgram::UNDEFINED_OPENGL_PROGRAM_LOCATION;
-
     //
     // View direction and position
     //
@@ -887,20 +1077,12 @@ void GlslProgram::bindViewInformation(ViewHandlerPtr viewHandler)
     auto Input = uniformList.find(HW::VIEW_POSITION);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniform3fv(location, 1, viewHandler->viewPosition().data());
-        }
+        bindUniform(*Input->second, *Value::createValue(viewHandler->viewPosition()));
     }
     Input = uniformList.find(HW::VIEW_DIRECTION);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniform3fv(location, 1, viewHandler->viewDirection().data());
-        }
+        bindUniform(*Input->second, *Value::createValue(viewHandler->viewDirection()));
     }
 
     //
@@ -914,41 +1096,25 @@ void GlslProgram::bindViewInformation(ViewHandlerPtr viewHandler)
     Input = uniformList.find(HW::WORLD_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, world.getTranspose().data());
-        }
+        bindUniform(*Input->second, world);
     }
     // World transpose matrix
     Input = uniformList.find(HW::WORLD_TRANSPOSE_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, world.data());
-        }
+        bindUniform(*Input->second, world.getTranspose());
     }
     // World inverse matrix
     Input = uniformList.find(HW::WORLD_INVERSE_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, invWorld.getTranspose().data());
-        }
+        bindUniform(*Input->second, invWorld);
     }
     // World inverse transpose matrix
     Input = uniformList.find(HW::WORLD_INVERSE_TRANSPOSE_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, invTransWorld.getTranspose().data());
-        }
+        bindUniform(*Input->second, invTransWorld);
     }
 
     //
@@ -959,42 +1125,26 @@ void GlslProgram::bindViewInformation(ViewHandlerPtr viewHandler)
     Input = uniformList.find(HW::PROJ_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, proj.getTranspose().data());
-        }
+        bindUniform(*Input->second, proj);
     }
     // Projection tranpose matrix
     Input = uniformList.find(HW::PROJ_TRANSPOSE_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, proj.data());
-        }
+        bindUniform(*Input->second, proj.getTranspose());
     }
     // Projection inverse matrix
     Matrix44 projInverse= proj.getInverse();
     Input = uniformList.find(HW::PROJ_INVERSE_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, projInverse.getTranspose().data());
-        }
+        bindUniform(*Input->second, projInverse);
     }
     // Projection inverse transpose matrix
     Input = uniformList.find(HW::PROJ_INVERSE_TRANSPOSE_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, projInverse.data());
-        }
+        bindUniform(*Input->second, projInverse.getTranspose());
     }
 
 
@@ -1007,42 +1157,26 @@ void GlslProgram::bindViewInformation(ViewHandlerPtr viewHandler)
     Input = uniformList.find(HW::VIEW_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, view.getTranspose().data());
-        }
+        bindUniform(*Input->second, view);
     }
     // View tranpose
     Input = uniformList.find(HW::VIEW_TRANSPOSE_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, view.data());
-        }
+        bindUniform(*Input->second, view.getTranspose());
     }
     // View inverse
     Matrix44 viewInverse = view.getInverse();
     Input = uniformList.find(HW::VIEW_INVERSE_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, viewInverse.getTranspose().data());
-        }
+        bindUniform(*Input->second, viewInverse);
     }
     // View inverse transpose
     Input = uniformList.find(HW::VIEW_INVERSE_TRANSPOSE_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, viewInverse.data());
-        }
+        bindUniform(*Input->second, viewInverse.getTranspose());
     }
     
     //
@@ -1052,11 +1186,7 @@ void GlslProgram::bindViewInformation(ViewHandlerPtr viewHandler)
     Input = uniformList.find(HW::VIEW_PROJECTION_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, viewProj.getTranspose().data());
-        }
+        bindUniform(*Input->second, viewProj);
     }
 
     //
@@ -1066,11 +1196,7 @@ void GlslProgram::bindViewInformation(ViewHandlerPtr viewHandler)
     Input = uniformList.find(HW::WORLD_VIEW_PROJECTION_MATRIX);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniformMatrix4fv(location, 1, false, viewProjWorld.getTranspose().data());
-        }
+        bindUniform(*Input->second, viewProjWorld);
     } 
 
     checkErrors();
@@ -1087,29 +1213,19 @@ void GlslProgram::bindTimeAndFrame()
         throw ExceptionShaderValidationError(errorType, errors);
     }
 
-    GLint location = GlslProgram::UNDEFINED_OPENGL_PROGRAM_LOCATION;
-
     // Bind time
     const GlslProgram::InputMap& uniformList = getUniformsList();
     auto Input = uniformList.find(HW::TIME);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniform1f(location, 1.0f);
-        }
+        bindUniform(*Input->second, *Value::createValue(1.0f));
     }
 
     // Bind frame
     Input = uniformList.find(HW::FRAME);
     if (Input != uniformList.end())
     {
-        location = Input->second->location;
-        if (location >= 0)
-        {
-            glUniform1f(location, 1.0f);
-        }
+        bindUniform(*Input->second, *Value::createValue(1.0f));
     }
 }
 
@@ -1179,6 +1295,29 @@ const GlslProgram::InputMap& GlslProgram::updateUniformsList()
             InputPtr inputPtr = std::make_shared<Input>(uniformLocation, uniformType, uniformSize, EMPTY_STRING);
             _uniformList[std::string(uniformName)] = inputPtr;
         }
+        else
+        {
+            // Members of uniform blocks have no location, and are instead
+            // set through the uniform buffer of their block.
+            GLuint uniformIndex = GLuint(i);
+            GLint blockIndex = -1;
+            glGetActiveUniformsiv(_programId, 1, &uniformIndex, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+            if (blockIndex >= 0 && size_t(blockIndex) < _uniformBuffers.size())
+            {
+                GLint offset = 0;
+                GLint arrayStride = 0;
+                GLint matrixStride = 0;
+                glGetActiveUniformsiv(_programId, 1, &uniformIndex, GL_UNIFORM_OFFSET, &offset);
+                glGetActiveUniformsiv(_programId, 1, &uniformIndex, GL_UNIFORM_ARRAY_STRIDE, &arrayStride);
+                glGetActiveUniformsiv(_programId, 1, &uniformIndex, GL_UNIFORM_MATRIX_STRIDE, &matrixStride);
+
+                InputPtr inputPtr = std::make_shared<Input>(uniformLocation, uniformType, uniformSize, EMPTY_STRING);
+                inputPtr->bufferIndex = blockIndex;
+                inputPtr->bufferOffset = size_t(offset);
+                inputPtr->bufferStride = size_t(arrayStride > 0 ? arrayStride : matrixStride);
+                _uniformList[std::string(uniformName)] = inputPtr;
+            }
+        }
     }
     delete[] uniformName;
 
@@ -1289,6 +1428,17 @@ const GlslProgram::InputMap& GlslProgram::updateUniformsList()
             }
         }
 
+        // Initialize uniform buffers with the values assigned during
+        // shader generation.
+        for (const auto& uniform : _uniformList)
+        {
+            const Input& input = *uniform.second;
+            if (input.bufferIndex >= 0 && input.value && !input.typeString.empty())
+            {
+                writeUniformBuffer(input, *input.value);
+            }
+        }
+
         // Throw an error if any type mismatches were found
         if (uniformTypeMismatchFound)
         {
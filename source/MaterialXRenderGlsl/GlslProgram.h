@@ -95,6 +95,14 @@ class GlslProgram
         bool isConstant;
         /// Element path (if any)
         string path;
+        /// Index of the uniform buffer holding the input. -1 means the input is not
+        /// stored in a uniform buffer
+        int bufferIndex;
+        /// Byte offset of the input within its uniform buffer
+        size_t bufferOffset;
+        /// Byte stride between the array elements or matrix columns of the input
+        /// within its uniform buffer
+        size_t bufferStride;
 
         /// Program input constructor
         Input(int inputLocation, int inputType, int inputSize, string inputPath)
@@ -103,6 +111,9 @@ class GlslProgram
             , size(inputSize)
             , isConstant(false)
             , path(inputPath)
+            , bufferIndex(-1)
+            , bufferOffset(0)
+            , bufferStride(0)
         { }
     };
     /// Program input structure shared pointer type
@@ -155,6 +166,22 @@ class GlslProgram
     /// Assign a parameter value to a uniform
     void bindUniform(int location, const Value& value);
 
+    /// Assign a parameter value to a uniform by name. Uniforms stored in a
+    /// uniform buffer are written to a copy of the buffer held by the program,
+    /// which is uploaded by the next call to bindUniformBuffers().
+    /// @return False if the program has no uniform with the given name.
+    bool setUniformValue(const string& name, const Value& value);
+
+    /// Bind the uniform buffers of the program, first uploading the contents
+    /// of any buffer modified since it was last bound in a single update.
+    void bindUniformBuffers();
+
+    /// Write a value to the contents of a std140 uniform buffer.  Vectors are
+    /// written as consecutive components at the given byte offset, while
+    /// matrix columns and array elements are written the given number of
+    /// bytes apart.  Components beyond the end of the buffer are not written.
+    static void writeUniformBufferValue(vector<char>& data, size_t offset, size_t stride, const Value& value);
+
     /// Bind attribute buffers to attribute inputs.
     /// A hardware buffer of the given attribute type is created and bound to the program locations
     /// for the input attribute.
@@ -242,6 +269,20 @@ class GlslProgram
     /// Delete any currently created shader program
     void deleteProgram();
 
+    /// Create a uniform buffer for each active uniform block of the program
+    void createUniformBuffers();
+
+    /// Assign a parameter value to a uniform input, either at its program
+    /// location or in its uniform buffer
+    void bindUniform(const Input& input, const Value& value);
+
+    /// Assign a matrix to a uniform input, either at its program location
+    /// or in its uniform buffer
+    void bindUniform(const Input& input, const Matrix44& matrix);
+
+    /// Write a parameter value to the uniform buffer holding an input
+    void writeUniformBuffer(const Input& input, const Value& value);
+
     /// @}
 
   private:
@@ -277,6 +318,18 @@ class GlslProgram
 
     /// Enabled vertex stream program locations
     std::set<int> _enabledStreamLocations;
+
+    /// A uniform buffer, along with a copy of its contents that is
+    /// updated as uniform values are set.
+    struct UniformBuffer
+    {
+        unsigned int bufferId;
+        vector<char> data;
+        bool modified;
+    };
+
+    /// Uniform buffers, indexed by uniform block index
+    vector<UniformBuffer> _uniformBuffers;
 };
 
 } // namespace MaterialX
@@ -0,0 +1,113 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/Catch/catch.hpp>
+
+#include <MaterialXFormat/BinaryIo.h>
+#include <MaterialXFormat/File.h>
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+namespace mx = MaterialX;
+
+TEST_CASE("Binary round trip", "[binaryio]")
+{
+    mx::FilePath libraryPath("libraries/stdlib");
+    mx::FilePath examplesPath("resources/Materials/Examples/Syntax");
+    std::string searchPath = libraryPath.asString() +
+                             mx::PATH_LIST_SEPARATOR +
+                             examplesPath.asString();
+
+    mx::FilePathVec filenames = examplesPath.getFilesInDirectory(mx::MTLX_EXTENSION);
+    filenames.push_back(mx::FilePath("resources/Materials/Examples/StandardSurface/standard_surface_look_brass_tiled.mtlx"));
+    for (const mx::FilePath& filename : filenames)
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, filename, searchPath);
+
+        // Verify that a binary round trip reproduces the document exactly,
+        // including the source URIs used to write XInclude references.
+        std::string buffer = mx::writeToBinaryString(doc);
+        mx::DocumentPtr binaryDoc = mx::createDocument();
+        mx::readFromBinaryBuffer(binaryDoc, buffer.data(), buffer.size());
+        REQUIRE(*binaryDoc == *doc);
+        REQUIRE(binaryDoc->getSourceUri() == doc->getSourceUri());
+        REQUIRE(mx::writeToXmlString(binaryDoc) == mx::writeToXmlString(doc));
+        mx::XmlWriteOptions writeOptions;
+        writeOptions.writeXIncludeEnable = false;
+        REQUIRE(mx::writeToXmlString(binaryDoc, &writeOptions) == mx::writeToXmlString(doc, &writeOptions));
+        REQUIRE(mx::writeToBinaryString(binaryDoc) == buffer);
+    }
+
+    // Round trip through a binary file.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, filenames[0], searchPath);
+    mx::writeToBinaryFile(doc, "binary_round_trip.mtlxb");
+    mx::DocumentPtr binaryDoc = mx::createDocument();
+    mx::readFromBinaryFile(binaryDoc, "binary_round_trip.mtlxb");
+    REQUIRE(*binaryDoc == *doc);
+
+    // Read into a document with duplicate and conflicting content.
+    mx::readFromBinaryFile(binaryDoc, "binary_round_trip.mtlxb");
+    REQUIRE(*binaryDoc == *doc);
+    mx::ElementPtr child = binaryDoc->getChildren()[0];
+    child->setAttribute("conflict", "true");
+    REQUIRE_THROWS_AS(mx::readFromBinaryFile(binaryDoc, "binary_round_trip.mtlxb"), mx::Exception&);
+    mx::CopyOptions copyOptions;
+    copyOptions.skipConflictingElements = true;
+    mx::readFromBinaryFile(binaryDoc, "binary_round_trip.mtlxb", mx::EMPTY_STRING, &copyOptions);
+    REQUIRE(binaryDoc->getChild(child->getName()) == child);
+    REQUIRE(child->getAttribute("conflict") == "true");
+    std::remove("binary_round_trip.mtlxb");
+
+    // Invalid and truncated buffers.
+    std::string buffer = mx::writeToBinaryString(doc);
+    REQUIRE_THROWS_AS(mx::readFromBinaryBuffer(mx::createDocument(), buffer.data(), buffer.size() - 4), mx::ExceptionParseError&);
+    REQUIRE_THROWS_AS(mx::readFromBinaryBuffer(mx::createDocument(), buffer.data() + 4, buffer.size() - 4), mx::ExceptionParseError&);
+    REQUIRE_THROWS_AS(mx::readFromBinaryFile(mx::createDocument(), "NonExistent.mtlxb"), mx::ExceptionFileMissing&);
+}
+
+TEST_CASE("Binary load performance", "[.benchmark]")
+{
+    mx::FilePath libraryPath("libraries/stdlib");
+    const int iterations = 20;
+
+    // Read the standard library as XML and encode it in binary form.
+    mx::FilePathVec filenames = libraryPath.getFilesInDirectory(mx::MTLX_EXTENSION);
+    std::vector<std::string> xmlBuffers;
+    std::vector<std::string> binaryBuffers;
+    for (const mx::FilePath& filename : filenames)
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, filename, libraryPath.asString());
+        xmlBuffers.push_back(mx::writeToXmlString(doc));
+        binaryBuffers.push_back(mx::writeToBinaryString(doc));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        for (const std::string& buffer : xmlBuffers)
+        {
+            mx::readFromXmlString(mx::createDocument(), buffer);
+        }
+    }
+    std::chrono::duration<double> xmlTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        for (const std::string& buffer : binaryBuffers)
+        {
+            mx::readFromBinaryBuffer(mx::createDocument(), buffer.data(), buffer.size());
+        }
+    }
+    std::chrono::duration<double> binaryTime = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Standard library load, XML: " << xmlTime.count() << "s, binary: " << binaryTime.count() << "s" << std::endl;
+    REQUIRE(binaryTime.count() < xmlTime.count());
+}
@@ -7,6 +7,9 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <chrono>
+#include <iostream>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Document", "[document]")
@@ -108,3 +111,163 @@ TEST_CASE("Document", "[document]")
     // Validate the combined document.
     REQUIRE(doc->validate());
 }
+
+TEST_CASE("Document cache", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_test", "color3", "test");
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_test");
+    nodeGraph->setNodeDef(nodeDef);
+    mx::NodePtr node = nodeGraph->addNode("test", "node1", "color3");
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(node);
+
+    // Prime the cache.
+    REQUIRE(doc->getMatchingNodeDefs("test").size() == 1);
+    REQUIRE(doc->getMatchingImplementations("ND_test").size() == 1);
+    REQUIRE(doc->getMatchingPorts("node1").size() == 1);
+
+    // Edit cache keys on existing elements.
+    nodeDef->setNodeString("test2");
+    REQUIRE(doc->getMatchingNodeDefs("test").empty());
+    REQUIRE(doc->getMatchingNodeDefs("test2").size() == 1);
+    output->removeAttribute(mx::PortElement::NODE_NAME_ATTRIBUTE);
+    REQUIRE(doc->getMatchingPorts("node1").empty());
+    output->setNodeName("node1");
+    REQUIRE(doc->getMatchingPorts("node1").size() == 1);
+
+    // Apply a namespace above existing elements.
+    nodeGraph->setNamespace("custom");
+    REQUIRE(doc->getMatchingImplementations("ND_test").empty());
+    REQUIRE(doc->getMatchingImplementations("custom:ND_test").size() == 1);
+    REQUIRE(doc->getMatchingPorts("custom:node1").size() == 1);
+    REQUIRE(doc->getMatchingNodeDefs("test2").size() == 1);
+
+    // Add and remove elements.
+    mx::NodeDefPtr nodeDef2 = doc->addNodeDef("ND_test2", "float", "test2");
+    REQUIRE(doc->getMatchingNodeDefs("test2").size() == 2);
+    doc->removeNodeDef(nodeDef->getName());
+    REQUIRE(doc->getMatchingNodeDefs("test2").size() == 1);
+    REQUIRE(doc->getMatchingNodeDefs("test2")[0] == nodeDef2);
+    doc->removeNodeGraph(nodeGraph->getName());
+    REQUIRE(doc->getMatchingImplementations("custom:ND_test").empty());
+    REQUIRE(doc->getMatchingPorts("custom:node1").empty());
+
+    // Import a library into a document with a valid cache.
+    mx::DocumentPtr library = mx::createDocument();
+    library->setNamespace("lib");
+    library->addNodeDef("ND_lib", "float", "test2");
+    doc->importLibrary(library);
+    REQUIRE(doc->getMatchingNodeDefs("test2").size() == 1);
+    REQUIRE(doc->getMatchingNodeDefs("lib:test2").size() == 1);
+
+    // Compare against a cache built from scratch.
+    mx::DocumentPtr copy = doc->copy();
+    for (const std::string& nodeName : mx::StringVec{ "test", "test2", "lib:test2" })
+    {
+        REQUIRE(doc->getMatchingNodeDefs(nodeName).size() == copy->getMatchingNodeDefs(nodeName).size());
+    }
+}
+
+TEST_CASE("Referenced libraries", "[document]")
+{
+    // Create a namespaced library with a definition and implementation.
+    mx::DocumentPtr library = mx::createDocument();
+    library->setNamespace("custom");
+    mx::NodeDefPtr libNodeDef = library->addNodeDef("ND_simpleSrf", "surfaceshader", "simpleSrf");
+    libNodeDef->addInput("diffColor", "color3");
+    mx::ImplementationPtr libImpl = library->addImplementation("IM_simpleSrf");
+    libImpl->setNodeDef(libNodeDef);
+
+    // Reference the library from several documents.
+    std::vector<mx::DocumentPtr> docs;
+    for (int i = 0; i < 3; i++)
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        doc->referenceLibrary(library);
+        mx::MaterialPtr material = doc->addMaterial();
+        material->addShaderRef("sr1", "simpleSrf");
+        mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+        nodeGraph->addNode("simpleSrf", "node1", "surfaceshader");
+        docs.push_back(doc);
+    }
+
+    for (mx::DocumentPtr doc : docs)
+    {
+        // Library content is resolved without being copied.
+        REQUIRE(doc->getNodeDefs().empty());
+        REQUIRE(doc->getNodeDef("custom:ND_simpleSrf") == libNodeDef);
+        REQUIRE(doc->getNodeDef("ND_simpleSrf") == nullptr);
+        REQUIRE(doc->getImplementation("custom:IM_simpleSrf") == libImpl);
+        REQUIRE(doc->getMatchingNodeDefs("custom:simpleSrf").size() == 1);
+        REQUIRE(doc->getMatchingImplementations("custom:ND_simpleSrf").size() == 1);
+
+        // References from document content resolve through the library.
+        mx::ShaderRefPtr shaderRef = doc->getMaterials()[0]->getShaderRef("sr1");
+        shaderRef->setNodeDefString("custom:ND_simpleSrf");
+        REQUIRE(shaderRef->getNodeDef() == libNodeDef);
+        mx::NodePtr node = doc->getNodeGraphs()[0]->getNode("node1");
+        node->setNodeDefString("custom:ND_simpleSrf");
+        REQUIRE(node->getNodeDef() == libNodeDef);
+        REQUIRE(node->getImplementation() == libImpl);
+        REQUIRE(doc->validate());
+
+        // Local definitions take precedence over referenced ones.
+        mx::NodeDefPtr localNodeDef = doc->addNodeDef("custom:ND_simpleSrf", "surfaceshader", "simpleSrf");
+        REQUIRE(doc->getNodeDef("custom:ND_simpleSrf") == localNodeDef);
+        doc->removeNodeDef(localNodeDef->getName());
+
+        // Library references are preserved by document copies.
+        mx::DocumentPtr copy = doc->copy();
+        REQUIRE(copy->getNodeDef("custom:ND_simpleSrf") == libNodeDef);
+        copy->clearReferencedLibraries();
+        REQUIRE(copy->getNodeDef("custom:ND_simpleSrf") == nullptr);
+    }
+    REQUIRE_THROWS_AS(docs[0]->referenceLibrary(docs[0]), mx::Exception&);
+
+    // Cyclic library references are rejected.
+    REQUIRE_THROWS_AS(library->referenceLibrary(docs[0]), mx::ExceptionFoundCycle&);
+    mx::DocumentPtr nested = mx::createDocument();
+    nested->setNamespace("nested");
+    mx::NodeDefPtr nestedNodeDef = nested->addNodeDef("ND_nestedSrf", "surfaceshader", "nestedSrf");
+    library->referenceLibrary(nested);
+    REQUIRE_THROWS_AS(nested->referenceLibrary(docs[0]), mx::ExceptionFoundCycle&);
+
+    // Nested references are searched beyond a library of another namespace.
+    REQUIRE(docs[0]->getNodeDef("nested:ND_nestedSrf") == nestedNodeDef);
+}
+
+TEST_CASE("Document cache scaling", "[.benchmark]")
+{
+    using Clock = std::chrono::steady_clock;
+    const int EDIT_COUNT = 1000;
+
+    // Time interleaved edits and lookups on a document of the given size.
+    auto timeEdits = [EDIT_COUNT](int nodeDefCount)
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        for (int i = 0; i < nodeDefCount; i++)
+        {
+            doc->addNodeDef("ND_node" + std::to_string(i), "float", "node" + std::to_string(i));
+        }
+        mx::NodeDefPtr nodeDef = doc->getNodeDef("ND_node0");
+        REQUIRE(doc->getMatchingNodeDefs("node0").size() == 1);
+
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < EDIT_COUNT; i++)
+        {
+            const std::string nodeString = (i % 2) ? "node0" : "edited";
+            nodeDef->setNodeString(nodeString);
+            REQUIRE(doc->getMatchingNodeDefs(nodeString).size() == 1);
+        }
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    double smallTime = timeEdits(10);
+    double largeTime = timeEdits(10000);
+    std::cout << "Edit and lookup time for 10 nodedefs: " << smallTime << "s" << std::endl;
+    std::cout << "Edit and lookup time for 10000 nodedefs: " << largeTime << "s" << std::endl;
+
+    // The cost of an edit plus lookup should be independent of document size.
+    REQUIRE(largeTime < smallTime * 10.0);
+}
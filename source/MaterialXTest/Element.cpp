@@ -7,8 +7,175 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/XmlIo.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define MATERIALX_HAS_MALLINFO2
+#endif
+
 namespace mx = MaterialX;
 
+namespace {
+
+// Return the heap memory in use by the process in bytes, or zero if it
+// cannot be queried on this platform.
+size_t getHeapMemory()
+{
+#if defined(MATERIALX_HAS_MALLINFO2)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+// An allocator counting the allocations made through it, which otherwise
+// allocates from the heap as std::make_shared does.
+template <class T> class CountingAllocator
+{
+  public:
+    using value_type = T;
+
+    explicit CountingAllocator(size_t& count) :
+        _count(&count)
+    {
+    }
+    template <class U> CountingAllocator(const CountingAllocator<U>& other) :
+        _count(other._count)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        (*_count)++;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* ptr, size_t n)
+    {
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    template <class U> bool operator==(const CountingAllocator<U>& other) const
+    {
+        return _count == other._count;
+    }
+    template <class U> bool operator!=(const CountingAllocator<U>& other) const
+    {
+        return _count != other._count;
+    }
+
+    size_t* _count;
+};
+
+// A bump arena from which elements are allocated, releasing its blocks only
+// when the last allocator referencing it is destroyed.
+const size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+class Arena
+{
+  public:
+    Arena() :
+        _offset(ARENA_BLOCK_SIZE)
+    {
+    }
+
+    void* allocate(size_t size)
+    {
+        size = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        if (_offset + size > ARENA_BLOCK_SIZE)
+        {
+            _blocks.emplace_back(new char[std::max(size, ARENA_BLOCK_SIZE)]);
+            _offset = 0;
+        }
+        void* ptr = _blocks.back().get() + _offset;
+        _offset += size;
+        return ptr;
+    }
+
+    size_t getBlockCount() const
+    {
+        return _blocks.size();
+    }
+
+  private:
+    std::vector<std::unique_ptr<char[]>> _blocks;
+    size_t _offset;
+};
+
+// An allocator drawing from a shared arena, as prototyped for elements.  Each
+// control block created by std::allocate_shared holds a copy, and with it a
+// reference to the arena.
+template <class T> class ArenaAllocator
+{
+  public:
+    using value_type = T;
+
+    explicit ArenaAllocator(std::shared_ptr<Arena> arena) :
+        _arena(arena)
+    {
+    }
+    template <class U> ArenaAllocator(const ArenaAllocator<U>& other) :
+        _arena(other._arena)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(_arena->allocate(n * sizeof(T)));
+    }
+    void deallocate(T*, size_t)
+    {
+    }
+
+    template <class U> bool operator==(const ArenaAllocator<U>& other) const
+    {
+        return _arena == other._arena;
+    }
+    template <class U> bool operator!=(const ArenaAllocator<U>& other) const
+    {
+        return _arena != other._arena;
+    }
+
+    std::shared_ptr<Arena> _arena;
+};
+
+// Create an element of the same class and name as the given element with the
+// given allocator, as the creator functions of elements would with an arena.
+template <class Alloc> mx::ElementPtr createElementLike(mx::ConstElementPtr elem, mx::ElementPtr parent, const Alloc& alloc)
+{
+    const std::string& name = elem->getName();
+    if (elem->isA<mx::NodeDef>())
+        return std::allocate_shared<mx::NodeDef>(alloc, parent, name);
+    if (elem->isA<mx::NodeGraph>())
+        return std::allocate_shared<mx::NodeGraph>(alloc, parent, name);
+    if (elem->isA<mx::Node>())
+        return std::allocate_shared<mx::Node>(alloc, parent, name);
+    if (elem->isA<mx::Input>())
+        return std::allocate_shared<mx::Input>(alloc, parent, name);
+    if (elem->isA<mx::Parameter>())
+        return std::allocate_shared<mx::Parameter>(alloc, parent, name);
+    if (elem->isA<mx::Output>())
+        return std::allocate_shared<mx::Output>(alloc, parent, name);
+    if (elem->isA<mx::TypeDef>())
+        return std::allocate_shared<mx::TypeDef>(alloc, parent, name);
+    if (elem->isA<mx::Member>())
+        return std::allocate_shared<mx::Member>(alloc, parent, name);
+    if (elem->isA<mx::Implementation>())
+        return std::allocate_shared<mx::Implementation>(alloc, parent, name);
+    if (elem->isA<mx::GeomPropDef>())
+        return std::allocate_shared<mx::GeomPropDef>(alloc, parent, name);
+    return std::allocate_shared<mx::GenericElement>(alloc, parent, name);
+}
+
+} // anonymous namespace
+
 TEST_CASE("Element", "[element]")
 {
     // Create a document.
@@ -40,6 +207,21 @@ TEST_CASE("Element", "[element]")
     REQUIRE(elem1->getTypedAttribute<bool>("customColor") == false);
     REQUIRE(elem1->getTypedAttribute<mx::Color3>("customFlag") == mx::Color3(0.0f));
 
+    // Modify and remove attributes, preserving their order.
+    elem2->setAttribute("attr1", "value1");
+    elem2->setAttribute("attr2", "value2");
+    elem2->setAttribute("attr3", "value3");
+    elem2->setAttribute("attr1", "value4");
+    REQUIRE(elem2->getAttributeNames().asStringVec() == (mx::StringVec{ "attr1", "attr2", "attr3" }));
+    elem2->removeAttribute("attr2");
+    REQUIRE(!elem2->hasAttribute("attr2"));
+    REQUIRE(elem2->getAttributeNames().asStringVec() == (mx::StringVec{ "attr1", "attr3" }));
+    REQUIRE(elem2->getAttribute("attr1") == "value4");
+    REQUIRE(elem2->getAttribute("attr3") == "value3");
+    elem2->removeAttribute("attr1");
+    elem2->removeAttribute("attr3");
+    REQUIRE(elem2->getAttributeNames().empty());
+
     // Modify element names.
     elem1->setName("elem1");
     elem2->setName("elem2");
@@ -57,6 +239,39 @@ TEST_CASE("Element", "[element]")
     REQUIRE_THROWS_AS(doc2->setChildIndex("elem1", 100), mx::Exception&);
     REQUIRE(*doc2 == *doc);
 
+    // Reorder and remove children, verifying that indices remain consistent.
+    mx::ElementPtr parent = doc2->addChildOfCategory("generic", "parent");
+    for (int i = 0; i < 10; i++)
+    {
+        parent->addChildOfCategory("generic", "child" + std::to_string(i));
+    }
+    parent->setChildIndex("child7", 2);
+    parent->setChildIndex("child1", 8);
+    parent->removeChild("child4");
+    parent->setChildIndex("child9", 0);
+    mx::StringVec expectedOrder = { "child9", "child0", "child7", "child2", "child3",
+                                    "child5", "child6", "child8", "child1" };
+    REQUIRE(parent->getChildren().size() == expectedOrder.size());
+    for (size_t i = 0; i < expectedOrder.size(); i++)
+    {
+        REQUIRE(parent->getChildren()[i]->getName() == expectedOrder[i]);
+        REQUIRE(parent->getChildIndex(expectedOrder[i]) == (int) i);
+    }
+    REQUIRE(parent->getChildIndex("child4") == -1);
+
+    // Change the subclass of a child, preserving its name, position and content.
+    mx::NodeDefPtr nodeDef = doc2->addNodeDef("ND_test", "float", "test");
+    nodeDef->addParameter("param1", "float");
+    nodeDef->addParameter("param2", "float")->setValueString("0.5");
+    nodeDef->addInput("input1", "float");
+    mx::InputPtr changed = nodeDef->changeChildSubclass<mx::Input>(nodeDef->getParameter("param2"));
+    REQUIRE(nodeDef->getInput("param2") == changed);
+    REQUIRE(nodeDef->getChildIndex("param2") == 1);
+    REQUIRE(changed->getValueString() == "0.5");
+    REQUIRE(nodeDef->getParameterCount() == 1);
+    REQUIRE(nodeDef->getInputCount() == 2);
+    REQUIRE_THROWS_AS(parent->changeChildSubclass<mx::Input>(changed), mx::Exception&);
+
     // Create and test an orphaned element.
     mx::ElementPtr orphan;
     {
@@ -64,5 +279,127 @@ TEST_CASE("Element", "[element]")
         orphan = doc3->getChild("elem1");
         REQUIRE(orphan);
     }
+    REQUIRE(orphan->getTypedAttribute<bool>("customFlag") == true);
     REQUIRE_THROWS_AS(orphan->getDocument(), mx::ExceptionOrphanedElement&);    
 }
+
+TEST_CASE("Attribute memory", "[.benchmark]")
+{
+    // Heap memory of one document holding stdlib_defs.mtlx and stdlib_ng.mtlx,
+    // measured with this test on 64-bit glibc before attribute names were
+    // interned, when each element held a StringMap and a StringVec of names.
+    const size_t BASELINE_DOCUMENT_MEMORY = 3976003;
+    const size_t DOCUMENT_COUNT = 10;
+    mx::FilePath libraryPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries/stdlib");
+
+    mx::createDocument();
+    size_t startMemory = getHeapMemory();
+    std::vector<mx::DocumentPtr> documents;
+    for (size_t i = 0; i < DOCUMENT_COUNT; i++)
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, libraryPath / mx::FilePath("stdlib_defs.mtlx"));
+        mx::readFromXmlFile(doc, libraryPath / mx::FilePath("stdlib_ng.mtlx"));
+        documents.push_back(doc);
+    }
+    size_t documentMemory = (getHeapMemory() - startMemory) / DOCUMENT_COUNT;
+
+    size_t elementCount = 0;
+    size_t attributeCount = 0;
+    for (mx::ElementPtr elem : documents[0]->traverseTree())
+    {
+        attributeCount += elem->getAttributeNames().size();
+        elementCount++;
+    }
+    std::cout << "Loaded " << elementCount << " elements with " << attributeCount << " attributes per document" << std::endl;
+
+    if (!documentMemory || sizeof(void*) != 8)
+    {
+        std::cout << "Heap memory is not comparable to the baseline on this platform" << std::endl;
+        return;
+    }
+    std::cout << "Heap memory per document: " << documentMemory / 1024 << " KB" << std::endl;
+    std::cout << "Heap memory per document before interning: " << BASELINE_DOCUMENT_MEMORY / 1024 << " KB" << std::endl;
+
+    // Interned attribute names should save at least a fifth of the heap
+    // memory of the loaded documents.
+    REQUIRE(documentMemory * 5 < BASELINE_DOCUMENT_MEMORY * 4);
+}
+
+TEST_CASE("Arena load performance", "[.benchmark]")
+{
+    using Clock = std::chrono::steady_clock;
+    const int DOCUMENT_COUNT = 20;
+    mx::FilePath libraryPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries/stdlib");
+
+    // Time the load and release of documents with their current allocation.
+    std::vector<mx::DocumentPtr> documents;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < DOCUMENT_COUNT; i++)
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, libraryPath / mx::FilePath("stdlib_defs.mtlx"));
+        mx::readFromXmlFile(doc, libraryPath / mx::FilePath("stdlib_ng.mtlx"));
+        documents.push_back(doc);
+    }
+    double loadTime = std::chrono::duration<double>(Clock::now() - start).count();
+    mx::DocumentPtr source = documents[0];
+    start = Clock::now();
+    documents.clear();
+    double freeTime = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "Load of " << DOCUMENT_COUNT << " documents: " << loadTime << "s, release: " << freeTime << "s" << std::endl;
+
+    // Create and release the elements of the documents with std::make_shared,
+    // as documents do, and from an arena.
+    auto timeElements = [&](bool useArena, size_t& allocationCount)
+    {
+        std::vector<mx::ElementPtr> elements;
+        std::vector<mx::DocumentPtr> parents;
+        Clock::time_point begin = Clock::now();
+        for (int i = 0; i < DOCUMENT_COUNT; i++)
+        {
+            mx::DocumentPtr parent = mx::createDocument();
+            parents.push_back(parent);
+            std::shared_ptr<Arena> arena = std::make_shared<Arena>();
+            for (mx::ElementPtr elem : source->traverseTree())
+            {
+                if (useArena)
+                {
+                    elements.push_back(createElementLike(elem, parent, ArenaAllocator<char>(arena)));
+                }
+                else
+                {
+                    elements.push_back(createElementLike(elem, parent, CountingAllocator<char>(allocationCount)));
+                }
+            }
+            if (useArena)
+            {
+                allocationCount += arena->getBlockCount();
+            }
+        }
+        double createTime = std::chrono::duration<double>(Clock::now() - begin).count();
+        begin = Clock::now();
+        elements.clear();
+        double releaseTime = std::chrono::duration<double>(Clock::now() - begin).count();
+        return std::make_pair(createTime, releaseTime);
+    };
+
+    size_t heapAllocations = 0;
+    size_t arenaAllocations = 0;
+    std::pair<double, double> heapTimes = timeElements(false, heapAllocations);
+    std::pair<double, double> arenaTimes = timeElements(true, arenaAllocations);
+    std::cout << "Heap elements: " << heapAllocations << " allocations, creation " << heapTimes.first <<
+                 "s, release " << heapTimes.second << "s" << std::endl;
+    std::cout << "Arena elements: " << arenaAllocations << " allocations, creation " << arenaTimes.first <<
+                 "s, release " << arenaTimes.second << "s" << std::endl;
+
+    // Each heap element is one allocation of its object and control block,
+    // while the arena draws many elements from each block.
+    size_t elementCount = 0;
+    for (mx::ElementPtr elem : source->traverseTree())
+    {
+        elementCount++;
+    }
+    REQUIRE(heapAllocations == DOCUMENT_COUNT * elementCount);
+    REQUIRE(arenaAllocations < heapAllocations);
+}
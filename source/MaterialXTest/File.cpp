@@ -7,6 +7,10 @@
 
 #include <MaterialXFormat/File.h>
 
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Syntactic operations", "[file]")
@@ -66,3 +70,33 @@ TEST_CASE("File search path operations", "[file]")
         REQUIRE(mx::FileSearchPath(searchPath, mx::PATH_LIST_SEPARATOR).find(path).exists());
     }
 }
+
+TEST_CASE("Mapped file operations", "[file]")
+{
+    mx::FilePath path("libraries/stdlib/stdlib_defs.mtlx");
+    std::ifstream stream(path.asString(), std::ios::binary);
+    std::stringstream contents;
+    contents << stream.rdbuf();
+
+    // Compare mapped contents with a stream read.
+    mx::MappedFile file;
+    REQUIRE(file.open(path));
+    REQUIRE(std::string(file.getData(), file.getSize()) == contents.str());
+
+    // Modifications to the mapping do not affect the file.
+    file.getData()[0] = ' ';
+    mx::MappedFile secondFile;
+    REQUIRE(secondFile.open(path));
+    REQUIRE(secondFile.getData()[0] == contents.str()[0]);
+    file.close();
+    REQUIRE(file.getData() == nullptr);
+
+    // Map empty and missing files.
+    std::ofstream("empty_file.txt");
+    REQUIRE(file.open(mx::FilePath("empty_file.txt")));
+    REQUIRE(file.getSize() == 0);
+    file.close();
+    std::remove("empty_file.txt");
+    REQUIRE(!file.open(mx::FilePath("NonExistent.txt")));
+    REQUIRE(!file.open(mx::FilePath("libraries")));
+}
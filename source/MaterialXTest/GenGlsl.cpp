@@ -11,11 +11,26 @@
 #include <MaterialXCore/Document.h>
 
 #include <MaterialXFormat/File.h>
+#include <MaterialXFormat/XmlIo.h>
 
+#include <MaterialXGenShader/DefaultColorManagementSystem.h>
+#include <MaterialXGenShader/GenProfiler.h>
+#include <MaterialXGenShader/ShaderCache.h>
+#include <MaterialXGenShader/ShaderVariants.h>
+#include <MaterialXGenShader/SourceCache.h>
 #include <MaterialXGenShader/Util.h>
+#include <MaterialXGenShader/Nodes/SourceCodeNode.h>
 #include <MaterialXGenGlsl/GlslShaderGenerator.h>
 #include <MaterialXGenGlsl/GlslSyntax.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <thread>
+
 namespace mx = MaterialX;
 
 TEST_CASE("GenShader: GLSL Syntax Check", "[genglsl]")
@@ -120,6 +135,942 @@ TEST_CASE("GenShader: Bind Light Shaders", "[genglsl]")
     REQUIRE_NOTHROW(mx::HwShaderGenerator::bindLightShader(*spotLightShader, 66, context));
 }
 
+TEST_CASE("GenShader: GLSL Shader Cache", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    loadLibraries({ "stdlib" }, searchPath, doc);
+
+    mx::NodeGraphPtr graph = doc->addNodeGraph("cache_graph");
+    mx::NodePtr constant = graph->addNode("constant", "constant1", "color3");
+    constant->setParameterValue("value", mx::Color3(0.5f));
+    mx::NodePtr multiply = graph->addNode("multiply", "multiply1", "color3");
+    multiply->setConnectedNode("in1", constant);
+    multiply->setInputValue("in2", mx::Color3(2.0f));
+    mx::OutputPtr output = graph->addOutput("out", "color3");
+    output->setConnectedNode(multiply);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+
+    // Repeated requests return the cached shader.
+    mx::ShaderCache cache;
+    mx::ShaderPtr shader = cache.generate("cache_shader", output, context);
+    REQUIRE(cache.generate("cache_shader", output, context) == shader);
+    REQUIRE(cache.getGeneratedCount() == 1);
+
+    // The hash reflects the shader name, upstream values and options, and
+    // is unaffected by elements outside of the upstream graph.
+    std::string hash = cache.computeHash("cache_shader", output, context);
+    REQUIRE(cache.computeHash("other_shader", output, context) != hash);
+    multiply->setInputValue("in2", mx::Color3(3.0f));
+    REQUIRE(cache.computeHash("cache_shader", output, context) != hash);
+    multiply->setInputValue("in2", mx::Color3(2.0f));
+    REQUIRE(cache.computeHash("cache_shader", output, context) == hash);
+    context.getOptions().fileTextureVerticalFlip = true;
+    REQUIRE(cache.computeHash("cache_shader", output, context) != hash);
+    context.getOptions().fileTextureVerticalFlip = false;
+    context.getOptions().optimizeGraphExpressions = !context.getOptions().optimizeGraphExpressions;
+    REQUIRE(cache.computeHash("cache_shader", output, context) != hash);
+    context.getOptions().optimizeGraphExpressions = !context.getOptions().optimizeGraphExpressions;
+    mx::GenContext uniformBufferContext = context.fork();
+    uniformBufferContext.getOptions().hwUniformBuffers = !context.getOptions().hwUniformBuffers;
+    REQUIRE(cache.computeHash("cache_shader", output, uniformBufferContext) != hash);
+    graph->addNode("constant", "unused", "float");
+    REQUIRE(cache.computeHash("cache_shader", output, context) == hash);
+
+    // Source code stored in the cache directory is shared between caches.
+    mx::FilePath cacheDirectory = mx::FilePath::getCurrentPath() / mx::FilePath("shader_cache");
+    cacheDirectory.createDirectory();
+    cache.setCacheDirectory(cacheDirectory);
+    cache.clear();
+    shader = cache.generate("cache_shader", output, context);
+    REQUIRE(cache.getGeneratedCount() == 2);
+    mx::ShaderCache diskCache;
+    diskCache.setCacheDirectory(cacheDirectory);
+    mx::StringMap sourceCode = diskCache.getSourceCode("cache_shader", output, context);
+    REQUIRE(diskCache.getGeneratedCount() == 0);
+    REQUIRE(sourceCode.size() == shader->numStages());
+    REQUIRE(sourceCode[mx::Stage::VERTEX] == shader->getSourceCode(mx::Stage::VERTEX));
+    REQUIRE(sourceCode[mx::Stage::PIXEL] == shader->getSourceCode(mx::Stage::PIXEL));
+
+    // Stored files whose full hash does not match, or whose contents are
+    // corrupt, are treated as cache misses.
+    REQUIRE(hash.size() == 32);
+    mx::FilePath storedPath = cacheDirectory / mx::FilePath(hash.substr(0, 16) + ".mtlxshader");
+    std::string stored;
+    REQUIRE(mx::readFile(storedPath.asString(), stored));
+    std::string otherHash = hash.substr(0, 16) + std::string(16, hash[16] == '0' ? '1' : '0');
+    const mx::StringVec corruptEntries =
+    {
+        otherHash + stored.substr(stored.find('\n')),
+        hash + "\n0\npixel\n18446744073709551615\n",
+        hash + "\n99999999999999999999\n",
+        hash + "\n0\npixel\n100\nvoid main() {}",
+        hash + "\n0\npixel\n-1\n",
+        std::string()
+    };
+    size_t generatedCount = diskCache.getGeneratedCount();
+    for (const std::string& entry : corruptEntries)
+    {
+        {
+            std::ofstream file(storedPath.asString(), std::ios::binary);
+            file << entry;
+        }
+        diskCache.clear();
+        sourceCode = diskCache.getSourceCode("cache_shader", output, context);
+        REQUIRE(diskCache.getGeneratedCount() == ++generatedCount);
+        REQUIRE(sourceCode[mx::Stage::PIXEL] == shader->getSourceCode(mx::Stage::PIXEL));
+    }
+    std::string rewritten;
+    REQUIRE(mx::readFile(storedPath.asString(), rewritten));
+    REQUIRE(rewritten == stored);
+
+    for (const mx::FilePath& cacheFile : cacheDirectory.getFilesInDirectory("mtlxshader"))
+    {
+        std::remove((cacheDirectory / cacheFile).asString().c_str());
+    }
+    std::remove(cacheDirectory.asString().c_str());
+}
+
+TEST_CASE("GenShader: GLSL Referenced Libraries", "[genglsl]")
+{
+    mx::DocumentPtr stdlib = mx::createDocument();
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    loadLibraries({ "stdlib" }, searchPath, stdlib);
+
+    // A custom library, defining a node through a graph of standard nodes.
+    mx::DocumentPtr library = mx::createDocument();
+    library->referenceLibrary(stdlib);
+    mx::NodeDefPtr nodeDef = library->addNodeDef("ND_brighten_color3", "color3", "brighten");
+    nodeDef->addInput("in", "color3")->setValue(mx::Color3(0.5f));
+    nodeDef->addInput("amount", "color3")->setValue(mx::Color3(2.0f));
+    mx::NodeGraphPtr implGraph = library->addNodeGraph("NG_brighten_color3");
+    implGraph->setNodeDef(nodeDef);
+    mx::NodePtr implMultiply = implGraph->addNode("multiply", "multiply1", "color3");
+    implMultiply->addInput("in1", "color3")->setInterfaceName("in");
+    implMultiply->addInput("in2", "color3")->setInterfaceName("amount");
+    implGraph->addOutput("out", "color3")->setConnectedNode(implMultiply);
+
+    // A document whose definitions are all resolved through the library.
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->referenceLibrary(library);
+    mx::NodeGraphPtr graph = doc->addNodeGraph("graph");
+    mx::NodePtr constant = graph->addNode("constant", "constant1", "color3");
+    constant->setParameterValue("value", mx::Color3(0.25f));
+    mx::NodePtr brighten = graph->addNode("brighten", "brighten1", "color3");
+    brighten->setConnectedNode("in", constant);
+    mx::OutputPtr output = graph->addOutput("out", "color3");
+    output->setConnectedNode(brighten);
+    REQUIRE(doc->getNodeDefs().empty());
+    REQUIRE(brighten->getNodeDef() == nodeDef);
+
+    // Generation matches that of a document with imported libraries.
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("referenced_shader", output, context);
+    REQUIRE(shader);
+    mx::DocumentPtr importedDoc = doc->copy();
+    importedDoc->clearReferencedLibraries();
+    importedDoc->importLibrary(stdlib);
+    importedDoc->importLibrary(library);
+    mx::OutputPtr importedOutput = importedDoc->getNodeGraph("graph")->getOutput("out");
+    mx::GenContext importedContext(mx::GlslShaderGenerator::create());
+    importedContext.registerSourceCodeSearchPath(searchPath);
+    mx::ShaderPtr importedShader = importedContext.getShaderGenerator().generate("referenced_shader", importedOutput, importedContext);
+    REQUIRE(shader->getSourceCode(mx::Stage::PIXEL) == importedShader->getSourceCode(mx::Stage::PIXEL));
+
+    // Cache keys reflect edits to the definitions, implementations and
+    // document-level definitions of referenced libraries.
+    mx::ShaderCache cache;
+    std::string hash = cache.computeHash("referenced_shader", output, context);
+    nodeDef->getInput("amount")->setValue(mx::Color3(3.0f));
+    REQUIRE(cache.computeHash("referenced_shader", output, context) != hash);
+    nodeDef->getInput("amount")->setValue(mx::Color3(2.0f));
+    REQUIRE(cache.computeHash("referenced_shader", output, context) == hash);
+    implMultiply->getInput("in2")->setInterfaceName("in");
+    REQUIRE(cache.computeHash("referenced_shader", output, context) != hash);
+    implMultiply->getInput("in2")->setInterfaceName("amount");
+    REQUIRE(cache.computeHash("referenced_shader", output, context) == hash);
+    mx::NodeDefPtr multiplyNodeDef = stdlib->getNodeDef("ND_multiply_color3");
+    multiplyNodeDef->setAttribute("doc", "Edited");
+    REQUIRE(cache.computeHash("referenced_shader", output, context) != hash);
+    multiplyNodeDef->removeAttribute("doc");
+    REQUIRE(cache.computeHash("referenced_shader", output, context) == hash);
+    library->addGeomPropDef("geomprop1", "position");
+    REQUIRE(cache.computeHash("referenced_shader", output, context) != hash);
+    library->removeGeomPropDef("geomprop1");
+    REQUIRE(cache.computeHash("referenced_shader", output, context) == hash);
+}
+
+// The libraries, shader generator and source code search path used by the
+// GLSL generation tests.  The generator uses the default color management
+// system, with its definitions loaded from the libraries.
+struct GlslTestSetup
+{
+    GlslTestSetup(const mx::StringVec& libraryNames) :
+        searchPath(mx::FilePath::getCurrentPath() / mx::FilePath("libraries")),
+        libraries(mx::createDocument()),
+        generator(mx::GlslShaderGenerator::create())
+    {
+        loadLibraries(libraryNames, searchPath, libraries);
+        mx::ColorManagementSystemPtr cms = mx::DefaultColorManagementSystem::create(generator->getLanguage());
+        cms->loadLibrary(libraries);
+        generator->setColorManagementSystem(cms);
+    }
+
+    // Return a new context for the generator, with no cached implementations.
+    mx::GenContext createContext() const
+    {
+        mx::GenContext context(generator);
+        context.registerSourceCodeSearchPath(searchPath);
+        return context;
+    }
+
+    mx::FilePath searchPath;
+    mx::DocumentPtr libraries;
+    mx::ShaderGeneratorPtr generator;
+};
+
+static std::vector<mx::TypedElementPtr> loadRenderableExamples(mx::DocumentPtr libraries, std::vector<mx::DocumentPtr>& documents)
+{
+    mx::FilePath examplesPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/Examples/StandardSurface");
+    std::vector<mx::TypedElementPtr> elements;
+    for (const mx::FilePath& filename : examplesPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, examplesPath / filename);
+        doc->importLibrary(libraries);
+        mx::findRenderableElements(doc, elements);
+        documents.push_back(doc);
+    }
+    return elements;
+}
+
+TEST_CASE("GenShader: GLSL Parallel Generation", "[genglsl]")
+{
+    GlslTestSetup setup({ "stdlib", "pbrlib", "bxdf", "lights" });
+    std::vector<mx::DocumentPtr> documents;
+    std::vector<mx::TypedElementPtr> elements = loadRenderableExamples(setup.libraries, documents);
+    REQUIRE(!elements.empty());
+
+    mx::GenContext context = setup.createContext();
+    mx::HwShaderGenerator::bindLightShader(*setup.libraries->getNodeDef("ND_point_light"), 1, context);
+
+    // Optimized graphs order their nodes by name rather than address, so
+    // that shaders generated on different threads can be compared.
+    context.getOptions().optimizeGraphExpressions = true;
+
+    // Generate shaders sequentially for reference.
+    std::vector<mx::ShaderPtr> shaders;
+    for (mx::TypedElementPtr elem : elements)
+    {
+        shaders.push_back(setup.generator->generate(mx::createValidName(elem->getNamePath()), elem, context));
+    }
+
+    // Forked contexts share the cached implementations and bound light
+    // shaders, so parallel generation reproduces the same source code.
+    std::vector<mx::ShaderPtr> parallelShaders = setup.generator->generateAll(elements, context, 4);
+    REQUIRE(parallelShaders.size() == shaders.size());
+    for (size_t i = 0; i < shaders.size(); i++)
+    {
+        REQUIRE(parallelShaders[i]->getName() == shaders[i]->getName());
+        REQUIRE(parallelShaders[i]->getSourceCode(mx::Stage::VERTEX) == shaders[i]->getSourceCode(mx::Stage::VERTEX));
+        REQUIRE(parallelShaders[i]->getSourceCode(mx::Stage::PIXEL) == shaders[i]->getSourceCode(mx::Stage::PIXEL));
+    }
+
+    // Implementations created by forked contexts are shared with the base context.
+    mx::GenContext coldContext = setup.createContext();
+    parallelShaders = setup.generator->generateAll(elements, coldContext, 4);
+    for (mx::ShaderPtr shader : parallelShaders)
+    {
+        REQUIRE(shader != nullptr);
+    }
+    REQUIRE(coldContext.findNodeImplementation("IMPL_standard_surface_surfaceshader") != nullptr);
+
+    // Errors on any thread are reported to the caller, which receives the
+    // error of the failing element with the lowest index.
+    elements.insert(elements.begin() + elements.size() / 2, setup.libraries->getNodeDef("ND_spot_light"));
+    elements.push_back(setup.libraries->getNodeDef("ND_point_light"));
+    std::string message;
+    try
+    {
+        setup.generator->generateAll(elements, context, 4);
+    }
+    catch (mx::ExceptionShaderGenError& e)
+    {
+        message = e.what();
+    }
+    REQUIRE(message.find("ND_spot_light") != std::string::npos);
+    mx::GenContext otherContext(mx::GlslShaderGenerator::create());
+    REQUIRE_THROWS_AS(setup.generator->generateAll(elements, otherContext), mx::ExceptionShaderGenError&);
+}
+
+TEST_CASE("GenShader: GLSL Parallel Generation Performance", "[.benchmark]")
+{
+    GlslTestSetup setup({ "stdlib", "pbrlib", "bxdf" });
+    std::vector<mx::DocumentPtr> documents;
+    std::vector<mx::TypedElementPtr> elements = loadRenderableExamples(setup.libraries, documents);
+
+    for (unsigned int threadCount : { 1u, 2u, 4u, 0u })
+    {
+        mx::GenContext context = setup.createContext();
+        auto start = std::chrono::steady_clock::now();
+        setup.generator->generateAll(elements, context, threadCount);
+        std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        std::cout << "Generated " << elements.size() << " GLSL shaders with " <<
+            (threadCount ? std::to_string(threadCount) : "all") << " threads: " << time.count() << "s" << std::endl;
+    }
+}
+
+TEST_CASE("GenShader: GLSL Source Cache", "[genglsl]")
+{
+    GlslTestSetup setup({ "stdlib", "pbrlib", "bxdf" });
+
+    // Lines are split on newlines, include statements are parsed, and
+    // include statements without a filename are skipped.
+    mx::SourceFile file(mx::FilePath("source.glsl"), "int a;\n#include \"lib/b.glsl\"\n#include\n\nint c;\n", setup.generator->getSyntax());
+    const std::vector<mx::SourceFile::Line>& lines = file.getLines();
+    REQUIRE(lines.size() == 4);
+    REQUIRE((lines[0].code == "int a;" && lines[0].include.empty()));
+    REQUIRE((lines[1].code.empty() && lines[1].include == "lib/b.glsl"));
+    REQUIRE((lines[2].code.empty() && lines[2].include.empty()));
+    REQUIRE((lines[3].code == "int c;" && lines[3].include.empty()));
+
+    std::vector<mx::DocumentPtr> documents;
+    std::vector<mx::TypedElementPtr> elements = loadRenderableExamples(setup.libraries, documents);
+
+    // Generate each shader with a new context, so that implementations are
+    // created again for every shader.
+    mx::SourceCachePtr sourceCache = mx::SourceCache::create();
+    auto generateShaders = [&]()
+    {
+        for (mx::TypedElementPtr elem : elements)
+        {
+            mx::GenContext context = setup.createContext();
+            context.setSourceCache(sourceCache);
+            REQUIRE(setup.generator->generate(elem->getName(), elem, context) != nullptr);
+        }
+    };
+
+    // Source files are only read when first used.
+    generateShaders();
+    size_t readCount = sourceCache->getReadCount();
+    REQUIRE(readCount > 0);
+    generateShaders();
+    REQUIRE(sourceCache->getReadCount() == readCount);
+
+    sourceCache->clear();
+    generateShaders();
+    REQUIRE(sourceCache->getReadCount() == readCount * 2);
+
+    // Independent contexts each read the files through their own cache,
+    // while contexts assigned a common cache read each file once.
+    const size_t CONTEXT_COUNT = 3;
+    mx::TypedElementPtr elem = elements[0];
+    size_t independentReadCount = 0;
+    mx::SourceCachePtr commonCache = mx::SourceCache::create();
+    for (size_t i = 0; i < CONTEXT_COUNT; i++)
+    {
+        mx::GenContext independentContext = setup.createContext();
+        REQUIRE(setup.generator->generate(elem->getName(), elem, independentContext) != nullptr);
+        independentReadCount += independentContext.getSourceCache()->getReadCount();
+
+        mx::GenContext commonContext = setup.createContext();
+        commonContext.setSourceCache(commonCache);
+        REQUIRE(setup.generator->generate(elem->getName(), elem, commonContext) != nullptr);
+    }
+    REQUIRE(commonCache->getReadCount() > 0);
+    REQUIRE(independentReadCount == commonCache->getReadCount() * CONTEXT_COUNT);
+}
+
+TEST_CASE("GenShader: GLSL Source File Edits", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    loadLibraries({ "stdlib" }, searchPath, doc);
+
+    mx::FilePath sourcePath = mx::FilePath::getCurrentPath() / mx::FilePath("source_edit_test.glsl");
+    auto writeSource = [&](const std::string& value)
+    {
+        std::ofstream stream(sourcePath.asString());
+        stream << "void mx_source_edit_test(out float result)\n{\n    result = " << value << ";\n}\n";
+    };
+    writeSource("0.25");
+
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_source_edit_test", "float", "source_edit_test");
+    mx::ImplementationPtr impl = doc->addImplementation("IM_source_edit_test_genglsl");
+    impl->setNodeDef(nodeDef);
+    impl->setLanguage(mx::GlslShaderGenerator::LANGUAGE);
+    impl->setFile(sourcePath.asString());
+    impl->setFunction("mx_source_edit_test");
+    mx::NodeGraphPtr graph = doc->addNodeGraph("source_edit_graph");
+    mx::NodePtr node = graph->addNode("source_edit_test", "node1", "float");
+    mx::OutputPtr output = graph->addOutput("out", "float");
+    output->setConnectedNode(node);
+
+    mx::ShaderGeneratorPtr generator = mx::GlslShaderGenerator::create();
+    auto generatePixelStage = [&](mx::GenContext& context)
+    {
+        mx::ShaderPtr shader = generator->generate("source_edit_shader", output, context);
+        REQUIRE(shader);
+        return shader->getSourceCode(mx::Stage::PIXEL);
+    };
+    mx::GenContext context(generator);
+    context.registerSourceCodeSearchPath(searchPath);
+    REQUIRE(generatePixelStage(context).find("result = 0.25;") != std::string::npos);
+
+    // Edits are picked up by new contexts, which have their own source
+    // cache, and by existing contexts once their implementations are cleared.
+    writeSource("0.75");
+    mx::GenContext newContext(generator);
+    newContext.registerSourceCodeSearchPath(searchPath);
+    REQUIRE(generatePixelStage(newContext).find("result = 0.75;") != std::string::npos);
+    REQUIRE(generatePixelStage(context).find("result = 0.25;") != std::string::npos);
+    context.clearNodeImplementations();
+    REQUIRE(generatePixelStage(context).find("result = 0.75;") != std::string::npos);
+
+    // Shader cache keys reflect edits to the files included by source files.
+    mx::FilePath includePath = mx::FilePath::getCurrentPath() / mx::FilePath("source_edit_include.glsl");
+    auto writeInclude = [&](const std::string& value)
+    {
+        std::ofstream stream(includePath.asString());
+        stream << "float mx_source_edit_value()\n{\n    return " << value << ";\n}\n";
+    };
+    writeInclude("0.5");
+    {
+        std::ofstream stream(sourcePath.asString());
+        stream << "#include \"" << includePath.asString() << "\"\n\n";
+        stream << "void mx_source_edit_test(out float result)\n{\n    result = mx_source_edit_value();\n}\n";
+    }
+    mx::ShaderCache cache;
+    mx::GenContext cacheContext(generator);
+    cacheContext.registerSourceCodeSearchPath(searchPath);
+    std::string hash = cache.computeHash("source_edit_shader", output, cacheContext);
+    REQUIRE(cache.computeHash("source_edit_shader", output, cacheContext) == hash);
+
+    // Allow for the resolution of file modification times.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    writeInclude("1.5");
+    REQUIRE(cache.computeHash("source_edit_shader", output, cacheContext) != hash);
+
+    std::remove(includePath.asString().c_str());
+    std::remove(sourcePath.asString().c_str());
+}
+
+TEST_CASE("GenShader: GLSL Profiling", "[genglsl]")
+{
+    // Scopes are nested per thread and combined by path in JSON exports.
+    mx::GenProfilerPtr profiler = mx::GenProfiler::create();
+    size_t outer = profiler->beginScope("outer");
+    for (int i = 0; i < 2; i++)
+    {
+        profiler->endScope(profiler->beginScope("inner"));
+    }
+    profiler->endScope(outer);
+    profiler->addCount("count", 2);
+    profiler->addCount("count");
+    std::vector<mx::GenProfiler::Scope> scopes = profiler->getScopes();
+    REQUIRE(scopes.size() == 3);
+    REQUIRE(scopes[0].parent == mx::GenProfiler::npos);
+    REQUIRE((scopes[1].parent == 0 && scopes[2].parent == 0));
+    REQUIRE(scopes[0].duration >= scopes[1].duration + scopes[2].duration);
+    REQUIRE(profiler->getCounters().at("count") == 3);
+    std::string json = profiler->exportJson();
+    REQUIRE(json.find("\"name\": \"inner\", \"calls\": 2") != std::string::npos);
+    REQUIRE(json.find("\"count\": 3") != std::string::npos);
+    std::string trace = profiler->exportChromeTrace();
+    REQUIRE(trace.find("\"name\": \"inner\", \"ph\": \"X\"") != std::string::npos);
+    REQUIRE(trace.find("\"ph\": \"C\"") != std::string::npos);
+    profiler->clear();
+    REQUIRE(profiler->getScopes().empty());
+
+    GlslTestSetup setup({ "stdlib", "pbrlib", "bxdf" });
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/Examples/StandardSurface/standard_surface_brass_tiled.mtlx"));
+    doc->importLibrary(setup.libraries);
+    std::vector<mx::TypedElementPtr> elements;
+    mx::findRenderableElements(doc, elements);
+    REQUIRE(!elements.empty());
+
+    mx::GenContext context = setup.createContext();
+    context.setProfiler(profiler);
+    mx::ShaderPtr shader = setup.generator->generate(elements[0]->getName(), elements[0], context);
+    REQUIRE(shader);
+
+#ifdef MATERIALX_GEN_PROFILING
+    // Generation phases are recorded within the generate scope.
+    scopes = profiler->getScopes();
+    REQUIRE(!scopes.empty());
+    REQUIRE(scopes[0].name == "generate");
+    std::set<std::string> names;
+    for (const mx::GenProfiler::Scope& scope : scopes)
+    {
+        REQUIRE(scope.duration >= 0.0);
+        names.insert(scope.name);
+    }
+    for (const std::string& name : { "createShader", "ShaderGraph::create", "addUpstreamDependencies", "optimize",
+                                     "topologicalSort", "calculateScopes", "setVariableNames", "NodeDef::getImplementation",
+                                     "emitVertexStage", "emitPixelStage", "emitFunctionDefinitions", "emitFunctionCalls" })
+    {
+        REQUIRE(names.count(name));
+    }
+
+    mx::GenProfiler::CounterMap counters = profiler->getCounters();
+    REQUIRE(counters["nodesCreated"] > 0);
+    REQUIRE(counters["nodesCreated/image"] > 0);
+    REQUIRE(counters["implementationsResolved"] >= counters["nodesCreated"]);
+    REQUIRE(counters["filesRead"] > 0);
+    REQUIRE(counters["bytesEmitted"] == shader->getSourceCode(mx::Stage::VERTEX).size() +
+                                        shader->getSourceCode(mx::Stage::PIXEL).size());
+#else
+    // Instrumentation is compiled out.
+    REQUIRE(profiler->getScopes().empty());
+    REQUIRE(profiler->getCounters().empty());
+#endif
+}
+
+namespace {
+
+// A source code implementation of a custom class.
+class CustomSourceCodeNode : public mx::SourceCodeNode
+{
+};
+
+// A GLSL generator creating source code implementations of a custom class.
+class CustomGlslShaderGenerator : public mx::GlslShaderGenerator
+{
+  protected:
+    mx::ShaderNodeImplPtr createSourceCodeImplementation(const mx::Implementation&) const override
+    {
+        return std::make_shared<CustomSourceCodeNode>();
+    }
+};
+
+} // anonymous namespace
+
+TEST_CASE("GenShader: GLSL Implementation Sharing", "[genglsl]")
+{
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    loadLibraries({ "stdlib" }, searchPath, libraries);
+
+    // Source code implementations are shared by contexts and generators
+    // using the same source cache.
+    mx::SourceCachePtr sourceCache = mx::SourceCache::create();
+    std::vector<mx::GenContext> contexts;
+    for (int i = 0; i < 3; i++)
+    {
+        mx::GenContext context(mx::GlslShaderGenerator::create());
+        context.setSourceCache(sourceCache);
+        context.registerSourceCodeSearchPath(searchPath);
+        contexts.push_back(context);
+    }
+    auto getImplementation = [&](const std::string& name, mx::GenContext& context)
+    {
+        mx::InterfaceElementPtr element = libraries->getChildOfType<mx::InterfaceElement>(name);
+        REQUIRE(element);
+        return context.getShaderGenerator().getImplementation(*element, context);
+    };
+    mx::ShaderNodeImplPtr noise = getImplementation("IM_noise2d_float_genglsl", contexts[0]);
+    REQUIRE(getImplementation("IM_noise2d_float_genglsl", contexts[1]) == noise);
+    sourceCache->clear();
+    REQUIRE(getImplementation("IM_noise2d_float_genglsl", contexts[2]) != noise);
+
+    // Generators creating implementations of another class do not share them.
+    mx::GenContext customContext(std::make_shared<CustomGlslShaderGenerator>());
+    customContext.setSourceCache(sourceCache);
+    customContext.registerSourceCodeSearchPath(searchPath);
+    mx::ShaderNodeImplPtr customNoise = getImplementation("IM_noise2d_float_genglsl", customContext);
+    REQUIRE(std::dynamic_pointer_cast<CustomSourceCodeNode>(customNoise));
+    REQUIRE(customNoise != getImplementation("IM_noise2d_float_genglsl", contexts[2]));
+
+    // Implementations emitting the same function share a hash, while
+    // functions of the same name defined by different files do not.
+    mx::ShaderNodeImplPtr color4 = getImplementation("IM_splittb_color4_genglsl", contexts[0]);
+    mx::ShaderNodeImplPtr vector4 = getImplementation("IM_splittb_vector4_genglsl", contexts[0]);
+    REQUIRE(color4 != vector4);
+    REQUIRE(color4->getHash() == vector4->getHash());
+    REQUIRE(color4->getHash() != noise->getHash());
+    for (std::string file : { "mx_noise2d_float.glsl", "mx_noise2d_vector2.glsl" })
+    {
+        mx::ImplementationPtr impl = libraries->addImplementation("IM_test_" + mx::removeExtension(file));
+        impl->setFile("stdlib/genglsl/" + file);
+        impl->setFunction("mx_test");
+    }
+    REQUIRE(getImplementation("IM_test_mx_noise2d_float", contexts[0])->getHash() !=
+            getImplementation("IM_test_mx_noise2d_vector2", contexts[0])->getHash());
+}
+
+TEST_CASE("GenShader: GLSL Graph Optimization", "[genglsl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    loadLibraries({ "stdlib" }, searchPath, doc);
+
+    // Build a graph with a duplicated texcoord chain and a constant expression.
+    mx::NodeGraphPtr graph = doc->addNodeGraph("graph");
+    mx::NodePtr sum = graph->addNode("add", "sum", "vector2");
+    for (std::string index : { "1", "2" })
+    {
+        mx::NodePtr texcoord = graph->addNode("texcoord", "texcoord" + index, "vector2");
+        mx::NodePtr scale = graph->addNode("multiply", "scale" + index, "vector2");
+        scale->setConnectedNode("in1", texcoord);
+        scale->setInputValue("in2", mx::Vector2(2.0f, 2.0f));
+        sum->setConnectedNode("in" + index, scale);
+    }
+    mx::NodePtr offset = graph->addNode("add", "offset", "float");
+    offset->setInputValue("in1", 0.25f);
+    offset->setInputValue("in2", 0.5f);
+    mx::NodePtr gain = graph->addNode("multiply", "gain", "float");
+    gain->setConnectedNode("in1", offset);
+    gain->setInputValue("in2", 2.0f);
+    mx::NodePtr combine = graph->addNode("multiply", "combine", "vector2");
+    combine->setConnectedNode("in1", sum);
+    combine->setConnectedNode("in2", gain);
+    mx::OutputPtr output = graph->addOutput("out", "vector2");
+    output->setConnectedNode(combine);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+    mx::ShaderGraphPtr shaderGraph = mx::ShaderGraph::create(nullptr, "graph", output, context);
+    REQUIRE(shaderGraph->getNodes().size() == 8);
+
+    // The chains are merged and the constant expression is folded into
+    // the value of the downstream input.
+    context.getOptions().optimizeGraphExpressions = true;
+    shaderGraph = mx::ShaderGraph::create(nullptr, "graph", output, context);
+    REQUIRE(shaderGraph->getNodes().size() == 4);
+    REQUIRE(((shaderGraph->getNode("texcoord1") == nullptr) != (shaderGraph->getNode("texcoord2") == nullptr)));
+    REQUIRE(shaderGraph->getNode("offset") == nullptr);
+    REQUIRE(shaderGraph->getNode("gain") == nullptr);
+    mx::ShaderNode* combineNode = shaderGraph->getNode("combine");
+    REQUIRE(combineNode);
+    mx::ShaderInput* gainInput = combineNode->getInput("in2");
+    REQUIRE((gainInput && !gainInput->getConnection() && gainInput->getValue()));
+    REQUIRE(gainInput->getValue()->asA<float>() == 1.5f);
+
+    // Inputs published by the complete interface are left editable.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+    shaderGraph = mx::ShaderGraph::create(nullptr, "graph", output, context);
+    REQUIRE(shaderGraph->getNode("scale1") != nullptr);
+    REQUIRE(shaderGraph->getNode("scale2") != nullptr);
+    REQUIRE(shaderGraph->getNode("offset") != nullptr);
+    REQUIRE(shaderGraph->getNode("gain") != nullptr);
+
+    // In optimized graphs, nodes downstream of the same output are ordered
+    // by name rather than by address.
+    mx::NodeGraphPtr fanout = doc->addNodeGraph("fanout");
+    mx::NodePtr texcoord = fanout->addNode("texcoord", "texcoord", "vector2");
+    mx::NodePtr blend = fanout->addNode("add", "blend", "vector2");
+    for (std::string name : { "zeta", "alpha" })
+    {
+        mx::NodePtr scale = fanout->addNode("multiply", name, "vector2");
+        scale->setConnectedNode("in1", texcoord);
+        scale->setInputValue("in2", mx::Vector2(name == "zeta" ? 2.0f : 3.0f));
+        blend->setConnectedNode(name == "zeta" ? "in1" : "in2", scale);
+    }
+    mx::OutputPtr fanoutOutput = fanout->addOutput("out", "vector2");
+    fanoutOutput->setConnectedNode(blend);
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+    context.getOptions().optimizeGraphExpressions = true;
+    shaderGraph = mx::ShaderGraph::create(nullptr, "fanout", fanoutOutput, context);
+    std::vector<std::string> nodeNames;
+    for (const mx::ShaderNode* node : shaderGraph->getNodes())
+    {
+        nodeNames.push_back(node->getName());
+    }
+    REQUIRE(nodeNames == (std::vector<std::string>{ "texcoord", "alpha", "zeta", "blend" }));
+
+    // Nodes are only merged when their constant inputs are exactly equal,
+    // including values that are equal at the default float precision.
+    mx::NodeGraphPtr precise = doc->addNodeGraph("precise");
+    mx::NodePtr preciseCoord = precise->addNode("texcoord", "texcoord", "vector2");
+    mx::NodePtr preciseSum = precise->addNode("add", "sum", "vector2");
+    const std::string scales[] = { "1000000.4, 1000000.4", "1000000.1, 1000000.1" };
+    for (size_t i = 0; i < 2; i++)
+    {
+        mx::NodePtr scale = precise->addNode("multiply", "scale" + std::to_string(i + 1), "vector2");
+        scale->setConnectedNode("in1", preciseCoord);
+        scale->setInputValue("in2", mx::Vector2())->setValueString(scales[i]);
+        preciseSum->setConnectedNode("in" + std::to_string(i + 1), scale);
+    }
+    mx::OutputPtr preciseOutput = precise->addOutput("out", "vector2");
+    preciseOutput->setConnectedNode(preciseSum);
+    shaderGraph = mx::ShaderGraph::create(nullptr, "precise", preciseOutput, context);
+    REQUIRE(shaderGraph->getNodes().size() == 4);
+    REQUIRE(shaderGraph->getNode("scale1") != nullptr);
+    REQUIRE(shaderGraph->getNode("scale2") != nullptr);
+}
+
+TEST_CASE("GenShader: GLSL Graph Optimization Report", "[.benchmark]")
+{
+    GlslTestSetup setup({ "stdlib", "pbrlib", "bxdf" });
+
+    // Report the savings over the standard library test suite.  Compound
+    // implementations are optimized when created, so each pass uses a new context.
+    std::vector<mx::DocumentPtr> documents;
+    std::vector<mx::TypedElementPtr> elements;
+    mx::FilePath testSuitePath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite/stdlib");
+    for (const mx::FilePath& dir : testSuitePath.getSubDirectories())
+    {
+        for (const mx::FilePath& filename : dir.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            mx::DocumentPtr testDoc = mx::createDocument();
+            mx::readFromXmlFile(testDoc, dir / filename);
+            testDoc->importLibrary(setup.libraries);
+            mx::findRenderableElements(testDoc, elements);
+            documents.push_back(testDoc);
+        }
+    }
+    size_t nodeCount[2] = { 0, 0 };
+    size_t lineCount[2] = { 0, 0 };
+    size_t shaderCount = 0;
+    for (mx::TypedElementPtr elem : elements)
+    {
+        mx::ShaderPtr shaders[2];
+        for (int optimize = 0; optimize < 2; optimize++)
+        {
+            mx::GenContext testContext = setup.createContext();
+            testContext.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+            testContext.getOptions().optimizeGraphExpressions = (optimize != 0);
+            try
+            {
+                shaders[optimize] = setup.generator->generate(elem->getName(), elem, testContext);
+            }
+            catch (mx::Exception&)
+            {
+            }
+        }
+
+        // Skip elements that the generator does not support.
+        if (!shaders[0])
+        {
+            continue;
+        }
+        REQUIRE(shaders[1]);
+        for (int optimize = 0; optimize < 2; optimize++)
+        {
+            const std::string& code = shaders[optimize]->getSourceCode(mx::Stage::PIXEL);
+            nodeCount[optimize] += shaders[optimize]->getGraph().getNodes().size();
+            lineCount[optimize] += std::count(code.begin(), code.end(), '\n');
+        }
+        shaderCount++;
+    }
+    std::cout << "Graph optimization of " << shaderCount << " shaders: " <<
+        nodeCount[0] << " -> " << nodeCount[1] << " nodes, " <<
+        lineCount[0] << " -> " << lineCount[1] << " lines of pixel code" << std::endl;
+    REQUIRE(nodeCount[1] <= nodeCount[0]);
+    REQUIRE(lineCount[1] <= lineCount[0]);
+}
+
+TEST_CASE("GenShader: GLSL Uniform Buffers", "[genglsl]")
+{
+    // Check the std140 layout of a block with each kind of member.
+    mx::VariableBlock block("Block", "u_block");
+    block.add(mx::Type::FLOAT, "a");
+    block.add(mx::Type::VECTOR3, "b");
+    block.add(mx::Type::MATRIX33, "c");
+    block.add(mx::Type::VECTOR2, "d");
+    block.add(mx::Type::FLOATARRAY, "e", mx::Value::createValue(std::vector<float>{ 1.0f, 2.0f, 3.0f }));
+    block.add(mx::Type::FILENAME, "f");
+    mx::GlslShaderGenerator::computeUniformBufferLayout(block);
+    const std::vector<mx::VariableBlock::BufferEntry>& layout = block.getBufferLayout();
+    REQUIRE(layout.size() == 5);
+    REQUIRE((layout[0].variable->getName() == "b" && layout[0].offset == 0 && layout[0].stride == 0));
+    REQUIRE((layout[1].variable->getName() == "c" && layout[1].offset == 16 && layout[1].stride == 16));
+    REQUIRE((layout[2].variable->getName() == "e" && layout[2].offset == 64 && layout[2].stride == 16));
+    REQUIRE((layout[3].variable->getName() == "d" && layout[3].offset == 112));
+    REQUIRE((layout[4].variable->getName() == "a" && layout[4].offset == 120));
+    REQUIRE(block.getBufferSize() == 128);
+    REQUIRE(block.findBufferEntry("f") == nullptr);
+
+    GlslTestSetup setup({ "stdlib", "pbrlib", "bxdf" });
+
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->importLibrary(setup.libraries);
+    mx::NodeGraphPtr graph = doc->addNodeGraph("graph");
+    mx::NodePtr image = graph->addNode("image", "image1", "color3");
+    image->setParameterValue("file", std::string("resources/Images/grid.png"), mx::FILENAME_TYPE_STRING);
+    mx::NodePtr scale = graph->addNode("multiply", "scale", "color3");
+    scale->setConnectedNode("in1", image);
+    scale->setInputValue("in2", 0.5f);
+    mx::OutputPtr output = graph->addOutput("out", "color3");
+    output->setConnectedNode(scale);
+
+    mx::GenContext context = setup.createContext();
+    context.getOptions().hwUniformBuffers = true;
+    mx::ShaderPtr shader = setup.generator->generate("graph", output, context);
+
+    // Blocks of the same name have the same layout in both stages.
+    const mx::ShaderStage& vs = shader->getStage(mx::Stage::VERTEX);
+    const mx::ShaderStage& ps = shader->getStage(mx::Stage::PIXEL);
+    for (const std::string& blockName : { mx::HW::PRIVATE_UNIFORMS, mx::HW::PUBLIC_UNIFORMS })
+    {
+        const mx::VariableBlock& vsBlock = vs.getUniformBlock(blockName);
+        const mx::VariableBlock& psBlock = ps.getUniformBlock(blockName);
+        REQUIRE(psBlock.hasBufferLayout());
+        REQUIRE(vsBlock.getBufferSize() == psBlock.getBufferSize());
+        REQUIRE(vsBlock.getBufferLayout().size() == psBlock.getBufferLayout().size());
+        REQUIRE(psBlock.getBufferSize() % 16 == 0);
+        size_t end = 0;
+        for (size_t i = 0; i < psBlock.getBufferLayout().size(); i++)
+        {
+            const mx::VariableBlock::BufferEntry& entry = psBlock.getBufferLayout()[i];
+            REQUIRE(entry.variable->getName() == vsBlock.getBufferLayout()[i].variable->getName());
+            REQUIRE(entry.offset == vsBlock.getBufferLayout()[i].offset);
+            REQUIRE(entry.offset >= end);
+            REQUIRE(entry.offset % 4 == 0);
+            end = entry.offset + 4;
+        }
+        REQUIRE(end <= psBlock.getBufferSize());
+        REQUIRE(ps.getSourceCode().find("layout (std140) uniform " + blockName) != std::string::npos);
+        REQUIRE(vs.getSourceCode().find("layout (std140) uniform " + blockName) != std::string::npos);
+    }
+
+    // Samplers remain individual uniforms.
+    const mx::VariableBlock& publicUniforms = ps.getUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+    REQUIRE(publicUniforms.getBufferLayout().size() < publicUniforms.size());
+    REQUIRE(ps.getSourceCode().find("uniform sampler2D ") != std::string::npos);
+}
+
+TEST_CASE("GenShader: GLSL Shader Variants", "[genglsl]")
+{
+    GlslTestSetup setup({ "stdlib", "pbrlib", "bxdf", "lights" });
+
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/Examples/StandardSurface/standard_surface_brass_tiled.mtlx"));
+    doc->importLibrary(setup.libraries);
+    std::vector<mx::TypedElementPtr> elements;
+    mx::findRenderableElements(doc, elements);
+    REQUIRE(!elements.empty());
+    mx::TypedElementPtr element = elements[0];
+
+    mx::GenContext context = setup.createContext();
+
+    // Light shaders are bound on a separate context, and passed to one
+    // permutation as user data.
+    mx::GenContext lightContext = context.fork();
+    mx::HwShaderGenerator::bindLightShader(*setup.libraries->getNodeDef("ND_point_light"), 1, lightContext);
+    mx::GenUserDataPtr lightShaders = lightContext.getUserData<mx::HwLightShaders>(mx::HW::USER_DATA_LIGHT_SHADERS);
+    REQUIRE(lightShaders);
+
+    // Permutations optimize their graphs, so that nodes are ordered by name
+    // and variants can be compared with shaders generated separately.
+    std::vector<mx::ShaderPermutation> permutations;
+    for (int interfaceType : { mx::SHADER_INTERFACE_COMPLETE, mx::SHADER_INTERFACE_REDUCED })
+    {
+        for (bool transparency : { false, true })
+        {
+            for (int specularMethod : { mx::SPECULAR_ENVIRONMENT_FIS, mx::SPECULAR_ENVIRONMENT_PREFILTER })
+            {
+                mx::ShaderPermutation permutation;
+                permutation.options.shaderInterfaceType = interfaceType;
+                permutation.options.hwTransparency = transparency;
+                permutation.options.hwSpecularEnvironmentMethod = specularMethod;
+                permutation.options.optimizeGraphExpressions = true;
+                permutations.push_back(permutation);
+            }
+        }
+    }
+    permutations.push_back(permutations[0]);
+    permutations.back().userData.push_back(std::make_pair(mx::HW::USER_DATA_LIGHT_SHADERS, lightShaders));
+
+    // Variants are generated on a context without cached implementations,
+    // and match shaders generated once implementations are cached.
+    mx::ShaderVariants variants;
+    variants.generate(element->getName(), element, permutations, context);
+    REQUIRE(variants.size() == permutations.size());
+    REQUIRE(variants.getGraphCount() == 2);
+
+    // Function definitions are emitted once for each stage, graph and
+    // transparency option, and for the pixel stage once more for each
+    // specular environment method, as the methods include different files
+    // ahead of the definitions.  The variant with bound light shaders reuses
+    // the definitions of the first variant.
+    REQUIRE(variants.getFunctionDefinitionCount() == 12);
+
+    // Each variant matches a shader generated separately with its permutation.
+    for (size_t i = 0; i < permutations.size(); i++)
+    {
+        mx::GenContext variantContext = context.fork();
+        variantContext.getOptions() = permutations[i].options;
+        for (const auto& userData : permutations[i].userData)
+        {
+            variantContext.pushUserData(userData.first, userData.second);
+        }
+        mx::ShaderPtr shader = setup.generator->generate(element->getName(), element, variantContext);
+        for (const std::string& stage : { mx::Stage::VERTEX, mx::Stage::PIXEL })
+        {
+            REQUIRE(variants.getSourceCode(i, stage) == shader->getSourceCode(stage));
+            REQUIRE(variants.getShader(i)->getSourceCode(stage) == shader->getSourceCode(stage));
+        }
+    }
+
+    // Stages that do not depend on the differing options are stored once.
+    REQUIRE(variants.getSourceIndex(0, mx::Stage::VERTEX) == variants.getSourceIndex(1, mx::Stage::VERTEX));
+    REQUIRE(variants.getSourceIndex(0, mx::Stage::PIXEL) != variants.getSourceIndex(1, mx::Stage::PIXEL));
+    REQUIRE(variants.getSources().size() < 2 * variants.size());
+    REQUIRE_THROWS_AS(variants.getSourceIndex(0, "geometry"), mx::ExceptionShaderGenError&);
+
+    // Options read while building the graph, such as the normalization of
+    // UDIM texture coordinates, give each permutation its own graph.
+    mx::DocumentPtr udimDoc = mx::createDocument();
+    udimDoc->importLibrary(setup.libraries);
+    mx::GeomInfoPtr udimInfo = udimDoc->addGeomInfo("udim_info");
+    udimInfo->setGeomAttrValue(mx::UDIMSET, mx::StringVec{ "1001", "1002", "1011", "1012" });
+    mx::NodeGraphPtr udimGraph = udimDoc->addNodeGraph("udim_graph");
+    mx::NodePtr udimImage = udimGraph->addNode("image", "udim_image", "color3");
+    udimImage->setParameterValue("file", std::string("udim_texture.<UDIM>.png"), mx::FILENAME_TYPE_STRING);
+    mx::OutputPtr udimOutput = udimGraph->addOutput("out", "color3");
+    udimOutput->setConnectedNode(udimImage);
+
+    std::vector<mx::ShaderPermutation> udimPermutations(2);
+    udimPermutations[0].options.optimizeGraphExpressions = true;
+    udimPermutations[1].options.optimizeGraphExpressions = true;
+    udimPermutations[1].options.hwNormalizeUdimTexCoords = true;
+    variants.generate("udim_shader", udimOutput, udimPermutations, context);
+    REQUIRE(variants.getGraphCount() == 2);
+    for (size_t i = 0; i < udimPermutations.size(); i++)
+    {
+        mx::GenContext variantContext = context.fork();
+        variantContext.getOptions() = udimPermutations[i].options;
+        mx::ShaderPtr shader = setup.generator->generate("udim_shader", udimOutput, variantContext);
+        REQUIRE(variants.getSourceCode(i, mx::Stage::PIXEL) == shader->getSourceCode(mx::Stage::PIXEL));
+    }
+    REQUIRE(variants.getSourceIndex(0, mx::Stage::PIXEL) != variants.getSourceIndex(1, mx::Stage::PIXEL));
+}
+
+TEST_CASE("GenShader: GLSL Generation Performance", "[.benchmark]")
+{
+    GlslTestSetup setup({ "stdlib", "pbrlib", "bxdf" });
+    std::vector<mx::DocumentPtr> documents;
+    std::vector<mx::TypedElementPtr> elements = loadRenderableExamples(setup.libraries, documents);
+    mx::GenContext context = setup.createContext();
+    const int iterations = 10;
+
+    // Generate once to cache implementations, then time repeated generation
+    // of each standard_surface material.
+    for (mx::TypedElementPtr elem : elements)
+    {
+        setup.generator->generate(elem->getName(), elem, context);
+    }
+    size_t codeSize = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        for (mx::TypedElementPtr elem : elements)
+        {
+            mx::ShaderPtr shader = setup.generator->generate(elem->getName(), elem, context);
+            codeSize += shader->getSourceCode(mx::Stage::PIXEL).size();
+        }
+    }
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    std::cout << "Generated " << elements.size() * iterations << " GLSL shaders (" << codeSize <<
+        " bytes of pixel code): " << time.count() << "s" << std::endl;
+}
+
 static void generateGlslCode()
 {
     const mx::FilePath testRootPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite");
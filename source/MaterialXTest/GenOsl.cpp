@@ -16,6 +16,7 @@
 
 #include <MaterialXGenShader/DefaultColorManagementSystem.h>
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/Shader.h>
 #include <MaterialXGenShader/Util.h>
 
 
@@ -107,6 +108,40 @@ TEST_CASE("GenShader: OSL Unique Names", "[genosl]")
     GenShaderUtil::testUniqueNames(context, mx::Stage::PIXEL);
 }
 
+TEST_CASE("GenShader: OSL Parallel Generation", "[genosl]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    loadLibraries({ "stdlib" }, searchPath, doc);
+
+    std::vector<mx::TypedElementPtr> elements;
+    for (int i = 0; i < 8; i++)
+    {
+        mx::NodeGraphPtr graph = doc->addNodeGraph("graph" + std::to_string(i));
+        mx::NodePtr multiply = graph->addNode("multiply", "multiply1", "float");
+        multiply->setInputValue("in1", 0.123456f);
+        multiply->setInputValue("in2", 0.5f);
+        mx::OutputPtr output = graph->addOutput("out", "float");
+        output->setConnectedNode(multiply);
+        elements.push_back(output);
+    }
+
+    mx::GenContext context(mx::OslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    context.registerSourceCodeSearchPath(searchPath / mx::FilePath("stdlib/osl"));
+
+    // Every worker thread formats values like the calling thread.
+    mx::ScopedFloatFormatting format(mx::Value::FloatFormatFixed, 2);
+    std::vector<mx::ShaderPtr> shaders = context.getShaderGenerator().generateAll(elements, context, 4);
+    REQUIRE(shaders.size() == elements.size());
+    for (mx::ShaderPtr shader : shaders)
+    {
+        const std::string& code = shader->getSourceCode(mx::Stage::PIXEL);
+        REQUIRE(code.find("0.12") != std::string::npos);
+        REQUIRE(code.find("0.123456") == std::string::npos);
+    }
+}
+
 static void generateOslCode()
 {
     const mx::FilePath testRootPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite");
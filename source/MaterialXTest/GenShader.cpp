@@ -13,6 +13,7 @@
 
 #include <MaterialXGenShader/HwShaderGenerator.h>
 #include <MaterialXGenShader/Nodes/SwizzleNode.h>
+#include <MaterialXGenShader/TokenTable.h>
 #include <MaterialXGenShader/TypeDesc.h>
 #include <MaterialXGenShader/Util.h>
 
@@ -50,6 +51,21 @@ TEST_CASE("GenShader: Utilities", "[genshader]")
     mx::StringMap subst2 = { {mx::HW::T_ENV_RADIANCE, mx::HW::ENV_RADIANCE} };
     mx::tokenSubstitution(subst2, test2);
     REQUIRE(test2 == result2);
+
+    // Test a compiled token table
+    mx::StringMap subst3 = { {"$a","x"}, {"$ab","y"}, {"$abc",""}, {"$nested","$a"}, {"missingPrefix","z"} };
+    mx::TokenTable table(subst3);
+    std::string test3 = "$a+$ab*$abc-$abd/$nested $missingPrefix$";
+    std::string result3 = test3;
+    mx::tokenSubstitution(subst3, result3);
+    table.substitute(test3);
+    REQUIRE(test3 == "x+y*-$abd/$a $missingPrefix$");
+    REQUIRE(test3 == result3);
+    REQUIRE(table.find("ab", 2) != nullptr);
+    REQUIRE(*table.find("ab", 2) == "y");
+    REQUIRE(table.find("abd", 3) == nullptr);
+    REQUIRE(table.find("missingPrefix", 13) == nullptr);
+    REQUIRE(mx::TokenTable().empty());
 }
 
 TEST_CASE("GenShader: Valid Libraries", "[genshader]")
@@ -66,6 +82,12 @@ TEST_CASE("GenShader: Valid Libraries", "[genshader]")
         std::cout << validationErrors << std::endl;
     }
     REQUIRE(valid);
+
+    // Load the libraries concurrently, and verify that the result matches
+    // a serial load.
+    mx::DocumentPtr parallelDoc = mx::createDocument();
+    loadLibraries({ "stdlib", "pbrlib" }, searchPath, parallelDoc, nullptr, 4);
+    REQUIRE(*parallelDoc == *doc);
 }
 
 TEST_CASE("GenShader: TypeDesc Check", "[genshader]")
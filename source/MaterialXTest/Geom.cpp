@@ -7,6 +7,9 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <chrono>
+#include <iostream>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Geom strings", "[geom]")
@@ -22,6 +25,49 @@ TEST_CASE("Geom strings", "[geom]")
     // Test that one path contains another.
     REQUIRE(mx::geomStringsMatch("/", "/robot1", true));
     REQUIRE(!mx::geomStringsMatch("/robot1", "/", true));
+
+    // Test parsed geometry paths.
+    std::vector<mx::GeomPath> paths = mx::parseGeomString("/robot1/left_arm, robot2, /");
+    REQUIRE(paths.size() == 3);
+    REQUIRE(paths[0] == mx::GeomPath("robot1/left_arm"));
+    REQUIRE(paths[1] != mx::GeomPath("/robot1"));
+    REQUIRE((std::string) paths[0] == "robot1/left_arm");
+    REQUIRE(paths[2].isUniversal());
+    REQUIRE(mx::GeomPath().isEmpty());
+    REQUIRE(mx::geomPathsMatch(paths, mx::parseGeomString("/robot1")));
+    REQUIRE(!mx::geomPathsMatch(mx::parseGeomString("/robot1/right_arm"), paths, true));
+    REQUIRE(mx::parseGeomString("").empty());
+
+    // Test paths interned in pools against paths storing their own segments.
+    mx::StringPoolPtr pool1 = std::make_shared<mx::StringPool>();
+    mx::StringPoolPtr pool2 = std::make_shared<mx::StringPool>();
+    mx::GeomPath pooledPath1("/robot1/left_arm", pool1);
+    mx::GeomPath pooledPath2("/robot1/left_arm", pool2);
+    REQUIRE(pooledPath1 == mx::GeomPath("/robot1/left_arm", pool1));
+    REQUIRE(pooledPath1 == pooledPath2);
+    REQUIRE(pooledPath1 == paths[0]);
+    REQUIRE(pooledPath2.isMatching(mx::GeomPath("/robot1")));
+    REQUIRE(!mx::GeomPath("/robot2", pool1).isMatching(pooledPath1));
+    REQUIRE(pool1->size() == 3);
+
+    // Test paths looking up their segments without interning them.
+    mx::GeomPath lookupPath1("/robot1/right_arm", pool1, false);
+    mx::GeomPath lookupPath2("/robot1/right_arm", pool1, false);
+    REQUIRE(pool1->size() == 3);
+    REQUIRE((std::string) lookupPath1 == "robot1/right_arm");
+    REQUIRE(lookupPath1.isMatching(mx::GeomPath("/robot1", pool1)));
+    REQUIRE(!lookupPath1.isMatching(pooledPath1));
+    REQUIRE(lookupPath1 == lookupPath2);
+    REQUIRE(mx::GeomPath("/robot1/left_arm", pool1, false) == pooledPath1);
+
+    // Cached paths remain valid after their document is destroyed.
+    mx::GeomPathCache::ConstPathsPtr cachedPaths;
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        cachedPaths = doc->addGeomInfo("geominfo1", "/robot1/left_arm")->getActiveGeomPaths();
+    }
+    REQUIRE((std::string) cachedPaths->at(0) == "robot1/left_arm");
+    REQUIRE(cachedPaths->at(0) == paths[0]);
 }
 
 TEST_CASE("Geom elements", "[geom]")
@@ -85,6 +131,108 @@ TEST_CASE("Geom elements", "[geom]")
     REQUIRE(!collection1->matchesGeomString("/root/scene2"));
 }
 
+TEST_CASE("Geom path caching", "[geom]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::LookPtr look = doc->addLook();
+    mx::MaterialAssignPtr matAssign = look->addMaterialAssign();
+    matAssign->setGeom("/robot1");
+
+    // Cached paths are reused until a geometry attribute is edited.
+    mx::GeomPathCache::ConstPathsPtr paths = matAssign->getActiveGeomPaths();
+    REQUIRE(paths->size() == 1);
+    REQUIRE(matAssign->getActiveGeomPaths() == paths);
+    matAssign->setMaterial("material1");
+    REQUIRE(matAssign->getActiveGeomPaths() == paths);
+    matAssign->setGeom("/robot1, /robot2");
+    REQUIRE(matAssign->getActiveGeomPaths()->size() == 2);
+    look->setGeomPrefix("/scene");
+    REQUIRE(matAssign->getActiveGeomPaths()->at(0) == mx::GeomPath("/scene/robot1"));
+    look->removeAttribute(mx::Element::GEOM_PREFIX_ATTRIBUTE);
+    REQUIRE(matAssign->getActiveGeomPaths()->at(0) == mx::GeomPath("/robot1"));
+
+    // Collections re-parse their include and exclude geometries.
+    mx::CollectionPtr collection = doc->addCollection();
+    collection->setIncludeGeom("/robot1");
+    REQUIRE(collection->matchesGeomString("/robot1/left_arm"));
+    collection->setExcludeGeom("/robot1/left_arm");
+    REQUIRE(!collection->matchesGeomString("/robot1/left_arm"));
+    collection->removeAttribute(mx::Collection::EXCLUDE_GEOM_ATTRIBUTE);
+    REQUIRE(collection->matchesGeomString("/robot1/left_arm"));
+    REQUIRE(collection->getActiveExcludeGeomPaths()->empty());
+
+    // Copied and cleared content is re-parsed.
+    mx::CollectionPtr copy = doc->addCollection();
+    REQUIRE(copy->getActiveIncludeGeomPaths()->empty());
+    copy->copyContentFrom(collection);
+    REQUIRE(copy->matchesGeomString("/robot1"));
+    copy->clearContent();
+    REQUIRE(!copy->matchesGeomString("/robot1"));
+
+    // Queries with segments missing from the pool of the document match
+    // the cached paths sharing their segments.
+    REQUIRE(collection->matchesGeomString("/robot1/right_arm"));
+    REQUIRE(!collection->matchesGeomString("/robot3/right_arm"));
+    REQUIRE(!collection->matchesGeomString("/robot3, /robot4"));
+    REQUIRE(collection->matchesGeomString("/robot3, /robot1"));
+}
+
+TEST_CASE("Collection matching performance", "[.benchmark]")
+{
+    const int geomCount = 10000;
+    const int queryCount = 200;
+
+    // Create a large collection of geometries, and a set of queries that
+    // match geometries near the end of the collection.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::CollectionPtr collection = doc->addCollection();
+    std::string includeGeom;
+    for (int i = 0; i < geomCount; i++)
+    {
+        includeGeom += (i ? "," : "") + std::string("/world/set") + std::to_string(i % 10) + "/prop" + std::to_string(i);
+    }
+    collection->setIncludeGeom(includeGeom);
+    mx::StringVec queries;
+    for (int i = 0; i < queryCount; i++)
+    {
+        int prop = geomCount - 1 - i;
+        queries.push_back("/world/set" + std::to_string(prop % 10) + "/prop" + std::to_string(prop) + "/mesh");
+    }
+
+    // Compare matching through geometry strings, which are parsed on each
+    // call, with matching through the cached paths of the collection.
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& query : queries)
+    {
+        REQUIRE(mx::geomStringsMatch(collection->getActiveIncludeGeom(), query));
+    }
+    std::chrono::duration<double> stringTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (const std::string& query : queries)
+    {
+        REQUIRE(collection->matchesGeomString(query));
+    }
+    std::chrono::duration<double> cachedTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    std::vector<std::vector<mx::GeomPath>> queryPaths;
+    for (const std::string& query : queries)
+    {
+        queryPaths.push_back(mx::parseGeomString(query));
+    }
+    for (const std::vector<mx::GeomPath>& paths : queryPaths)
+    {
+        REQUIRE(collection->matchesGeomPaths(paths));
+    }
+    std::chrono::duration<double> parsedTime = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Collection of " << geomCount << " geometries, " << queryCount << " queries: " <<
+                 "geometry strings " << stringTime.count() << "s, cached collection paths " <<
+                 cachedTime.count() << "s, parsed query paths " << parsedTime.count() << "s" << std::endl;
+    REQUIRE(cachedTime.count() < stringTime.count());
+}
+
 TEST_CASE("GeomPropDef", "[geom]")
 {
     mx::DocumentPtr doc = mx::createDocument();
@@ -7,6 +7,8 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <algorithm>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Look", "[look]")
@@ -89,3 +91,197 @@ TEST_CASE("Look", "[look]")
     REQUIRE(look2->getActivePropertySetAssigns().empty());
     REQUIRE(look2->getActiveVisibilities().empty());
 }
+
+TEST_CASE("GeomBindingIndex", "[look]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::MaterialPtr material = doc->addMaterial();
+    mx::LookPtr look = doc->addLook();
+
+    // Create nested collections.
+    mx::CollectionPtr robots = doc->addCollection("robots");
+    robots->setIncludeGeom("/robot1,/robot2");
+    robots->setExcludeGeom("/robot2/left_arm");
+    mx::CollectionPtr scene = doc->addCollection("scene");
+    scene->setIncludeGeom("/ground");
+    scene->setIncludeCollections({ robots });
+    scene->setExcludeGeom("/robot1/head");
+
+    // Create bindings of each type.
+    mx::MaterialAssignPtr matAssign1 = look->addMaterialAssign("matAssign1", material->getName());
+    matAssign1->setGeom("/robot1/right_arm/hand");
+    mx::MaterialAssignPtr matAssign2 = look->addMaterialAssign("matAssign2", material->getName());
+    matAssign2->setCollection(scene);
+    mx::MaterialAssignPtr matAssign3 = look->addMaterialAssign("matAssign3", material->getName());
+    matAssign3->setGeom("/");
+    mx::PropertyAssignPtr propertyAssign = look->addPropertyAssign("twosided");
+    propertyAssign->setGeom("/robot2");
+    mx::PropertySetAssignPtr propertySetAssign = look->addPropertySetAssign();
+    propertySetAssign->setCollection(robots);
+    mx::VisibilityPtr visibility = look->addVisibility();
+    visibility->setGeom("/robot1/head,/ground");
+
+    // Compare the index with direct comparisons of geometry strings.
+    const mx::StringVec geoms =
+    {
+        "/", "/robot1", "/robot1/head", "/robot1/right_arm", "/robot1/right_arm/hand/finger",
+        "/robot2", "/robot2/left_arm", "/robot2/left_arm/hand", "/robot2/right_arm", "/robot3",
+        "/ground", "/robot3,/robot2/left_arm", "/robot1/head,/robot2", ""
+    };
+    auto checkIndex = [&]()
+    {
+        mx::ConstGeomBindingIndexPtr index = doc->getGeomBindingIndex();
+        for (const std::string& geom : geoms)
+        {
+            std::vector<mx::ElementPtr> expected;
+            bool cycle = false;
+            try
+            {
+                for (mx::ElementPtr child : look->getChildren())
+                {
+                    mx::GeomElementPtr geomElem = child->asA<mx::GeomElement>();
+                    mx::PropertyAssignPtr propAssign = child->asA<mx::PropertyAssign>();
+                    std::string bindingGeom = geomElem ? geomElem->getActiveGeom() : propAssign->getGeom();
+                    mx::CollectionPtr collection = geomElem ? geomElem->getCollection() : propAssign->getCollection();
+                    if (mx::geomStringsMatch(geom, bindingGeom) || (collection && collection->matchesGeomString(geom)))
+                    {
+                        expected.push_back(child);
+                    }
+                }
+            }
+            catch (mx::ExceptionFoundCycle&)
+            {
+                cycle = true;
+            }
+            if (cycle)
+            {
+                REQUIRE_THROWS_AS(index->getBindings(geom), mx::ExceptionFoundCycle&);
+            }
+            else
+            {
+                REQUIRE(index->getBindings(geom) == expected);
+            }
+        }
+    };
+    checkIndex();
+    REQUIRE(doc->getGeomBindingIndex()->getBindingCount() == 6);
+
+    mx::ConstGeomBindingIndexPtr index = doc->getGeomBindingIndex();
+    REQUIRE(index->getMaterialAssigns("/robot1/right_arm").size() == 3);
+    REQUIRE(index->getMaterialAssigns("/robot1/head").size() == 1);
+    REQUIRE(index->getPropertyAssigns("/robot2/left_arm").size() == 1);
+    REQUIRE(index->getPropertySetAssigns("/robot2/left_arm").empty());
+    REQUIRE(index->getVisibilities("/ground").size() == 1);
+    REQUIRE(material->getGeometryBindings("/robot2/left_arm").size() == 1);
+    REQUIRE(material->getGeometryBindings("/robot2/right_arm").size() == 2);
+
+    // Edits to looks and collections are reflected in the index.
+    robots->setExcludeGeom("/robot2/right_arm");
+    REQUIRE(doc->getGeomBindingIndex() != index);
+    checkIndex();
+    REQUIRE(material->getGeometryBindings("/robot2/right_arm").size() == 1);
+    matAssign3->setGeom("/robot3");
+    checkIndex();
+    look->removeMaterialAssign(matAssign1->getName());
+    checkIndex();
+    scene->setIncludeCollections({});
+    checkIndex();
+    REQUIRE(material->getGeometryBindings("/robot1").empty());
+    doc->setGeomPrefix("/robot1");
+    checkIndex();
+    REQUIRE(doc->getGeomBindingIndex()->getVisibilities(visibility->getActiveGeom()).size() == 1);
+
+    // Edits to other elements leave the index in place.
+    index = doc->getGeomBindingIndex();
+    material->addShaderRef();
+    REQUIRE(doc->getGeomBindingIndex() == index);
+
+    // Collections with include cycles raise ExceptionFoundCycle when their
+    // own geometries do not decide a match, as in Collection::matchesGeomString.
+    doc->removeAttribute(mx::Element::GEOM_PREFIX_ATTRIBUTE);
+    scene->setIncludeCollections({ robots });
+    robots->setIncludeCollections({ scene });
+    checkIndex();
+    REQUIRE_THROWS_AS(material->getGeometryBindings("/robot2/right_arm"), mx::ExceptionFoundCycle&);
+    REQUIRE_THROWS_AS(doc->getGeomBindingIndex()->resolveBindings({ "/robot2/right_arm" }), mx::ExceptionFoundCycle&);
+    REQUIRE(material->getGeometryBindings("/ground").size() == 1);
+    REQUIRE(material->getGeometryBindings("/robot1/head").empty());
+}
+
+TEST_CASE("GeomBindingIndex batch resolution", "[look]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::MaterialPtr material = doc->addMaterial();
+    mx::LookPtr look1 = doc->addLook("look1");
+    mx::LookPtr look2 = doc->addLook("look2");
+    mx::CollectionPtr collection = doc->addCollection();
+    collection->setIncludeGeom("/world/set1");
+    collection->setExcludeGeom("/world/set1/prop3");
+
+    // Build a sorted hierarchy of geometry paths, with bindings at several levels.
+    mx::StringVec geomPaths = { "", "/", "/world" };
+    for (int set = 0; set < 4; set++)
+    {
+        std::string setPath = "/world/set" + std::to_string(set);
+        geomPaths.push_back(setPath);
+        for (int prop = 0; prop < 100; prop++)
+        {
+            std::string propPath = setPath + "/prop" + std::to_string(prop);
+            geomPaths.push_back(propPath);
+            geomPaths.push_back(propPath + "/mesh");
+            if (prop % 7 == 0)
+            {
+                look1->addMaterialAssign("", material->getName())->setGeom(propPath);
+            }
+            if (prop % 11 == 0)
+            {
+                look2->addPropertyAssign()->setGeom(propPath + "/mesh");
+            }
+        }
+    }
+    look1->addVisibility()->setCollection(collection);
+    look2->addMaterialAssign("", material->getName())->setGeom("/world/set2");
+    std::sort(geomPaths.begin(), geomPaths.end());
+
+    mx::ConstGeomBindingIndexPtr index = doc->getGeomBindingIndex();
+    for (unsigned int threadCount : { 1u, 4u })
+    {
+        mx::GeomBindingTable table = index->resolveBindings(geomPaths, nullptr, threadCount);
+        REQUIRE(table.getGeomCount() == geomPaths.size());
+        for (size_t i = 0; i < geomPaths.size(); i++)
+        {
+            std::vector<mx::ElementPtr> bindings;
+            for (size_t j = 0; j < table.getBindingCount(i); j++)
+            {
+                bindings.push_back(index->getBinding(table.getBindingIndex(i, j)));
+            }
+            REQUIRE(bindings == index->getBindings(geomPaths[i]));
+        }
+    }
+
+    // Restrict the bindings to a single look, and to a look inheriting from it.
+    mx::LookPtr look3 = doc->addLook("look3");
+    look3->setInheritsFrom(look2);
+    index = doc->getGeomBindingIndex();
+    for (mx::LookPtr look : { look1, look2, look3 })
+    {
+        mx::GeomBindingTable table = index->resolveBindings(geomPaths, look);
+        for (size_t i = 0; i < geomPaths.size(); i++)
+        {
+            std::vector<mx::ElementPtr> bindings;
+            for (mx::ElementPtr binding : index->getBindings(geomPaths[i]))
+            {
+                if (binding->getParent() == (look == look1 ? look1 : look2))
+                {
+                    bindings.push_back(binding);
+                }
+            }
+            REQUIRE(table.getBindingCount(i) == bindings.size());
+            for (size_t j = 0; j < bindings.size(); j++)
+            {
+                REQUIRE(index->getBinding(table.getBindingIndex(i, j)) == bindings[j]);
+            }
+        }
+    }
+    REQUIRE(index->resolveBindings({}).getGeomCount() == 0);
+}
@@ -11,6 +11,9 @@
 #include <MaterialXFormat/File.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <chrono>
+#include <iostream>
+
 namespace mx = MaterialX;
 
 bool isTopologicalOrder(const std::vector<mx::ElementPtr>& elems)
@@ -182,6 +185,71 @@ TEST_CASE("Flatten", "[nodegraph]")
     REQUIRE(totalNodeCount == 15);
 }
 
+TEST_CASE("Flatten and upgrade scaling", "[.benchmark]")
+{
+    std::vector<double> times;
+    for (int nodeCount : { 1000, 10000 })
+    {
+        // Create a nodedef with a nodegraph implementation.
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_pair", "color3", "pair");
+        mx::NodeGraphPtr implGraph = doc->addNodeGraph("NG_pair");
+        implGraph->setNodeDef(nodeDef);
+        mx::NodePtr constant = implGraph->addNode("constant", "constant1", "color3");
+        mx::NodePtr add = implGraph->addNode("add", "add1", "color3");
+        add->setConnectedNode("in1", constant);
+        implGraph->addOutput("out", "color3")->setConnectedNode(add);
+
+        // Create a graph of instances, each connected to its predecessor.
+        mx::NodeGraphPtr graph = doc->addNodeGraph("main");
+        mx::NodePtr previous;
+        for (int i = 0; i < nodeCount; i++)
+        {
+            mx::NodePtr node = graph->addNode("pair", "pair" + std::to_string(i), "color3");
+            if (previous)
+            {
+                graph->addNode("add", "add" + std::to_string(i), "color3")->setConnectedNode("in1", previous);
+            }
+            previous = node;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        graph->flattenSubgraphs();
+        std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        times.push_back(time.count());
+        std::cout << "Flatten time for " << nodeCount << " nodes: " << time.count() << "s" << std::endl;
+
+        REQUIRE(graph->getNodes("pair").empty());
+        REQUIRE(graph->getNodes().size() == (size_t) (3 * nodeCount - 1));
+    }
+
+    // Flattening scales with the node count, rather than its square.
+    REQUIRE(times[1] < times[0] * 50.0);
+
+    // Upgrade documents whose opgraph elements are replaced by node graphs,
+    // each taking the place of the original in the child order.
+    times.clear();
+    for (int graphCount : { 1000, 10000 })
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        doc->setVersionString("1.26");
+        for (int i = 0; i < graphCount; i++)
+        {
+            doc->addChildOfCategory("opgraph", "graph" + std::to_string(i));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        doc->upgradeVersion();
+        std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        times.push_back(time.count());
+        std::cout << "Upgrade time for " << graphCount << " graphs: " << time.count() << "s" << std::endl;
+
+        REQUIRE(doc->getNodeGraphs().size() == (size_t) graphCount);
+        REQUIRE(doc->getChildIndex("graph" + std::to_string(graphCount / 2)) == graphCount / 2);
+    }
+    REQUIRE(times[1] < times[0] * 50.0);
+}
+
 TEST_CASE("Topological sort", "[nodegraph]")
 {
     // Create a document.
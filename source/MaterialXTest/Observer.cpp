@@ -8,6 +8,9 @@
 #include <MaterialXCore/Observer.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <chrono>
+#include <iostream>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Observer", "[observer]")
@@ -24,6 +27,7 @@ TEST_CASE("Observer", "[observer]")
             _removeAttributeCount(0),
             _copyContentCount(0),
             _clearContentCount(0),
+            _batchEditCount(0),
             _readCount(0),
             _writeCount(0)
         {
@@ -37,6 +41,7 @@ TEST_CASE("Observer", "[observer]")
         void onRemoveAttribute(mx::ElementPtr elem, const std::string&) override { _removeAttributeCount++; }
         void onCopyContent(mx::ElementPtr elem) override { _copyContentCount++; }
         void onClearContent(mx::ElementPtr elem) override { _clearContentCount++; }
+        void onBatchEdit(mx::ElementPtr) override { _batchEditCount++; }
         void onRead() override { _readCount++; }
         void onWrite() override { _writeCount++; }
 
@@ -50,6 +55,7 @@ TEST_CASE("Observer", "[observer]")
             _removeAttributeCount = 0;
             _copyContentCount = 0;
             _clearContentCount = 0;
+            _batchEditCount = 0;
             _readCount = 0;
             _writeCount = 0;
         }
@@ -64,6 +70,7 @@ TEST_CASE("Observer", "[observer]")
             REQUIRE(_removeAttributeCount == 0);
             REQUIRE(_copyContentCount == 0);
             REQUIRE(_clearContentCount == 0);
+            REQUIRE(_batchEditCount == 0);
             REQUIRE(_readCount == 0);
             REQUIRE(_writeCount == 0);
         }
@@ -72,12 +79,13 @@ TEST_CASE("Observer", "[observer]")
         {
             REQUIRE(_beginUpdateCount == 4);
             REQUIRE(_endUpdateCount == 4);
-            REQUIRE(_addElementCount == 10);
-            REQUIRE(_setAttributeCount == 13);
+            REQUIRE(_addElementCount == 0);
+            REQUIRE(_setAttributeCount == 1);
             REQUIRE(_removeElementCount == 3);
             REQUIRE(_removeAttributeCount == 0);
             REQUIRE(_copyContentCount == 0);
             REQUIRE(_clearContentCount == 1);
+            REQUIRE(_batchEditCount == 1);
             REQUIRE(_readCount == 1);
             REQUIRE(_writeCount == 1);
         }
@@ -92,6 +100,7 @@ TEST_CASE("Observer", "[observer]")
             REQUIRE(_removeAttributeCount == 0);
             REQUIRE(_copyContentCount == 0);
             REQUIRE(_clearContentCount == 0);
+            REQUIRE(_batchEditCount == 0);
             REQUIRE(_readCount == 0);
             REQUIRE(_writeCount == 0);
         }
@@ -106,6 +115,7 @@ TEST_CASE("Observer", "[observer]")
         unsigned int _removeAttributeCount;
         unsigned int _copyContentCount;
         unsigned int _clearContentCount;
+        unsigned int _batchEditCount;
         unsigned int _readCount;
         unsigned int _writeCount;
     };
@@ -154,3 +164,166 @@ TEST_CASE("Observer", "[observer]")
     mx::readFromXmlString(doc, xmlString);
     testObserver->verifyCountsDisabled();
 }
+
+TEST_CASE("Batch edit", "[observer]")
+{
+    class BatchObserver : public mx::Observer
+    {
+      public:
+        BatchObserver() :
+            editCount(0),
+            batchEditCount(0)
+        {
+        }
+
+        void onAddElement(mx::ElementPtr, mx::ElementPtr) override { editCount++; }
+        void onRemoveElement(mx::ElementPtr, mx::ElementPtr) override { editCount++; }
+        void onSetAttribute(mx::ElementPtr, const std::string&, const std::string&) override { editCount++; }
+        void onBatchEdit(mx::ElementPtr elem) override
+        {
+            batchEditCount++;
+            batchElement = elem;
+        }
+
+        unsigned int editCount;
+        unsigned int batchEditCount;
+        mx::ElementPtr batchElement;
+    };
+
+    mx::ObservedDocumentPtr doc = mx::Document::createDocument<mx::ObservedDocument>();
+    std::shared_ptr<BatchObserver> observer = std::make_shared<BatchObserver>();
+    doc->addObserver("batchObserver", observer);
+
+    // Edits within a batch are reported by a single notification, and are
+    // visible to document lookups as they are made.
+    {
+        mx::ScopedBatchEdit batch(doc);
+        doc->addNodeDef("ND_test1", "color3", "test1");
+        REQUIRE(doc->getNodeDef("ND_test1"));
+        doc->addNodeDef("ND_test2", "color3", "test2");
+        REQUIRE(doc->getMatchingNodeDefs("test2").size() == 1);
+        REQUIRE(observer->batchEditCount == 0);
+    }
+    REQUIRE(observer->editCount == 0);
+    REQUIRE(observer->batchEditCount == 1);
+    REQUIRE(observer->batchElement == doc);
+    REQUIRE(doc->getMatchingNodeDefs("test1").size() == 1);
+
+    // Edits and removals within a batch are reflected in document lookups
+    // once the batch ends.
+    {
+        mx::ScopedBatchEdit batch(doc, doc->getNodeDef("ND_test1"));
+        doc->getNodeDef("ND_test1")->setNodeString("test3");
+    }
+    REQUIRE(observer->batchElement == doc->getNodeDef("ND_test1"));
+    REQUIRE(doc->getMatchingNodeDefs("test3").size() == 1);
+    {
+        mx::ScopedBatchEdit batch(doc);
+        doc->removeNodeDef("ND_test2");
+    }
+    REQUIRE(doc->getMatchingNodeDefs("test2").empty());
+    REQUIRE(observer->editCount == 0);
+
+    // Nested edits beyond the scope of the outermost edit widen its scope
+    // to the full document.
+    mx::NodeGraphPtr graph1 = doc->addNodeGraph("graph1");
+    mx::NodeGraphPtr graph2 = doc->addNodeGraph("graph2");
+    observer->batchEditCount = 0;
+    {
+        mx::ScopedBatchEdit batch(doc, graph1);
+        graph1->addNode("constant");
+        {
+            mx::ScopedBatchEdit nested(doc, graph1->getNodes()[0]);
+        }
+        REQUIRE(observer->batchEditCount == 0);
+    }
+    REQUIRE(observer->batchEditCount == 1);
+    REQUIRE(observer->batchElement == graph1);
+    {
+        mx::ScopedBatchEdit batch(doc, graph1);
+        mx::ScopedBatchEdit nested(doc, graph2);
+    }
+    REQUIRE(observer->batchEditCount == 2);
+    REQUIRE(observer->batchElement == doc);
+
+    // Copied content is reported as a single batch edit.
+    observer->editCount = 0;
+    graph2->copyContentFrom(graph1);
+    REQUIRE(graph2->getNodes().size() == 1);
+    REQUIRE(observer->editCount == 0);
+    REQUIRE(observer->batchEditCount == 3);
+    REQUIRE(observer->batchElement == graph2);
+
+    // Exceptions thrown by observers at the end of a batch edit propagate
+    // from commit, and are discarded when an uncommitted batch edit is
+    // destroyed during the propagation of another exception.
+    class ThrowingObserver : public mx::Observer
+    {
+      public:
+        void onBatchEdit(mx::ElementPtr) override { throw mx::Exception("Batch edit rejected"); }
+    };
+    doc->addObserver("throwingObserver", std::make_shared<ThrowingObserver>());
+    {
+        mx::ScopedBatchEdit batch(doc);
+        doc->addNodeDef("ND_test4", "color3", "test4");
+        REQUIRE_THROWS_AS(batch.commit(), mx::Exception&);
+        REQUIRE_NOTHROW(batch.commit());
+    }
+    REQUIRE(doc->getUpdateScope() == 0);
+    std::string message;
+    try
+    {
+        mx::ScopedBatchEdit batch(doc);
+        doc->addNodeDef("ND_test5", "color3", "test5");
+        throw mx::Exception("Edit failed");
+    }
+    catch (mx::Exception& e)
+    {
+        message = e.what();
+    }
+    REQUIRE(message == "Edit failed");
+    REQUIRE(doc->getUpdateScope() == 0);
+    REQUIRE_THROWS_AS(doc->importLibrary(mx::createDocument()), mx::Exception&);
+    doc->removeObserver("throwingObserver");
+
+    // Edits after a batch edit send individual notifications.
+    doc->addNodeDef("ND_test6", "color3", "test6");
+    REQUIRE(observer->editCount > 0);
+}
+
+TEST_CASE("Batch edit performance", "[.benchmark]")
+{
+    const int nodeCount = 20000;
+
+    // Build a large node graph with and without batch edits, in a document
+    // with a registered observer.
+    std::chrono::duration<double> times[2];
+    for (int batchEdit = 0; batchEdit < 2; batchEdit++)
+    {
+        mx::ObservedDocumentPtr doc = mx::Document::createDocument<mx::ObservedDocument>();
+        doc->addObserver("observer", std::make_shared<mx::Observer>());
+        mx::NodeGraphPtr graph = doc->addNodeGraph();
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::unique_ptr<mx::ScopedBatchEdit> batch;
+            if (batchEdit)
+            {
+                batch.reset(new mx::ScopedBatchEdit(doc, graph));
+            }
+            for (int i = 0; i < nodeCount; i++)
+            {
+                mx::NodePtr node = graph->addNode("constant", "node" + std::to_string(i), "color3");
+                node->setParameterValue("value", mx::Color3(0.5f));
+                node->setAttribute("xpos", std::to_string(i));
+                node->setAttribute("ypos", std::to_string(i));
+            }
+        }
+        times[batchEdit] = std::chrono::steady_clock::now() - start;
+        REQUIRE(graph->getNodes().size() == nodeCount);
+    }
+
+    std::cout << "Graph construction, individual edits: " << times[0].count() <<
+                 "s, batch edit: " << times[1].count() << "s" << std::endl;
+    REQUIRE(times[1].count() < times[0].count());
+}
@@ -29,12 +29,16 @@
 
 #include <MaterialXRender/GeometryHandler.h>
 #include <MaterialXRender/TinyObjLoader.h>
+#include <MaterialXRender/ParallelObjLoader.h>
 
 #include <fstream>
 #include <iostream>
 #include <unordered_set>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <ctime>
+#include <thread>
 
 namespace mx = MaterialX;
 
@@ -115,6 +119,246 @@ TEST_CASE("Render: Geometry Handler Load", "[rendercore]")
     geomHandlerLog.close();
 }
 
+// A geometry loader implementing only the load method without options.
+class CountingGeometryLoader : public mx::GeometryLoader
+{
+  public:
+    CountingGeometryLoader() :
+        loadCount(0)
+    {
+    }
+
+    bool load(const mx::FilePath&, mx::MeshList&) override
+    {
+        loadCount++;
+        return true;
+    }
+
+    int loadCount;
+};
+
+TEST_CASE("Render: Indexed Geometry Load", "[rendercore]")
+{
+    mx::FilePath geomPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Geometry/");
+    for (const mx::FilePath& file : geomPath.getFilesInDirectory("obj"))
+    {
+        // Load each file with exploded and indexed vertices.
+        mx::MeshList meshLists[2];
+        for (int indexed = 0; indexed < 2; indexed++)
+        {
+            mx::GeometryLoadOptions options;
+            options.indexedVertices = indexed != 0;
+            mx::GeometryHandlerPtr handler = mx::GeometryHandler::create();
+            handler->addLoader(mx::TinyObjLoader::create());
+            REQUIRE(handler->loadGeometry(geomPath / file, options));
+            meshLists[indexed] = handler->getMeshes();
+            REQUIRE(meshLists[indexed].size() == 1);
+        }
+        mx::MeshPtr exploded = meshLists[0][0];
+        mx::MeshPtr indexed = meshLists[1][0];
+        REQUIRE(indexed->getVertexCount() <= exploded->getVertexCount());
+        REQUIRE(indexed->getPartitionCount() == exploded->getPartitionCount());
+
+        // Loading a file again replaces its meshes only if the options differ.
+        mx::GeometryLoadOptions options;
+        mx::GeometryHandlerPtr handler = mx::GeometryHandler::create();
+        handler->addLoader(mx::TinyObjLoader::create());
+        REQUIRE(handler->loadGeometry(geomPath / file, options));
+        mx::MeshPtr loaded = handler->getMeshes()[0];
+        REQUIRE(handler->loadGeometry(geomPath / file, options));
+        REQUIRE(handler->getMeshes().size() == 1);
+        REQUIRE(handler->getMeshes()[0] == loaded);
+        options.indexedVertices = true;
+        REQUIRE(handler->loadGeometry(geomPath / file, options));
+        REQUIRE(handler->getMeshes().size() == 1);
+        REQUIRE(handler->getMeshes()[0]->getVertexCount() == indexed->getVertexCount());
+
+        // Each face corner refers to the same vertex data in both meshes.
+        for (const std::string& attribute : { mx::MeshStream::POSITION_ATTRIBUTE, mx::MeshStream::NORMAL_ATTRIBUTE,
+                                              mx::MeshStream::TEXCOORD_ATTRIBUTE })
+        {
+            mx::MeshStreamPtr explodedStream = exploded->getStream(attribute, 0);
+            mx::MeshStreamPtr indexedStream = indexed->getStream(attribute, 0);
+            REQUIRE(indexedStream->getData().size() == indexed->getVertexCount() * indexedStream->getStride());
+            unsigned int stride = explodedStream->getStride();
+            for (size_t p = 0; p < exploded->getPartitionCount(); p++)
+            {
+                const mx::MeshIndexBuffer& explodedIndices = exploded->getPartition(p)->getIndices();
+                const mx::MeshIndexBuffer& indexedIndices = indexed->getPartition(p)->getIndices();
+                REQUIRE(explodedIndices.size() == indexedIndices.size());
+                for (size_t i = 0; i < explodedIndices.size(); i++)
+                {
+                    for (unsigned int k = 0; k < stride; k++)
+                    {
+                        REQUIRE(explodedStream->getData()[explodedIndices[i] * stride + k] ==
+                                indexedStream->getData()[indexedIndices[i] * stride + k]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Loaders without support for options are called through the load
+    // method without options.
+    CountingGeometryLoader countingLoader;
+    mx::GeometryLoader& loader = countingLoader;
+    mx::MeshList meshes;
+    mx::GeometryLoadOptions options;
+    options.indexedVertices = true;
+    REQUIRE(loader.load(mx::FilePath("unused.obj"), meshes, options));
+    REQUIRE(countingLoader.loadCount == 1);
+}
+
+TEST_CASE("Render: Parallel Geometry Load", "[rendercore]")
+{
+    // Write a file with polygons, relative indices, faces without normals
+    // or texture coordinates, and multiple groups.
+    mx::FilePath polygonPath("parallel_obj_test.obj");
+    {
+        std::ofstream stream(polygonPath.asString());
+        stream << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 0.5 1.5e0 -2.5E-1\n"
+                  "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+                  "vn 0 0 1\nvn 0 0 -1\n"
+                  "g first second\n"
+                  "f 1/1/1 2/2/1 3/3/1 5/4/1 4/4/1\n"
+                  "f -5//-1 -4//-1 -3//-1\n"
+                  "g\n"
+                  "f 1 3 4\n"
+                  "o object\r\n"
+                  "f 1/1 2/2 3/3 4/4\n";
+    }
+
+    mx::FilePath geomPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Geometry/");
+    mx::FilePathVec files = { polygonPath };
+    for (const mx::FilePath& file : geomPath.getFilesInDirectory("obj"))
+    {
+        files.push_back(geomPath / file);
+    }
+
+    // Compare the meshes of the parallel loader to those of TinyObjLoader.
+    mx::TinyObjLoaderPtr tinyLoader = mx::TinyObjLoader::create();
+    mx::ParallelObjLoaderPtr parallelLoader = mx::ParallelObjLoader::create();
+    parallelLoader->setThreadCount(4);
+    for (const mx::FilePath& file : files)
+    {
+        for (int indexed = 0; indexed < 2; indexed++)
+        {
+            mx::GeometryLoadOptions options;
+            options.indexedVertices = indexed != 0;
+            mx::MeshList tinyMeshes, parallelMeshes;
+            REQUIRE(tinyLoader->load(file, tinyMeshes, options));
+            REQUIRE(parallelLoader->load(file, parallelMeshes, options));
+            REQUIRE(tinyMeshes.size() == 1);
+            REQUIRE(parallelMeshes.size() == 1);
+            mx::MeshPtr tinyMesh = tinyMeshes[0];
+            mx::MeshPtr parallelMesh = parallelMeshes[0];
+
+            REQUIRE(parallelMesh->getVertexCount() == tinyMesh->getVertexCount());
+            REQUIRE(parallelMesh->getPartitionCount() == tinyMesh->getPartitionCount());
+            for (size_t p = 0; p < tinyMesh->getPartitionCount(); p++)
+            {
+                mx::MeshPartitionPtr tinyPart = tinyMesh->getPartition(p);
+                mx::MeshPartitionPtr parallelPart = parallelMesh->getPartition(p);
+                REQUIRE(parallelPart->getIdentifier() == tinyPart->getIdentifier());
+                REQUIRE(parallelPart->getFaceCount() == tinyPart->getFaceCount());
+                REQUIRE(parallelPart->getIndices() == tinyPart->getIndices());
+            }
+            for (const std::string& attribute : { mx::MeshStream::POSITION_ATTRIBUTE, mx::MeshStream::NORMAL_ATTRIBUTE,
+                                                  mx::MeshStream::TEXCOORD_ATTRIBUTE, mx::MeshStream::TANGENT_ATTRIBUTE })
+            {
+                const mx::MeshFloatBuffer& tinyData = tinyMesh->getStream(attribute, 0)->getData();
+                const mx::MeshFloatBuffer& parallelData = parallelMesh->getStream(attribute, 0)->getData();
+                REQUIRE(parallelData.size() == tinyData.size());
+                for (size_t i = 0; i < tinyData.size(); i++)
+                {
+                    REQUIRE(std::abs(parallelData[i] - tinyData[i]) <= 1e-5f * std::max(1.0f, std::abs(tinyData[i])));
+                }
+            }
+            REQUIRE(parallelMesh->getMinimumBounds() == tinyMesh->getMinimumBounds());
+            REQUIRE(parallelMesh->getMaximumBounds() == tinyMesh->getMaximumBounds());
+        }
+    }
+
+    // Face indices beyond the vertex data are rejected, including relative
+    // indices preceding the first element.
+    for (const char* face : { "f 1 2 4", "f 1//-2 2//-2 3//-2", "f 1/-1 2/-1 3/-1" })
+    {
+        {
+            std::ofstream stream(polygonPath.asString());
+            stream << "v 0 0 0\nv 1 0 0\nv 1 1 0\nvn 0 0 1\n" << face << "\n";
+        }
+        mx::MeshList meshes;
+        REQUIRE(!parallelLoader->load(polygonPath, meshes));
+        REQUIRE(meshes.empty());
+    }
+    std::remove(polygonPath.asString().c_str());
+}
+
+TEST_CASE("Render: OBJ Load Performance", "[.benchmark]")
+{
+    const int gridSize = 600;
+    const int groupCount = 6;
+
+    // Write a large grid of quads, split into several groups.
+    mx::FilePath gridPath("parallel_obj_benchmark.obj");
+    {
+        std::ofstream stream(gridPath.asString());
+        for (int y = 0; y <= gridSize; y++)
+        {
+            for (int x = 0; x <= gridSize; x++)
+            {
+                float u = (float) x / gridSize;
+                float v = (float) y / gridSize;
+                stream << "v " << u * 10.0f << " " << std::sin(u * 6.0f) * std::cos(v * 6.0f) << " " << v * 10.0f << "\n";
+                stream << "vt " << u << " " << v << "\n";
+                stream << "vn " << 0.0f << " " << 1.0f << " " << 0.0f << "\n";
+            }
+        }
+        for (int y = 0; y < gridSize; y++)
+        {
+            if (y % (gridSize / groupCount) == 0)
+            {
+                stream << "g group" << y << "\n";
+            }
+            for (int x = 0; x < gridSize; x++)
+            {
+                int i0 = y * (gridSize + 1) + x + 1;
+                int corners[] = { i0, i0 + 1, i0 + gridSize + 2, i0 + gridSize + 1 };
+                stream << "f";
+                for (int corner : corners)
+                {
+                    stream << " " << corner << "/" << corner << "/" << corner;
+                }
+                stream << "\n";
+            }
+        }
+    }
+
+    mx::TinyObjLoaderPtr tinyLoader = mx::TinyObjLoader::create();
+    mx::ParallelObjLoaderPtr parallelLoader = mx::ParallelObjLoader::create();
+    for (int indexed = 0; indexed < 2; indexed++)
+    {
+        mx::GeometryLoadOptions options;
+        options.indexedVertices = indexed != 0;
+
+        mx::MeshList tinyMeshes;
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE(tinyLoader->load(gridPath, tinyMeshes, options));
+        std::chrono::duration<double> tinyTime = std::chrono::steady_clock::now() - start;
+
+        mx::MeshList parallelMeshes;
+        start = std::chrono::steady_clock::now();
+        REQUIRE(parallelLoader->load(gridPath, parallelMeshes, options));
+        std::chrono::duration<double> parallelTime = std::chrono::steady_clock::now() - start;
+
+        REQUIRE(parallelMeshes[0]->getVertexCount() == tinyMeshes[0]->getVertexCount());
+        std::cout << "Grid of " << gridSize * gridSize << " quads" << (indexed ? " with indexed vertices" : "") <<
+                     ": TinyObjLoader " << tinyTime.count() << "s, ParallelObjLoader " <<
+                     parallelTime.count() << "s on " << std::thread::hardware_concurrency() << " threads" << std::endl;
+    }
+    std::remove(gridPath.asString().c_str());
+}
+
 struct ImageHandlerTestOptions
 {
     mx::ImageHandlerPtr imageHandler;
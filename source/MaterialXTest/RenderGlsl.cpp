@@ -4,6 +4,7 @@
 //
 
 #include <MaterialXGenGlsl/GlslShaderGenerator.h>
+#include <MaterialXRenderGlsl/GlslProgram.h>
 #include <MaterialXRenderGlsl/GlslValidator.h>
 #include <MaterialXRenderGlsl/GLTextureHandler.h>
 
@@ -27,6 +28,8 @@
 #endif
 #include <MaterialXTest/RenderUtil.h>
 
+#include <cstring>
+
 namespace mx = MaterialX;
 
 //
@@ -515,3 +518,76 @@ TEST_CASE("Render: GLSL TestSuite", "[renderglsl]")
 
     renderTester.validate(testRootPaths, optionsFilePath);
 }
+
+TEST_CASE("Render: GLSL Uniform Buffer Writes", "[renderglsl]")
+{
+    // Build a block with one variable of each placement class.
+    mx::VariableBlock block("PublicUniforms", "u_public");
+    block.add(mx::Type::FLOAT, "u_float", mx::Value::createValue(1.5f));
+    block.add(mx::Type::INTEGER, "u_int", mx::Value::createValue(7));
+    block.add(mx::Type::VECTOR3, "u_vec3", mx::Value::createValue(mx::Vector3(1.0f, 2.0f, 3.0f)));
+    mx::Matrix33 matrix(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f);
+    block.add(mx::Type::MATRIX33, "u_mat33", mx::Value::createValue(matrix));
+    std::vector<float> floats = { 10.0f, 20.0f, 30.0f };
+    block.add(mx::Type::FLOATARRAY, "u_floats", mx::Value::createValue(floats));
+    mx::GlslShaderGenerator::computeUniformBufferLayout(block);
+
+    // Offsets and strides follow the std140 rules, with the scalar float
+    // packed into the padding after the vec3.
+    REQUIRE(block.getBufferSize() == 128);
+    struct Expected
+    {
+        std::string name;
+        size_t offset;
+        size_t stride;
+    };
+    std::vector<Expected> expected = { { "u_floats", 0, 16 }, { "u_mat33", 48, 16 }, { "u_vec3", 96, 0 },
+                                       { "u_float", 108, 0 }, { "u_int", 112, 0 } };
+    REQUIRE(block.getBufferLayout().size() == expected.size());
+    for (const Expected& entry : expected)
+    {
+        const mx::VariableBlock::BufferEntry* bufferEntry = block.findBufferEntry(entry.name);
+        REQUIRE(bufferEntry);
+        REQUIRE(bufferEntry->offset == entry.offset);
+        REQUIRE(bufferEntry->stride == entry.stride);
+    }
+
+    // Write each value through its buffer entry, and read it back from the
+    // expected std140 locations.
+    std::vector<char> data(block.getBufferSize(), 0);
+    for (const mx::VariableBlock::BufferEntry& entry : block.getBufferLayout())
+    {
+        mx::GlslProgram::writeUniformBufferValue(data, entry.offset, entry.stride, *entry.variable->getValue());
+    }
+    auto readFloat = [&data](size_t offset)
+    {
+        float value;
+        std::memcpy(&value, &data[offset], sizeof(value));
+        return value;
+    };
+    for (size_t i = 0; i < floats.size(); i++)
+    {
+        REQUIRE(readFloat(i * 16) == floats[i]);
+        REQUIRE(readFloat(i * 16 + 4) == 0.0f);
+    }
+    for (size_t col = 0; col < 3; col++)
+    {
+        for (size_t row = 0; row < 3; row++)
+        {
+            REQUIRE(readFloat(48 + col * 16 + row * 4) == matrix[row][col]);
+        }
+    }
+    REQUIRE(readFloat(96) == 1.0f);
+    REQUIRE(readFloat(104) == 3.0f);
+    REQUIRE(readFloat(108) == 1.5f);
+    int intValue;
+    std::memcpy(&intValue, &data[112], sizeof(intValue));
+    REQUIRE(intValue == 7);
+
+    // Values extending beyond the end of the buffer are not written.
+    data.assign(8, 0);
+    mx::GlslProgram::writeUniformBufferValue(data, 4, 16, *mx::Value::createValue(floats));
+    REQUIRE(data.size() == 8);
+    REQUIRE(readFloat(0) == 0.0f);
+    REQUIRE(readFloat(4) == floats[0]);
+}
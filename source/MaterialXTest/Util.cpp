@@ -30,6 +30,47 @@ TEST_CASE("String utilities", "[util]")
     REQUIRE(mx::splitString("[one...two...three]", "[.]") == (std::vector<std::string>{"one", "two", "three"}));
 }
 
+TEST_CASE("Parallel utilities", "[util]")
+{
+    // Visit each index exactly once across multiple threads.
+    std::vector<int> visits(1000, 0);
+    mx::parallelFor(visits.size(), [&visits](size_t i) { visits[i]++; }, 4);
+    REQUIRE(std::count(visits.begin(), visits.end(), 1) == (long) visits.size());
+
+    // The exception with the lowest index is rethrown.
+    auto throwFromIndex = [](size_t i)
+    {
+        if (i >= 10)
+        {
+            throw mx::Exception("Index " + std::to_string(i));
+        }
+    };
+    try
+    {
+        mx::parallelFor(100, throwFromIndex, 4);
+        REQUIRE(false);
+    }
+    catch (mx::Exception& e)
+    {
+        REQUIRE(std::string(e.what()) == "Index 10");
+    }
+
+    // Names interned on other threads can be found while the pool grows.
+    mx::StringPool pool;
+    const std::string* first = pool.intern("name0");
+    std::vector<int> found(1000, 0);
+    mx::parallelFor(found.size(), [&pool, &found, first](size_t i)
+    {
+        const std::string name = "name" + std::to_string(i);
+        const std::string* interned = pool.intern(name);
+        found[i] = *interned == name && pool.find(name) == interned && pool.find("name0") == first;
+    }, 4);
+    REQUIRE(std::count(found.begin(), found.end(), 1) == (long) found.size());
+    REQUIRE(pool.size() == 1000);
+    REQUIRE(*pool.find("name999") == "name999");
+    REQUIRE(pool.find("name1000") == nullptr);
+}
+
 TEST_CASE("Print utilities", "[util]")
 {
     // Create a document.
@@ -9,6 +9,9 @@
 #include <MaterialXFormat/File.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <chrono>
+#include <iostream>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Load content", "[xmlio]")
@@ -173,6 +176,18 @@ TEST_CASE("Load content", "[xmlio]")
     mx::readFromXmlFile(flatDoc, filename, searchPath, &readOptions);
     REQUIRE(*flatDoc != *doc);
 
+    // Read document with parallel XIncludes, and verify that the result
+    // matches a serial read.
+    std::string lookFilename = "resources/Materials/Examples/StandardSurface/standard_surface_look_brass_tiled.mtlx";
+    mx::DocumentPtr serialDoc = mx::createDocument();
+    mx::readFromXmlFile(serialDoc, lookFilename, searchPath);
+    mx::DocumentPtr parallelDoc = mx::createDocument();
+    readOptions = mx::XmlReadOptions();
+    readOptions.parallelXIncludeEnable = true;
+    mx::readFromXmlFile(parallelDoc, lookFilename, searchPath, &readOptions);
+    REQUIRE(serialDoc->getChildren().size() > 2);
+    REQUIRE(*parallelDoc == *serialDoc);
+
     // Read document using environment search path.
     mx::setEnviron(mx::MATERIALX_SEARCH_PATH_ENV_VAR, searchPath);
     mx::DocumentPtr envDoc = mx::createDocument();
@@ -205,6 +220,37 @@ TEST_CASE("Load content", "[xmlio]")
     }
     REQUIRE(imageElementCount == 0);
 
+    // Read with the same predicate, and verify that the result matches the
+    // filtered document.
+    mx::DocumentPtr filteredDoc = mx::createDocument();
+    readOptions = mx::XmlReadOptions();
+    readOptions.elementPredicate = [](const mx::XmlElementInfo& info)
+    {
+        return info.getCategory() != "image";
+    };
+    mx::readFromXmlFile(filteredDoc, filename, searchPath, &readOptions);
+    REQUIRE(*filteredDoc == *writtenDoc);
+
+    // The predicate is not called for the children of excluded elements.
+    mx::StringSet testedNames;
+    readOptions.elementPredicate = [&testedNames](const mx::XmlElementInfo& info)
+    {
+        testedNames.insert(info.getName());
+        return info.getCategory() != mx::NodeGraph::CATEGORY;
+    };
+    mx::DocumentPtr graphlessDoc = mx::createDocument();
+    mx::readFromXmlString(graphlessDoc, mx::writeToXmlString(doc, &writeOptions), &readOptions);
+    REQUIRE(!doc->getNodeGraphs().empty());
+    REQUIRE(graphlessDoc->getNodeGraphs().empty());
+    for (mx::NodeGraphPtr graph : doc->getNodeGraphs())
+    {
+        REQUIRE(testedNames.count(graph->getName()));
+        for (mx::ElementPtr child : graph->getChildren())
+        {
+            REQUIRE(!testedNames.count(child->getName()));
+        }
+    }
+
     // Read a non-existent document.
     mx::DocumentPtr nonExistentDoc = mx::createDocument();
     REQUIRE_THROWS_AS(mx::readFromXmlFile(nonExistentDoc, "NonExistent.mtlx"), mx::ExceptionFileMissing&);
@@ -215,3 +261,42 @@ TEST_CASE("Load content", "[xmlio]")
         "resources/Materials/TestSuite/libraries/metal/brass_wire_mesh.mtlx", searchPath);
     REQUIRE(nullptr != parentDoc->getNodeDef("ND_TestMetal"));
 }
+
+TEST_CASE("Filtered load performance", "[.benchmark]")
+{
+    mx::FilePath testSuitePath("resources/Materials/TestSuite");
+    mx::FilePath libraryPath("libraries/stdlib");
+
+    // Scan the test suite for material names, with and without a predicate
+    // that excludes all other content.
+    mx::XmlReadOptions filterOptions;
+    filterOptions.elementPredicate = [](const mx::XmlElementInfo& info)
+    {
+        return info.getCategory() == mx::Material::CATEGORY;
+    };
+    for (bool filter : { false, true })
+    {
+        size_t materialCount = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const mx::FilePath& dir : testSuitePath.getSubDirectories())
+        {
+            for (const mx::FilePath& filename : dir.getFilesInDirectory(mx::MTLX_EXTENSION))
+            {
+                mx::DocumentPtr doc = mx::createDocument();
+                try
+                {
+                    mx::readFromXmlFile(doc, dir / filename, libraryPath.asString(), filter ? &filterOptions : nullptr);
+                }
+                catch (mx::Exception&)
+                {
+                    continue;
+                }
+                materialCount += doc->getMaterials().size();
+            }
+        }
+        std::chrono::duration<double> scanTime = std::chrono::steady_clock::now() - start;
+
+        std::cout << (filter ? "Filtered" : "Full") << " read: " <<
+                     materialCount << " materials, " << scanTime.count() << "s" << std::endl;
+    }
+}
@@ -107,7 +107,7 @@ void applyModifiers(mx::DocumentPtr doc, const DocumentModifiers& modifiers)
         {
             elem->setName(modifiers.remapElements.at(elem->getName()));
         }
-        mx::StringVec attrNames = elem->getAttributeNames();
+        mx::StringVec attrNames = elem->getAttributeNames().asStringVec();
         for (const std::string& attrName : attrNames)
         {
             if (modifiers.remapElements.count(elem->getAttribute(attrName)))
@@ -19,6 +19,11 @@ void bindPyDocument(py::module& mod)
         .def("copy", &mx::Document::copy)
         .def("importLibrary", &mx::Document::importLibrary, 
             py::arg("library"), py::arg("copyOptions") = (const mx::CopyOptions*) nullptr)
+        .def("referenceLibrary", &mx::Document::referenceLibrary)
+        .def("clearReferencedLibraries", &mx::Document::clearReferencedLibraries)
+        .def("beginBatchEdit", &mx::Document::beginBatchEdit,
+            py::arg("elem") = mx::ElementPtr())
+        .def("endBatchEdit", &mx::Document::endBatchEdit)
         .def("addNodeGraph", &mx::Document::addNodeGraph,
             py::arg("name") = mx::EMPTY_STRING)
         .def("getNodeGraph", &mx::Document::getNodeGraph)
@@ -51,6 +56,10 @@ void bindPyDocument(py::module& mod)
         .def("getCollection", &mx::Document::getCollection)
         .def("getCollections", &mx::Document::getCollections)
         .def("removeCollection", &mx::Document::removeCollection)
+        .def("getGeomBindingIndex", [](mx::Document& doc)
+            {
+                return std::const_pointer_cast<mx::GeomBindingIndex>(doc.getGeomBindingIndex());
+            })
         .def("addTypeDef", &mx::Document::addTypeDef,
             py::arg("name") = mx::EMPTY_STRING)
         .def("getTypeDef", &mx::Document::getTypeDef)
@@ -81,7 +81,10 @@ void bindPyElement(py::module& mod)
         .def("setAttribute", &mx::Element::setAttribute)
         .def("hasAttribute", &mx::Element::hasAttribute)
         .def("getAttribute", &mx::Element::getAttribute)
-        .def("getAttributeNames", &mx::Element::getAttributeNames)
+        .def("getAttributeNames", [](const mx::Element& elem)
+            {
+                return elem.getAttributeNames().asStringVec();
+            })
         .def("removeAttribute", &mx::Element::removeAttribute)
         .def("getSelf", static_cast<mx::ElementPtr (mx::Element::*)()>(&mx::Element::getSelf))
         .def("getParent", static_cast<mx::ElementPtr(mx::Element::*)()>(&mx::Element::getParent))
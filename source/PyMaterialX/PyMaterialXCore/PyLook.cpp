@@ -5,7 +5,7 @@
 
 #include <PyMaterialX/PyMaterialX.h>
 
-#include <MaterialXCore/Look.h>
+#include <MaterialXCore/Document.h>
 
 namespace py = pybind11;
 namespace mx = MaterialX;
@@ -70,4 +70,29 @@ void bindPyLook(py::module& mod)
         .def("setVisible", &mx::Visibility::setVisible)
         .def("getVisible", &mx::Visibility::getVisible)
         .def_readonly_static("CATEGORY", &mx::Visibility::CATEGORY);
+
+    py::class_<mx::GeomBindingTable>(mod, "GeomBindingTable")
+        .def("getGeomCount", &mx::GeomBindingTable::getGeomCount)
+        .def("getBindingCount", &mx::GeomBindingTable::getBindingCount)
+        .def("getBindingIndex", &mx::GeomBindingTable::getBindingIndex);
+
+    py::class_<mx::GeomBindingIndex, mx::GeomBindingIndexPtr>(mod, "GeomBindingIndex")
+        .def_static("create", [](mx::DocumentPtr doc)
+            {
+                return mx::GeomBindingIndex::create(doc);
+            })
+        .def("getBindings", [](mx::GeomBindingIndex& index, const std::string& geom)
+            {
+                return index.getBindings(geom);
+            })
+        .def("getMaterialAssigns", &mx::GeomBindingIndex::getMaterialAssigns)
+        .def("getPropertyAssigns", &mx::GeomBindingIndex::getPropertyAssigns)
+        .def("getPropertySetAssigns", &mx::GeomBindingIndex::getPropertySetAssigns)
+        .def("getVisibilities", &mx::GeomBindingIndex::getVisibilities)
+        .def("resolveBindings", [](mx::GeomBindingIndex& index, const mx::StringVec& geomPaths, mx::LookPtr look, unsigned int threadCount)
+            {
+                return index.resolveBindings(geomPaths, look, threadCount);
+            }, py::arg("geomPaths"), py::arg("look") = nullptr, py::arg("threadCount") = 0)
+        .def("getBinding", &mx::GeomBindingIndex::getBinding)
+        .def("getBindingCount", &mx::GeomBindingIndex::getBindingCount);
 }
@@ -0,0 +1,29 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXFormat/BinaryIo.h>
+#include <MaterialXCore/Document.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyBinaryIo(py::module& mod)
+{
+    mod.def("readFromBinaryFile", &mx::readFromBinaryFile,
+        py::arg("doc"), py::arg("filename"), py::arg("searchPath") = mx::EMPTY_STRING, py::arg("readOptions") = (mx::CopyOptions*) nullptr);
+    mod.def("readFromBinaryString", [](mx::DocumentPtr doc, py::bytes data, const mx::CopyOptions* readOptions)
+        {
+            std::string buffer = data;
+            mx::readFromBinaryBuffer(doc, buffer.data(), buffer.size(), readOptions);
+        },
+        py::arg("doc"), py::arg("data"), py::arg("readOptions") = (mx::CopyOptions*) nullptr);
+    mod.def("writeToBinaryFile", mx::writeToBinaryFile);
+    mod.def("writeToBinaryString", [](mx::DocumentPtr doc)
+        {
+            return py::bytes(mx::writeToBinaryString(doc));
+        });
+}
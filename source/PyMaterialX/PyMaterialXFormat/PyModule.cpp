@@ -8,6 +8,7 @@
 namespace py = pybind11;
 
 void bindPyXmlIo(py::module& mod);
+void bindPyBinaryIo(py::module& mod);
 void bindPyFile(py::module& mod);
 
 PYBIND11_MODULE(PyMaterialXFormat, mod)
@@ -15,5 +16,6 @@ PYBIND11_MODULE(PyMaterialXFormat, mod)
     mod.doc() = "Module containing Python bindings for the MaterialXFormat library";
 
     bindPyXmlIo(mod);
+    bindPyBinaryIo(mod);
     bindPyFile(mod);
 }
@@ -13,10 +13,18 @@ namespace mx = MaterialX;
 
 void bindPyXmlIo(py::module& mod)
 {
+    py::class_<mx::XmlElementInfo>(mod, "XmlElementInfo")
+        .def("getCategory", &mx::XmlElementInfo::getCategory)
+        .def("getName", &mx::XmlElementInfo::getName)
+        .def("hasAttribute", &mx::XmlElementInfo::hasAttribute)
+        .def("getAttribute", &mx::XmlElementInfo::getAttribute);
+
     py::class_<mx::XmlReadOptions, mx::CopyOptions>(mod, "XmlReadOptions")
         .def(py::init())
         .def_readwrite("readXIncludeFunction", &mx::XmlReadOptions::readXIncludeFunction)
-        .def_readwrite("parentXIncludes", &mx::XmlReadOptions::parentXIncludes);
+        .def_readwrite("parentXIncludes", &mx::XmlReadOptions::parentXIncludes)
+        .def_readwrite("parallelXIncludeEnable", &mx::XmlReadOptions::parallelXIncludeEnable)
+        .def_readwrite("elementPredicate", &mx::XmlReadOptions::elementPredicate);
 
     py::class_<mx::XmlWriteOptions>(mod, "XmlWriteOptions")
         .def(py::init())
@@ -15,10 +15,15 @@ void bindPyGenContext(py::module& mod)
 {
     py::class_<mx::GenContext, mx::GenContextPtr>(mod, "GenContext")
         .def(py::init<mx::ShaderGeneratorPtr>())
-        .def("getShaderGenerator", &mx::GenContext::getShaderGenerator)
+        .def("fork", &mx::GenContext::fork)
+        .def("getShaderGenerator", static_cast<mx::ShaderGenerator& (mx::GenContext::*)()>(&mx::GenContext::getShaderGenerator))
         .def("getOptions", static_cast<mx::GenOptions& (mx::GenContext::*)()>(&mx::GenContext::getOptions), py::return_value_policy::reference)
         .def("registerSourceCodeSearchPath", static_cast<void (mx::GenContext::*)(const std::string&)>(&mx::GenContext::registerSourceCodeSearchPath))
         .def("registerSourceCodeSearchPath", static_cast<void (mx::GenContext::*)(const mx::FilePath&)>(&mx::GenContext::registerSourceCodeSearchPath))
         .def("registerSourceCodeSearchPath", static_cast<void (mx::GenContext::*)(const mx::FileSearchPath&)>(&mx::GenContext::registerSourceCodeSearchPath))
-        .def("resolveSourceFile", &mx::GenContext::resolveSourceFile);
+        .def("resolveSourceFile", &mx::GenContext::resolveSourceFile)
+        .def("setSourceCache", &mx::GenContext::setSourceCache)
+        .def("getSourceCache", &mx::GenContext::getSourceCache)
+        .def("setProfiler", &mx::GenContext::setProfiler)
+        .def("getProfiler", &mx::GenContext::getProfiler);
 }
@@ -30,5 +30,7 @@ void bindPyGenOptions(py::module& mod)
         .def_readwrite("hwTransparency", &mx::GenOptions::hwTransparency)
         .def_readwrite("hwSpecularEnvironmentMethod", &mx::GenOptions::hwSpecularEnvironmentMethod)
         .def_readwrite("hwMaxActiveLightSources", &mx::GenOptions::hwMaxActiveLightSources)
+        .def_readwrite("hwUniformBuffers", &mx::GenOptions::hwUniformBuffers)
+        .def_readwrite("optimizeGraphExpressions", &mx::GenOptions::optimizeGraphExpressions)
         .def(py::init<>());
 }
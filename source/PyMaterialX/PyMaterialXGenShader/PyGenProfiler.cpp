@@ -0,0 +1,29 @@
+//
+// TM & (c) 2019 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXGenShader/GenProfiler.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyGenProfiler(py::module& mod)
+{
+    py::class_<mx::GenProfiler::Scope>(mod, "GenProfilerScope")
+        .def_readonly("name", &mx::GenProfiler::Scope::name)
+        .def_readonly("parent", &mx::GenProfiler::Scope::parent)
+        .def_readonly("thread", &mx::GenProfiler::Scope::thread)
+        .def_readonly("start", &mx::GenProfiler::Scope::start)
+        .def_readonly("duration", &mx::GenProfiler::Scope::duration);
+
+    py::class_<mx::GenProfiler, mx::GenProfilerPtr>(mod, "GenProfiler")
+        .def_static("create", &mx::GenProfiler::create)
+        .def("getScopes", &mx::GenProfiler::getScopes)
+        .def("getCounters", &mx::GenProfiler::getCounters)
+        .def("exportJson", &mx::GenProfiler::exportJson)
+        .def("exportChromeTrace", &mx::GenProfiler::exportChromeTrace)
+        .def("clear", &mx::GenProfiler::clear);
+}
@@ -10,8 +10,12 @@ namespace py = pybind11;
 void bindPyColorManagement(py::module& mod);
 void bindPyShaderPort(py::module& mod);
 void bindPyShader(py::module& mod);
+void bindPyShaderCache(py::module& mod);
+void bindPyShaderVariants(py::module& mod);
+void bindPySourceCache(py::module& mod);
 void bindPyShaderGenerator(py::module& mod);
 void bindPyGenContext(py::module& mod);
+void bindPyGenProfiler(py::module& mod);
 void bindPyHwShaderGenerator(py::module& mod);
 void bindPyGenOptions(py::module& mod);
 void bindPyShaderStage(py::module& mod);
@@ -24,10 +28,14 @@ PYBIND11_MODULE(PyMaterialXGenShader, mod)
     bindPyColorManagement(mod);
     bindPyShaderPort(mod);
     bindPyShader(mod);
+    bindPyShaderCache(mod);
+    bindPySourceCache(mod);
     bindPyShaderGenerator(mod);
+    bindPyGenProfiler(mod);
     bindPyGenContext(mod);
     bindPyHwShaderGenerator(mod);
     bindPyGenOptions(mod);
+    bindPyShaderVariants(mod);
     bindPyShaderStage(mod);
     bindPyUtil(mod);
 }
@@ -0,0 +1,26 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/ShaderCache.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyShaderCache(py::module& mod)
+{
+    py::class_<mx::ShaderCache, mx::ShaderCachePtr>(mod, "ShaderCache")
+        .def_static("create", &mx::ShaderCache::create)
+        .def("setCacheDirectory", &mx::ShaderCache::setCacheDirectory)
+        .def("getCacheDirectory", &mx::ShaderCache::getCacheDirectory)
+        .def("computeHash", &mx::ShaderCache::computeHash)
+        .def("generate", &mx::ShaderCache::generate)
+        .def("getSourceCode", &mx::ShaderCache::getSourceCode)
+        .def("clear", &mx::ShaderCache::clear)
+        .def("getShaderCount", &mx::ShaderCache::getShaderCount)
+        .def("getGeneratedCount", &mx::ShaderCache::getGeneratedCount);
+}
@@ -340,7 +340,10 @@ void bindPyShaderGenerator(py::module& mod)
     py::class_<mx::ShaderGenerator, PyShaderGenerator, mx::ShaderGeneratorPtr>(mod, "ShaderGenerator")
         .def("getLanguage", &mx::ShaderGenerator::getLanguage)
         .def("getTarget", &mx::ShaderGenerator::getTarget)
+        .def("getVersion", &mx::ShaderGenerator::getVersion)
         .def("generate", &mx::ShaderGenerator::generate)
+        .def("generateAll", &mx::ShaderGenerator::generateAll,
+            py::arg("elements"), py::arg("context"), py::arg("threadCount") = 0)
         .def("setColorManagementSystem", &mx::ShaderGenerator::setColorManagementSystem)
         .def("getColorManagementSystem", &mx::ShaderGenerator::getColorManagementSystem);
 }
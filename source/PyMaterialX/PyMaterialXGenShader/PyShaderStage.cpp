@@ -16,6 +16,11 @@ void bindPyShaderStage(py::module& mod)
 
     py::class_<mx::ShaderPortPredicate>(mod, "ShaderPortPredicate");
 
+    py::class_<mx::VariableBlock::BufferEntry>(mod, "BufferEntry")
+        .def_readonly("variable", &mx::VariableBlock::BufferEntry::variable)
+        .def_readonly("offset", &mx::VariableBlock::BufferEntry::offset)
+        .def_readonly("stride", &mx::VariableBlock::BufferEntry::stride);
+
     py::class_<mx::VariableBlock, mx::VariableBlockPtr>(mod, "VariableBlock")
         .def(py::init<const std::string&, const std::string&>())
         .def("getName", &mx::VariableBlock::getName)
@@ -24,6 +29,9 @@ void bindPyShaderStage(py::module& mod)
         .def("size", &mx::VariableBlock::size)
         .def("find", static_cast<mx::ShaderPort* (mx::VariableBlock::*)(const std::string&)>(&mx::VariableBlock::find))
         .def("find", (mx::ShaderPort* (mx::VariableBlock::*)(const mx::ShaderPortPredicate& )) &mx::VariableBlock::find)
+        .def("hasBufferLayout", &mx::VariableBlock::hasBufferLayout)
+        .def("getBufferLayout", &mx::VariableBlock::getBufferLayout)
+        .def("getBufferSize", &mx::VariableBlock::getBufferSize)
         .def("__len__", &mx::VariableBlock::size)
         .def("__getitem__", [](const mx::VariableBlock &vb, size_t i)
         {
@@ -0,0 +1,29 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXGenShader/ShaderVariants.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyShaderVariants(py::module& mod)
+{
+    py::class_<mx::ShaderPermutation>(mod, "ShaderPermutation")
+        .def(py::init<>())
+        .def_readwrite("options", &mx::ShaderPermutation::options);
+
+    py::class_<mx::ShaderVariants>(mod, "ShaderVariants")
+        .def(py::init<>())
+        .def("generate", &mx::ShaderVariants::generate)
+        .def("size", &mx::ShaderVariants::size)
+        .def("getShader", &mx::ShaderVariants::getShader)
+        .def("getSourceCode", &mx::ShaderVariants::getSourceCode)
+        .def("getSourceIndex", &mx::ShaderVariants::getSourceIndex)
+        .def("getSources", &mx::ShaderVariants::getSources)
+        .def("getGraphCount", &mx::ShaderVariants::getGraphCount)
+        .def("__len__", &mx::ShaderVariants::size);
+}
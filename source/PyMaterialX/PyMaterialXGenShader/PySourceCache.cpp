@@ -0,0 +1,21 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXGenShader/SourceCache.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPySourceCache(py::module& mod)
+{
+    py::class_<mx::SourceCache, mx::SourceCachePtr>(mod, "SourceCache")
+        .def_static("create", &mx::SourceCache::create)
+        .def_static("getGlobal", &mx::SourceCache::getGlobal)
+        .def("resolve", &mx::SourceCache::resolve)
+        .def("clear", &mx::SourceCache::clear)
+        .def("getReadCount", &mx::SourceCache::getReadCount);
+}
@@ -32,10 +32,15 @@ class PyGeometryLoader : public mx::GeometryLoader
 
 void bindPyGeometryHandler(py::module& mod)
 {
+    py::class_<mx::GeometryLoadOptions>(mod, "GeometryLoadOptions")
+        .def(py::init())
+        .def_readwrite("indexedVertices", &mx::GeometryLoadOptions::indexedVertices);
+
     py::class_<mx::GeometryLoader, PyGeometryLoader, mx::GeometryLoaderPtr>(mod, "GeometryLoader")
         .def(py::init<>())
         .def("supportedExtensions", &mx::GeometryLoader::supportedExtensions)
-        .def("load", &mx::GeometryLoader::load);
+        .def("load", static_cast<bool (mx::GeometryLoader::*)(const mx::FilePath&, mx::MeshList&)>(&mx::GeometryLoader::load))
+        .def("load", static_cast<bool (mx::GeometryLoader::*)(const mx::FilePath&, mx::MeshList&, const mx::GeometryLoadOptions&)>(&mx::GeometryLoader::load));
 
     py::class_<mx::GeometryHandler, mx::GeometryHandlerPtr>(mod, "GeometryHandler")
         .def(py::init<>())
@@ -44,7 +49,8 @@ void bindPyGeometryHandler(py::module& mod)
         .def("clearGeometry", &mx::GeometryHandler::clearGeometry)
         .def("hasGeometry", &mx::GeometryHandler::hasGeometry)
         .def("getGeometry", &mx::GeometryHandler::getGeometry)
-        .def("loadGeometry", &mx::GeometryHandler::loadGeometry)
+        .def("loadGeometry", &mx::GeometryHandler::loadGeometry,
+            py::arg("filePath"), py::arg("options") = mx::GeometryLoadOptions())
         .def("getMeshes", &mx::GeometryHandler::getMeshes)
         .def("getMinimumBounds", &mx::GeometryHandler::getMinimumBounds)
         .def("getMaximumBounds", &mx::GeometryHandler::getMaximumBounds);
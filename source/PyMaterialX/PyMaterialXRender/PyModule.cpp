@@ -16,6 +16,7 @@ void bindPyStbImageLoader(py::module& mod);
 void bindPyOiioImageLoader(py::module& mod);
 #endif
 void bindPyTinyObjLoader(py::module& mod);
+void bindPyParallelObjLoader(py::module& mod);
 void bindPyViewHandler(py::module& mod);
 void bindPyExceptionShaderValidationError(py::module& mod);
 void bindPyShaderValidator(py::module& mod);
@@ -33,6 +34,7 @@ PYBIND11_MODULE(PyMaterialXRender, mod)
     bindPyOiioImageLoader(mod);
 #endif
     bindPyTinyObjLoader(mod);
+    bindPyParallelObjLoader(mod);
     bindPyViewHandler(mod);
     bindPyExceptionShaderValidationError(mod);
     bindPyShaderValidator(mod);
@@ -0,0 +1,20 @@
+//
+// TM & (c) 2019 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXRender/ParallelObjLoader.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyParallelObjLoader(py::module& mod)
+{
+    py::class_<mx::ParallelObjLoader, mx::ParallelObjLoaderPtr, mx::GeometryLoader>(mod, "ParallelObjLoader")
+        .def_static("create", &mx::ParallelObjLoader::create)
+        .def(py::init<>())
+        .def("setThreadCount", &mx::ParallelObjLoader::setThreadCount)
+        .def("getThreadCount", &mx::ParallelObjLoader::getThreadCount);
+}
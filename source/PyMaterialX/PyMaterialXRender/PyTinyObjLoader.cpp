@@ -14,6 +14,5 @@ void bindPyTinyObjLoader(py::module& mod)
 {
     py::class_<mx::TinyObjLoader, mx::TinyObjLoaderPtr, mx::GeometryLoader>(mod, "TinyObjLoader")
         .def_static("create", &mx::TinyObjLoader::create)
-        .def(py::init<>())
-        .def("load", &mx::TinyObjLoader::load);
+        .def(py::init<>());
 }
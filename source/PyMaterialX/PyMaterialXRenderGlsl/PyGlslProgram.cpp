@@ -28,7 +28,9 @@ void bindPyGlslProgram(py::module& mod)
         .def("bindInputs", &mx::GlslProgram::bindInputs)
         .def("unbindInputs", &mx::GlslProgram::unbindInputs)
         .def("haveActiveAttributes", &mx::GlslProgram::haveActiveAttributes)
-        .def("bindUniform", &mx::GlslProgram::bindUniform)
+        .def("bindUniform", static_cast<void (mx::GlslProgram::*)(int, const mx::Value&)>(&mx::GlslProgram::bindUniform))
+        .def("setUniformValue", &mx::GlslProgram::setUniformValue)
+        .def("bindUniformBuffers", &mx::GlslProgram::bindUniformBuffers)
         .def("bindAttribute", &mx::GlslProgram::bindAttribute)
         .def("bindPartition", &mx::GlslProgram::bindPartition)
         .def("bindStreams", &mx::GlslProgram::bindStreams)
@@ -48,6 +50,9 @@ void bindPyGlslProgram(py::module& mod)
         .def_readwrite("typeString", &mx::GlslProgram::Input::typeString)
         .def_readwrite("value", &mx::GlslProgram::Input::value)
         .def_readwrite("isConstant", &mx::GlslProgram::Input::isConstant)
+        .def_readwrite("bufferIndex", &mx::GlslProgram::Input::bufferIndex)
+        .def_readwrite("bufferOffset", &mx::GlslProgram::Input::bufferOffset)
+        .def_readwrite("bufferStride", &mx::GlslProgram::Input::bufferStride)
         .def_readwrite("path", &mx::GlslProgram::Input::path)
         .def(py::init<int, int, int, std::string>());
 }